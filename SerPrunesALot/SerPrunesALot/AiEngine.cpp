@@ -0,0 +1,59 @@
+#include "AiEngine.h"
+#include "SearchCore.h"
+#include "SearchHandle.h"
+
+AiEngine::AiEngine()
+	: searchLimits(),
+	searchControl(),
+	iterationCallback()
+{}
+
+SearchHandle* AiEngine::start(const GameState& position, const SearchLimits& limits, IterationCallback onIteration)
+{
+	searchControl.reset();
+	return new SearchHandle(this, position, limits, onIteration);
+}
+
+bool AiEngine::isWinEvaluation(int evaluation)
+{
+	return SearchCore::isWinScore(evaluation, getWinEvaluation());
+}
+
+void AiEngine::stop()
+{
+	searchControl.stop();
+}
+
+void AiEngine::reportIteration(int depth, int score, const Move& bestMove, int64_t nodes, double elapsedMs,
+							   const std::vector<Move>& principalVariation)
+{
+	if(!iterationCallback)
+	{
+		return;
+	}
+
+	SearchIterationInfo info;
+	info.depth = depth;
+	info.score = score;
+	info.bestMove = bestMove;
+	info.principalVariation = principalVariation;
+	info.nodes = nodes;
+	info.elapsedMs = elapsedMs;
+	info.nodesPerSecond = (elapsedMs > 0.0) ? (nodes * 1000.0 / elapsedMs) : 0.0;
+
+	iterationCallback(info);
+}
+
+Move AiEngine::runSearch(GameState& gameState, const SearchLimits& limits, IterationCallback onIteration)
+{
+	searchLimits = limits;
+	iterationCallback = onIteration;
+
+	Move move = chooseMove(gameState);
+
+	searchLimits = SearchLimits();
+	iterationCallback = IterationCallback();
+	searchControl.reset();
+
+	return move;
+}
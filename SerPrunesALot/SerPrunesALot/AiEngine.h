@@ -5,13 +5,19 @@
 #include "GameState.h"
 #include "Move.h"
 #include "MoveGenerator.h"
+#include "SearchControl.h"
+#include "SearchLimits.h"
+
+class SearchHandle;
 
 /**
- * Interface to an AI Engine class. 
+ * Interface to an AI Engine class.
  */
 class AiEngine
 {
 public:
+	AiEngine();
+
 	/**
 	 * Virtual method to choose a move given the current Game State.
 	 * Contains no default implementation. MUST be implemented by subclasses!
@@ -32,7 +38,13 @@ public:
 	 */
 	virtual int getWinEvaluation() = 0;
 
-	/** 
+	/**
+	 * Returns true iff the given evaluation (as returned by getRootEvaluation()) proves a win (if positive)
+	 * or a loss (if negative). Wins are scored lower as they are further away from the root.
+	 */
+	bool isWinEvaluation(int evaluation);
+
+	/**
 	 * Virtual method that should be implemented to return the evaluation of the
 	 * root node during the last time the engine was asked to choose a move.
 	 */
@@ -41,5 +53,57 @@ public:
 	/** Logs statistics gathered by the AI engine at the end of the match */
 	virtual void logEndOfMatchStats() = 0;
 
+	/**
+	 * Starts searching for a move in the given position on a separate worker thread, and returns immediately.
+	 *
+	 * The position is copied, so the caller is free to modify or destroy its own game state while the search runs.
+	 * The given callback (if any) is called on the worker thread every time the engine completes an iteration.
+	 *
+	 * The returned handle can be used to stop the search early and to wait for the result. It must be deleted
+	 * by the caller, and must be deleted before this engine is deleted. The engine can only run one search at a time.
+	 */
+	SearchHandle* start(const GameState& position, const SearchLimits& limits, IterationCallback onIteration = IterationCallback());
+
+	/**
+	 * Requests the currently running search (if any) to stop as soon as possible.
+	 * The engine will still return the best move it found so far.
+	 */
+	void stop();
+
 	virtual ~AiEngine(){}
-};
\ No newline at end of file
+
+protected:
+	/** The limits imposed on the current search. Contains only 0s (no limits) if the search was started through chooseMove() directly */
+	SearchLimits searchLimits;
+
+	/**
+	 * Decides when the current search must be terminated. Engines should call searchControl.startSearch() when starting
+	 * a search, call searchControl.visitNode() in every node, and unwind as soon as either of them reports that the search was stopped
+	 */
+	SearchControl searchControl;
+
+	/**
+	 * Reports a completed iteration to the progress callback of the current search, if there is one.
+	 * Engines that do not search iteratively should call this once, after completing their search.
+	 * Engines that keep track of the principal variation can pass it along as well.
+	 */
+	void reportIteration(int depth, int score, const Move& bestMove, int64_t nodes, double elapsedMs,
+						 const std::vector<Move>& principalVariation = std::vector<Move>());
+
+private:
+	friend class SearchHandle;
+
+	/** Callback to report completed iterations to */
+	IterationCallback iterationCallback;
+
+	/**
+	 * Runs a search with the given limits and callback. Called by SearchHandle on its worker thread.
+	 * Resets the limits, callback and stop flag again when the search is done, so that later direct calls of
+	 * chooseMove() are not affected by them
+	 */
+	Move runSearch(GameState& gameState, const SearchLimits& limits, IterationCallback onIteration);
+
+	// don't want accidental copying of engines
+	AiEngine(const AiEngine&);
+	AiEngine& operator=(const AiEngine&);
+};
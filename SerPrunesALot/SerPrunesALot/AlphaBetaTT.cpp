@@ -4,11 +4,13 @@
 #include "Logger.h"
 #include "MathConstants.h"
 #include "MoveOrdering.h"
+#include "SearchCore.h"
 #include "Timer.hpp"
 
 /**
 * The evaluation corresponding to a won game.
 * Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+* Wins are scored as this value minus their distance in plies from the root (see SearchCore::getWinScore())
 */
 #define WIN_EVALUATION 2000
 
@@ -24,11 +26,13 @@ Move AlphaBetaTT::chooseMove(GameState& gameState)
 {
 	transpositionTable.clear();	// clean up data from previous searches
 
+	// callers of start() may override the search depth
+	int depth = (searchLimits.maxDepth > 0) ? searchLimits.maxDepth : SEARCH_DEPTH;
+
 #ifdef GATHER_STATISTICS
-	nodesVisited = 0;
 	Timer timer;
 	timer.start();
-	Move moveToPlay = startAlphaBetaTT(gameState, SEARCH_DEPTH);
+	Move moveToPlay = startAlphaBetaTT(gameState, depth);
 	timer.stop();
 
 #ifdef LOG_STATS_PER_TURN
@@ -41,29 +45,35 @@ Move AlphaBetaTT::chooseMove(GameState& gameState)
 		LOG_MESSAGE(StringBuilder() << "Alpha Beta with TT engine searching move for White Player")
 	}
 
-	LOG_MESSAGE(StringBuilder() << "Search depth:					" << SEARCH_DEPTH)
-	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << nodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Search depth:					" << depth)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
 	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
 	LOG_MESSAGE("")
 #endif // LOG_STATS_PER_TURN
 
 #ifdef LOG_STATS_END_OF_MATCH
-	totalNodesVisited += nodesVisited;
+	totalNodesVisited += searchControl.getNodesVisited();
 	totalTimeSpent += timer.getElapsedTimeInMilliSec();
 	++turnsPlayed;
 #endif // LOG_STATS_END_OF_MATCH
 
 	return moveToPlay;
 #else
-	return startAlphaBetaTT(gameState, SEARCH_DEPTH);
+	return startAlphaBetaTT(gameState, depth);
 #endif // GATHER_STATISTICS
 }
 
-int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int alpha, int beta)
+int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int ply, int alpha, int beta)
 {
-#ifdef GATHER_STATISTICS
-	++nodesVisited;
-#endif // GATHER_STATISTICS
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+	if (SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
 
 	int originalAlpha = alpha;
 	uint64_t zobrist = gameState.getZobrist();
@@ -79,26 +89,29 @@ int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int alpha, int bet
 	}
 #endif
 
+	// wins are stored relative to the node, so convert back to a score relative to the root
+	int tableValue = (tableDataValid) ? SearchCore::scoreFromTable(tableData.value, ply, WIN_EVALUATION) : 0;
+
 	if (tableDataValid)
 	{
 		if (tableData.depth >= depth)	// ensure table stored in data resulted from a deep enough search
 		{
 			if (tableData.valueType == EValue::Type::REAL)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 			else if (tableData.valueType == EValue::Type::LOWER_BOUND)
 			{
-				alpha = std::max(alpha, tableData.value);
+				alpha = std::max(alpha, tableValue);
 			}
 			else if (tableData.valueType == EValue::Type::UPPER_BOUND)
 			{
-				beta = std::min(beta, tableData.value);
+				beta = std::min(beta, tableValue);
 			}
 
 			if (alpha >= beta)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 		}
 	}
@@ -108,7 +121,7 @@ int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int alpha, int bet
 	// stop search if we reached max depth or have found a winner
 	if (depth == 0 || winner != EPlayerColors::Type::NOTHING)
 	{
-		return evaluate(gameState, winner);
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
 	}
 
 	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
@@ -125,9 +138,14 @@ int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int alpha, int bet
 	while (!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBetaTT(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBetaTT(gameState, depth - 1, ply + 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
 		if (value > score)		// new best move found
 		{
 			score = value;
@@ -148,15 +166,15 @@ int AlphaBetaTT::alphaBetaTT(GameState& gameState, int depth, int alpha, int bet
 	// Store data in Transposition Table
 	if (score <= originalAlpha)		// found upper bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::UPPER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::UPPER_BOUND, depth);
 	}
 	else if (score >= beta)			// found lower bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::LOWER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
 	}
 	else							// found exact value
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::REAL, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::REAL, depth);
 	}
 
 	return score;
@@ -187,65 +205,7 @@ int AlphaBetaTT::evaluate(const GameState& gameState, EPlayerColors::Type winner
 	int materialDifference = 100 * (gameState.getNumWhiteKnights() - gameState.getNumBlackKnights());
 
 	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
-	int progression = 0;
-
-	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
-	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
-
-	int blackProgression = 0;
-	int whiteProgression = 0;
-
-	if(blackBitboard & Bitboards::ROW_2)
-	{
-		blackProgression = 6;
-	}
-	else if(blackBitboard & Bitboards::ROW_3)
-	{
-		blackProgression = 5;
-	}
-	else if(blackBitboard & Bitboards::ROW_4)
-	{
-		blackProgression = 4;
-	}
-	else if(blackBitboard & Bitboards::ROW_5)
-	{
-		blackProgression = 3;
-	}
-	else if(blackBitboard & Bitboards::ROW_6)
-	{
-		blackProgression = 2;
-	}
-	else if(blackBitboard & Bitboards::ROW_7)
-	{
-		blackProgression = 1;
-	}
-
-	if(whiteBitboard & Bitboards::ROW_7)
-	{
-		whiteProgression = 6;
-	}
-	else if(whiteBitboard & Bitboards::ROW_6)
-	{
-		whiteProgression = 5;
-	}
-	else if(whiteBitboard & Bitboards::ROW_5)
-	{
-		whiteProgression = 4;
-	}
-	else if(whiteBitboard & Bitboards::ROW_4)
-	{
-		whiteProgression = 3;
-	}
-	else if(whiteBitboard & Bitboards::ROW_3)
-	{
-		whiteProgression = 2;
-	}
-	else if(whiteBitboard & Bitboards::ROW_2)
-	{
-		whiteProgression = 1;
-	}
-
-	progression = 35 * (whiteProgression - blackProgression);
+	int progression = 35 * (gameState.getProgression(EPlayerColors::Type::WHITE_PLAYER) - gameState.getProgression(EPlayerColors::Type::BLACK_PLAYER));
 
 	// compute final score
 	int score = materialDifference + progression;
@@ -261,6 +221,8 @@ int AlphaBetaTT::evaluate(const GameState& gameState, EPlayerColors::Type winner
 
 Move AlphaBetaTT::startAlphaBetaTT(GameState& gameState, int depth)
 {
+	searchControl.startSearch(0, searchLimits.maxTimeMs, searchLimits.maxNodes);
+
 	int score = MathConstants::LOW_ENOUGH_INT;
 	int alpha = MathConstants::LOW_ENOUGH_INT;
 	int beta = MathConstants::LARGE_ENOUGH_INT;
@@ -284,9 +246,14 @@ Move AlphaBetaTT::startAlphaBetaTT(GameState& gameState, int depth)
 	while(!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBetaTT(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBetaTT(gameState, depth - 1, 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
+		if(searchControl.isStopped())		// search terminated, so keep the best move among the moves that were searched completely
+		{
+			break;
+		}
+
 		if (value > score)		// new best move found
 		{
 			score = value;
@@ -304,7 +271,15 @@ Move AlphaBetaTT::startAlphaBetaTT(GameState& gameState, int depth)
 		m = moveGenerator.nextMove();
 	}
 
-	lastRootEvaluation = score;
+	if(score != MathConstants::LOW_ENOUGH_INT)		// completed search of at least one move
+	{
+		lastRootEvaluation = score;
+	}
+
+	if(!searchControl.isStopped())
+	{
+		reportIteration(depth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+	}
 
 	return bestMove;
 }
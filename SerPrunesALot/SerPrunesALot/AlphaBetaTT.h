@@ -28,16 +28,15 @@ private:
 	int lastRootEvaluation;
 
 	// variables used for gathering and logging statistics
-	int nodesVisited;
 	int64_t totalNodesVisited;
 	double totalTimeSpent;
 	int turnsPlayed;
 
 	/**
-	* Continues alpha-beta search, given the game state, maximum search depth, and current alpha and beta values.
+	* Continues alpha-beta search, given the game state, maximum search depth, distance from the root, and current alpha and beta values.
 	* Returns the node's evaluation.
 	*/
-	int alphaBetaTT(GameState& gameState, int depth, int alpha, int beta);
+	int alphaBetaTT(GameState& gameState, int depth, int ply, int alpha, int beta);
 
 	/**
 	* Returns an evaluation of the given game state.
@@ -6,18 +6,66 @@
 #include "Logger.h"
 #include "MathConstants.h"
 #include "MoveOrdering.h"
+#include "RaceDetector.h"
+#include "SearchCore.h"
 
 /**
 * The evaluation corresponding to a won game.
 * Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+* Wins are scored as this value minus their distance in plies from the root (see SearchCore::getWinScore())
 */
 #define WIN_EVALUATION 1900
 
+/** The search is handed off to the DFPN solver if at most this many knights (of both players together) are left */
+#define DFPN_HANDOFF_MAX_KNIGHTS 24
+/** The maximum number of nodes that the DFPN solver may visit before falling back to the normal search */
+#define DFPN_HANDOFF_MAX_NODES 200000
+
+#ifdef USE_PIECE_SQUARE_EVALUATION
+namespace
+{
+	/**
+	 * Piece-square values of both players for the evaluation function, indexed by [player - 1][location]. Values grow faster
+	 * the closer a knight gets to its goal row, and knights on the outer files, which have fewer moves, are worth a bit less.
+	 * A knight on its goal row has won already, so those squares are never evaluated
+	 */
+	const int PIECE_SQUARE_VALUES[NUM_PLAYERS][BOARD_WIDTH * BOARD_HEIGHT] = {
+		{	// black, moving down from the top row
+			-3, -1,  0,  0,  0,  0, -1, -3,
+			 0,  2,  3,  3,  3,  3,  2,  0,
+			 3,  5,  6,  6,  6,  6,  5,  3,
+			 7,  9, 10, 10, 10, 10,  9,  7,
+			12, 14, 15, 15, 15, 15, 14, 12,
+			19, 21, 22, 22, 22, 22, 21, 19,
+			29, 31, 32, 32, 32, 32, 31, 29,
+			 0,  0,  0,  0,  0,  0,  0,  0
+		},
+		{	// white, moving up from the bottom row
+			 0,  0,  0,  0,  0,  0,  0,  0,
+			29, 31, 32, 32, 32, 32, 31, 29,
+			19, 21, 22, 22, 22, 22, 21, 19,
+			12, 14, 15, 15, 15, 15, 14, 12,
+			 7,  9, 10, 10, 10, 10,  9,  7,
+			 3,  5,  6,  6,  6,  6,  5,  3,
+			 0,  2,  3,  3,  3,  3,  2,  0,
+			-3, -1,  0,  0,  0,  0, -1, -3
+		}
+	};
+}
+#endif // USE_PIECE_SQUARE_EVALUATION
+
 AspirationSearch::AspirationSearch()
 	: transpositionTable(),
+	dfpnSolver(),
+	openingBook(),
+#ifdef USE_PIECE_SQUARE_EVALUATION
+	blackPieceSquarePlanes(PIECE_SQUARE_VALUES[0]),
+	whitePieceSquarePlanes(PIECE_SQUARE_VALUES[1]),
+#endif // USE_PIECE_SQUARE_EVALUATION
 	killerMoves(),
 	clock(),
 	lastRootEvaluation(0),
+	timeManager(MIN_SEARCH_TIME_MS, MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS),
 	totalNodesVisited(0),
 	totalTimeSpent(0.0),
 	turnsPlayed(0),
@@ -27,10 +75,22 @@ AspirationSearch::AspirationSearch()
 
 Move AspirationSearch::chooseMove(GameState& gameState)
 {
+#ifdef USE_OPENING_BOOK
+	// checked before anything else, because even clearing the Transposition Table takes much longer than probing the book
+	Move bookMove = INVALID_MOVE;
+	clock.start();
+	if(openingBook.probe(gameState, bookMove, lastRootEvaluation))
+	{
+		clock.stop();
+		searchDepth = 0;
+		reportIteration(searchDepth, lastRootEvaluation, bookMove, 0, clock.getElapsedTimeInMilliSec());
+		return bookMove;
+	}
+#endif // USE_OPENING_BOOK
+
 	transpositionTable.clear();	// clean up data from previous searches
 
 #ifdef GATHER_STATISTICS
-	nodesVisited = 0;
 	Timer timer;
 	timer.start();
 	Move moveToPlay = startAspirationSearch(gameState);
@@ -47,7 +107,7 @@ Move AspirationSearch::chooseMove(GameState& gameState)
 	}
 
 	LOG_MESSAGE(StringBuilder() << "Search depth:					" << searchDepth)
-	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << nodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
 	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
 	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries used:		" << ((double)transpositionTable.getNumEntriesUsed() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
 	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries replaced:	" << ((double)transpositionTable.getNumReplacementsRequired() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
@@ -55,7 +115,7 @@ Move AspirationSearch::chooseMove(GameState& gameState)
 #endif // LOG_STATS_PER_TURN
 
 #ifdef LOG_STATS_END_OF_MATCH
-	totalNodesVisited += nodesVisited;
+	totalNodesVisited += searchControl.getNodesVisited();
 	totalTimeSpent += timer.getElapsedTimeInMilliSec();
 	++turnsPlayed;
 #endif // LOG_STATS_END_OF_MATCH
@@ -66,11 +126,17 @@ Move AspirationSearch::chooseMove(GameState& gameState)
 #endif // GATHER_STATISTICS
 }
 
-int AspirationSearch::alphaBeta(GameState& gameState, int depth, int alpha, int beta)
+int AspirationSearch::alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta)
 {
-#ifdef GATHER_STATISTICS
-	++nodesVisited;
-#endif // GATHER_STATISTICS
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+	if(SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
 
 	int originalAlpha = alpha;
 	uint64_t zobrist = gameState.getZobrist();
@@ -86,26 +152,29 @@ int AspirationSearch::alphaBeta(GameState& gameState, int depth, int alpha, int
 	}
 #endif
 
+	// wins are stored relative to the node, so convert back to a score relative to the root
+	int tableValue = (tableDataValid) ? SearchCore::scoreFromTable(tableData.value, ply, WIN_EVALUATION) : 0;
+
 	if(tableDataValid)
 	{
 		if(tableData.depth >= depth)	// ensure table stored in data resulted from a deep enough search
 		{
 			if(tableData.valueType == EValue::Type::REAL)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 			else if(tableData.valueType == EValue::Type::LOWER_BOUND)
 			{
-				alpha = std::max(alpha, tableData.value);
+				alpha = std::max(alpha, tableValue);
 			}
 			else if(tableData.valueType == EValue::Type::UPPER_BOUND)
 			{
-				beta = std::min(beta, tableData.value);
+				beta = std::min(beta, tableValue);
 			}
 
 			if(alpha >= beta)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 		}
 	}
@@ -115,7 +184,7 @@ int AspirationSearch::alphaBeta(GameState& gameState, int depth, int alpha, int
 	// stop search if we reached max depth or have found a winner
 	if(depth == 0 || winner != EPlayerColors::Type::NOTHING)
 	{
-		return evaluate(gameState, winner);
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
 	}
 
 	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
@@ -151,10 +220,10 @@ int AspirationSearch::alphaBeta(GameState& gameState, int depth, int alpha, int
 	while(!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBeta(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBeta(gameState, depth - 1, ply + 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
-		if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS)		// exceeding time limit
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
 		{
 			return 0;
 		}
@@ -209,15 +278,15 @@ int AspirationSearch::alphaBeta(GameState& gameState, int depth, int alpha, int
 	// Store data in Transposition Table
 	if(score <= originalAlpha)		// found upper bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::UPPER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::UPPER_BOUND, depth);
 	}
 	else if(score >= beta)			// found lower bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::LOWER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
 	}
 	else							// found exact value
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::REAL, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::REAL, depth);
 	}
 
 	return score;
@@ -247,9 +316,6 @@ int AspirationSearch::evaluate(const GameState& gameState, EPlayerColors::Type w
 	// simple material difference, weight = 100, range = [-1600, 1600]
 	int materialDifference = 100 * (gameState.getNumWhiteKnights() - gameState.getNumBlackKnights());
 
-	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
-	int progression = 0;
-
 	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
 	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
 
@@ -263,60 +329,22 @@ int AspirationSearch::evaluate(const GameState& gameState, EPlayerColors::Type w
 		return WIN_EVALUATION;
 	}
 
-	int blackProgression = 0;
-	int whiteProgression = 0;
-
-	if(blackBitboard & Bitboards::ROW_2)
-	{
-		blackProgression = 6;
-	}
-	else if(blackBitboard & Bitboards::ROW_3)
-	{
-		blackProgression = 5;
-	}
-	else if(blackBitboard & Bitboards::ROW_4)
+#ifdef USE_RACE_DETECTION
+	// more generally, a knight that is further away from its goal row may still be certain to get there first
+	int racePlies = RaceDetector::detectRace(gameState);
+	if(racePlies != 0)
 	{
-		blackProgression = 4;
-	}
-	else if(blackBitboard & Bitboards::ROW_5)
-	{
-		blackProgression = 3;
-	}
-	else if(blackBitboard & Bitboards::ROW_6)
-	{
-		blackProgression = 2;
-	}
-	else if(blackBitboard & Bitboards::ROW_7)
-	{
-		blackProgression = 1;
+		return SearchCore::getDistanceEvaluation(racePlies, WIN_EVALUATION);
 	}
+#endif // USE_RACE_DETECTION
 
-	if(whiteBitboard & Bitboards::ROW_7)
-	{
-		whiteProgression = 6;
-	}
-	else if(whiteBitboard & Bitboards::ROW_6)
-	{
-		whiteProgression = 5;
-	}
-	else if(whiteBitboard & Bitboards::ROW_5)
-	{
-		whiteProgression = 4;
-	}
-	else if(whiteBitboard & Bitboards::ROW_4)
-	{
-		whiteProgression = 3;
-	}
-	else if(whiteBitboard & Bitboards::ROW_3)
-	{
-		whiteProgression = 2;
-	}
-	else if(whiteBitboard & Bitboards::ROW_2)
-	{
-		whiteProgression = 1;
-	}
-
-	progression = 35 * (whiteProgression - blackProgression);
+#ifdef USE_PIECE_SQUARE_EVALUATION
+	// progression = difference in advancement of all knights, with a popcount per weight plane of the piece-square tables
+	int progression = whitePieceSquarePlanes.evaluate(whiteBitboard) - blackPieceSquarePlanes.evaluate(blackBitboard);
+#else
+	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
+	int progression = 35 * (gameState.getProgression(EPlayerColors::Type::WHITE_PLAYER) - gameState.getProgression(EPlayerColors::Type::BLACK_PLAYER));
+#endif // USE_PIECE_SQUARE_EVALUATION
 
 	// compute final score
 	int score = materialDifference + progression;
@@ -343,6 +371,8 @@ double AspirationSearch::getSecondsSearched()
 Move AspirationSearch::startAspirationSearch(GameState& gameState)
 {
 	clock.start();
+	timeManager.startMove(searchLimits, gameState);
+	searchControl.startSearch(timeManager.getTargetTimeMs(), timeManager.getMaxTimeMs(), searchLimits.maxNodes);
 	EPlayerColors::Type winner = gameState.getWinner();
 
 	// stop search if we reached max depth or have found a winner
@@ -351,6 +381,23 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 		return INVALID_MOVE;		// can't return any normal move if game already ended
 	}
 
+#ifdef USE_DFPN_HANDOFF
+	if(gameState.getNumBlackKnights() + gameState.getNumWhiteKnights() <= DFPN_HANDOFF_MAX_KNIGHTS)
+	{
+		Move provenMove = INVALID_MOVE;
+
+		// the solver does not know the distance to the win, so it is reported as the slowest win that is still recognized as a win
+		if(dfpnSolver.solve(gameState, searchControl, DFPN_HANDOFF_MAX_NODES, provenMove) == EProofResult::Type::PROVEN_WIN)
+		{
+			searchDepth = 0;
+			lastRootEvaluation = SearchCore::getWinScore(MAX_WIN_DISTANCE - 1, WIN_EVALUATION);
+			reportIteration(searchDepth, lastRootEvaluation, provenMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+			clock.stop();
+			return provenMove;
+		}
+	}
+#endif // USE_DFPN_HANDOFF
+
 	std::vector<Move> moves;				// will store all the moves in the root node, necessary for move ordering based on scores found in previous searches
 	moves.reserve(16 * 4);
 
@@ -368,9 +415,16 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 	}
 
 	std::vector<int> moveScores;			// will store the scores of the moves here, to use for sorting
-	moveScores.reserve(moves.size());
+	moveScores.resize(moves.size(), 0);
 
-	// best move found from a complete search (so not considering searches that were terminated early)
+	if(moves.empty())
+	{
+		clock.stop();
+		return INVALID_MOVE;		// no legal moves, so there is nothing to fall back to either
+	}
+
+	// best move found from a complete search (so not considering searches that were terminated early). Starts out as the
+	// first legal move, so that a search that is stopped before completing its first iteration still returns a playable move
 	Move bestMoveCompleteSearch = moves[0];
 
 	int guess = lastRootEvaluation;		// start guess with the final root evaluation of our previous search
@@ -396,16 +450,20 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 
 		// best move for only this particular search
 		Move bestMove = moves[0];
+		// best move of this particular search if it is terminated early
+		Move bestMovePartialSearch = INVALID_MOVE;
 
 		for(int i = 0; i < moves.size(); ++i)
 		{
 			const Move& m = moves[i];											// select move
 			gameState.applyMove(m);												// apply move
-			int value = -alphaBeta(gameState, searchDepth - 1, -beta, -alpha);	// continue searching
+			int value = -alphaBeta(gameState, searchDepth - 1, 1, -beta, -alpha);	// continue searching
 			gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
-			if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS)		// exceeding time limit
+			if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
 			{
+				// the previous best move is searched first, so a best move that got inside the window is at least as good
+				bestMovePartialSearch = (i > 0 && score > guess - deltaGuess) ? bestMove : INVALID_MOVE;
 				bestMove = INVALID_MOVE;
 				break;
 			}
@@ -432,6 +490,7 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 		if(score >= (guess + deltaGuess) && !(bestMove == INVALID_MOVE))
 		{
 			newSearchNeeded = true;
+			bestMovePartialSearch = bestMove;		// proven to be better than the guess, so better than nothing if the re-search is terminated
 			alpha = score;
 			beta = MathConstants::LARGE_ENOUGH_INT;
 		}
@@ -447,6 +506,7 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 			LOG_MESSAGE(StringBuilder() << ">>>>>>>>>>>>>>>> Aspiration Search required a new Search at depth = " << searchDepth << "! <<<<<<<<<<<<<<<<<<<")
 			LOG_MESSAGE(StringBuilder() << "Window = [" << (guess - deltaGuess) << ", " << (guess + deltaGuess) << "]")
 			score = MathConstants::LOW_ENOUGH_INT;
+			int researchAlpha = alpha;
 
 			// best move for only this particular search
 			bestMove = moves[0];
@@ -455,11 +515,16 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 			{
 				const Move& m = moves[i];											// select move
 				gameState.applyMove(m);												// apply move
-				int value = -alphaBeta(gameState, searchDepth - 1, -beta, -alpha);	// continue searching
+				int value = -alphaBeta(gameState, searchDepth - 1, 1, -beta, -alpha);	// continue searching
 				gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
-				if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS)		// exceeding time limit
+				if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
 				{
+					if(i > 0 && score > researchAlpha)
+					{
+						bestMovePartialSearch = bestMove;
+					}
+
 					bestMove = INVALID_MOVE;
 					break;
 				}
@@ -488,15 +553,15 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 		if(!(bestMove == INVALID_MOVE))	// managed to complete the search within time
 		{
 			lastRootEvaluation = score;
+			timeManager.iterationCompleted(score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+			reportIteration(searchDepth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
 
-			if(score == WIN_EVALUATION)	// the search was enough to prove a win for us, so return best move of this latest search
+			// the search proved a win or a loss, and searched deep enough to be sure that there is no faster one. The best move
+			// then either wins as fast as possible, or postpones the loss as long as possible
+			if(SearchCore::isWinScore(score, WIN_EVALUATION) && SearchCore::getWinDistance(score, WIN_EVALUATION) <= searchDepth)
 			{
 				return bestMove;
 			}
-			else if(score == -WIN_EVALUATION)	// the search proved a win for opponent, so return best move of the previous search
-			{
-				return bestMoveCompleteSearch;
-			}
 
 			// finished search, and didn't prove a win for either team, so save the new best result
 			bestMoveCompleteSearch = bestMove;
@@ -504,9 +569,15 @@ Move AspirationSearch::startAspirationSearch(GameState& gameState)
 		else
 		{
 			--searchDepth;	// since last search was unsuccessful, decrement this so GUI doesn't lie to us
+
+			if(!(bestMovePartialSearch == INVALID_MOVE))
+			{
+				bestMoveCompleteSearch = bestMovePartialSearch;
+			}
 		}
 
-		if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS)		// exceeding time limit
+		if(searchControl.isStopped() || (searchLimits.maxDepth > 0 && searchDepth >= searchLimits.maxDepth) ||
+			!timeManager.shouldStartNextIteration(searchControl.getElapsedMs()))		// search terminated, exceeding depth limit, or next iteration not expected to finish in time
 		{
 			clock.stop();
 			return bestMoveCompleteSearch;
@@ -3,12 +3,25 @@
 #include <inttypes.h>
 
 #include "AiEngine.h"
+#include "DfpnSolver.h"
+#include "OpeningBook.h"
+#include "PieceSquarePlanes.h"
+#include "TimeManager.h"
 #include "Timer.hpp"
 #include "TranspositionTable.h"
 
 /**
 * Engine using Aspiration Search. Similar to Iterative Deepening, except for starting searches
 * with a smaller window.
+*
+* Once few knights are left on the board, the search is first handed off to a DFPN solver, which proves wins far beyond
+* the depth that Aspiration Search can reach. If the solver does not prove a win within its budget, the normal search is used.
+*
+* Positions in the opening book are not searched at all, but answered with the move stored in the book.
+*
+* Leaves are evaluated directly, without the quiescence search of the Principal Variation Search engine. Without the
+* reductions that pay for it there, it multiplies the nodes of a fixed depth search by 2 to 6. Knights that threaten to
+* win are recognized by the evaluation function instead.
 */
 class AspirationSearch : public AiEngine
 {
@@ -30,32 +43,46 @@ private:
 	/** The engine's Transposition Table */
 	TranspositionTable transpositionTable;
 
+	/** Solver used to prove wins in endgames */
+	DfpnSolver dfpnSolver;
+
+	/** Opening book, probed at the root before searching */
+	OpeningBook openingBook;
+
+#ifdef USE_PIECE_SQUARE_EVALUATION
+	/** The piece-square tables of both players as weight planes, used by the evaluation function */
+	PieceSquarePlanes blackPieceSquarePlanes;
+	PieceSquarePlanes whitePieceSquarePlanes;
+#endif // USE_PIECE_SQUARE_EVALUATION
+
 	/** Table of killer moves */
 	std::vector<std::vector<Move>> killerMoves;
 
-	/** A clock used to avoid overshooting the allowed search time by too much */
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
 	Timer clock;
 
 	/** The evaluation of the root node during the last search */
 	int lastRootEvaluation;
 
-	/** The minimum amount of time in milliseconds that the algorithm will spend search */
+	/** The default amount of time in milliseconds that the algorithm will spend search */
 	const int MIN_SEARCH_TIME_MS = 25000;
-	/** The maximum amount of time in milliseconds that the algorithm will spend trying to complete the current search when over MIN_SEARCH_TIME_MS */
+	/** The default amount of time in milliseconds that the algorithm may spend on top of MIN_SEARCH_TIME_MS to complete or extend its search */
 	const int MAX_EXTRA_SEARCH_TIME_MS = 5000;
 
+	/** Decides how much time to spend on every move, and whether or not to start new iterations. Initialized after the constants above */
+	TimeManager timeManager;
+
 	// variables used for gathering and logging statistics
-	int nodesVisited;
 	int64_t totalNodesVisited;
 	double totalTimeSpent;
 	int turnsPlayed;
 	int searchDepth;
 
 	/**
-	* Continues alpha-beta search, given the game state, maximum search depth, and current alpha and beta values.
+	* Continues alpha-beta search, given the game state, maximum search depth, distance from the root, and current alpha and beta values.
 	* Returns the node's evaluation.
 	*/
-	int alphaBeta(GameState& gameState, int depth, int alpha, int beta);
+	int alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta);
 
 	/**
 	* Returns an evaluation of the given game state.
@@ -1,13 +1,15 @@
 #include "BasicAlphaBeta.h"
 #include "Logger.h"
 #include "MathConstants.h"
+#include "SearchCore.h"
 #include "Timer.hpp"
 
 /** 
  * The evaluation corresponding to a won game. 
  * Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+ * Wins are scored as this value minus their distance in plies from the root (see SearchCore::getWinScore())
  */ 
-#define WIN_EVALUATION 20
+#define WIN_EVALUATION 200
 
 /**
  * The depth to which the engine should search the game tree.
@@ -19,11 +21,13 @@ BasicAlphaBeta::BasicAlphaBeta() : lastRootEvaluation(0), totalNodesVisited(0),
 
 Move BasicAlphaBeta::chooseMove(GameState& gameState)
 {
+	// callers of start() may override the search depth
+	int depth = (searchLimits.maxDepth > 0) ? searchLimits.maxDepth : SEARCH_DEPTH;
+
 #ifdef GATHER_STATISTICS
-	nodesVisited = 0;
 	Timer timer;
 	timer.start();
-	Move moveToPlay = startAlphaBeta(gameState, SEARCH_DEPTH);
+	Move moveToPlay = startAlphaBeta(gameState, depth);
 	timer.stop();
 
 #ifdef LOG_STATS_PER_TURN
@@ -36,36 +40,42 @@ Move BasicAlphaBeta::chooseMove(GameState& gameState)
 		LOG_MESSAGE(StringBuilder() << "Basic Alpha Beta engine searching move for White Player")
 	}
 
-	LOG_MESSAGE(StringBuilder() << "Search depth:					" << SEARCH_DEPTH)
-	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << nodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Search depth:					" << depth)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
 	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
 	LOG_MESSAGE("")
 #endif // LOG_STATS_PER_TURN
 
 #ifdef LOG_STATS_END_OF_MATCH
-	totalNodesVisited += nodesVisited;
+	totalNodesVisited += searchControl.getNodesVisited();
 	totalTimeSpent += timer.getElapsedTimeInMilliSec();
 	++turnsPlayed;
 #endif // LOG_STATS_END_OF_MATCH
 
 	return moveToPlay;
 #else
-	return startAlphaBeta(gameState, SEARCH_DEPTH);
+	return startAlphaBeta(gameState, depth);
 #endif // GATHER_STATISTICS
 }
 
-int BasicAlphaBeta::alphaBeta(GameState& gameState, int depth, int alpha, int beta)
+int BasicAlphaBeta::alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta)
 {
-#ifdef GATHER_STATISTICS
-	++nodesVisited;
-#endif // GATHER_STATISTICS
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+	if (SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
 
 	EPlayerColors::Type winner = gameState.getWinner();
 
 	// stop search if we reached max depth or have found a winner
 	if (depth == 0 || winner != EPlayerColors::Type::NOTHING)
 	{
-		return evaluate(gameState, winner);
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
 	}
 
 	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
@@ -80,9 +90,14 @@ int BasicAlphaBeta::alphaBeta(GameState& gameState, int depth, int alpha, int be
 	while(!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBeta(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBeta(gameState, depth - 1, ply + 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
 		if (value > score)		// new best move found
 		{
 			score = value;
@@ -134,6 +149,8 @@ int BasicAlphaBeta::evaluate(const GameState& gameState, EPlayerColors::Type win
 
 Move BasicAlphaBeta::startAlphaBeta(GameState& gameState, int depth)
 {
+	searchControl.startSearch(0, searchLimits.maxTimeMs, searchLimits.maxNodes);
+
 	EPlayerColors::Type winner = gameState.getWinner();
 
 	// stop search if we reached max depth or have found a winner
@@ -157,9 +174,14 @@ Move BasicAlphaBeta::startAlphaBeta(GameState& gameState, int depth)
 	while(!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBeta(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBeta(gameState, depth - 1, 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
+		if(searchControl.isStopped())		// search terminated, so keep the best move among the moves that were searched completely
+		{
+			break;
+		}
+
 		if (value > score)		// new best move found
 		{
 			score = value;
@@ -178,7 +200,15 @@ Move BasicAlphaBeta::startAlphaBeta(GameState& gameState, int depth)
 		m = moveGenerator.nextMove();
 	}
 
-	lastRootEvaluation = score;
+	if(score != MathConstants::LOW_ENOUGH_INT)		// completed search of at least one move
+	{
+		lastRootEvaluation = score;
+	}
+
+	if(!searchControl.isStopped())
+	{
+		reportIteration(depth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+	}
 
 	return bestMove;
 }
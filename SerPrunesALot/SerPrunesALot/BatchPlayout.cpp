@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // _WIN32
+
+#include "BatchPlayout.h"
+#include "BatchPlayoutKernel.h"
+#include "Bitboards.hpp"
+#include "GameState.h"
+#include "Logger.h"
+#include "MonteCarloTreeSearch.h"
+#include "MoveGenerator.h"
+#include "Timer.hpp"
+
+// the kernel cannot include Bitboards.hpp, so it has its own copies of the constants it needs
+static_assert(BatchPlayoutKernel::FILE_A == Bitboards::FILE_A && BatchPlayoutKernel::FILE_B == Bitboards::FILE_B &&
+			  BatchPlayoutKernel::FILE_G == Bitboards::FILE_G && BatchPlayoutKernel::FILE_H == Bitboards::FILE_H,
+			  "The files of the batched playout kernel differ from those of Bitboards");
+static_assert(BatchPlayoutKernel::DANGER_ZONE_BOTTOM == Bitboards::DANGER_ZONE_BOTTOM && BatchPlayoutKernel::DANGER_ZONE_TOP == Bitboards::DANGER_ZONE_TOP,
+			  "The danger zones of the batched playout kernel differ from those of Bitboards");
+
+namespace
+{
+	/** Executes the cpuid instruction for the given leaf and subleaf, and stores eax, ebx, ecx and edx in the given registers */
+	void cpuid(int registers[4], int leaf, int subleaf)
+	{
+#ifdef _WIN32
+		__cpuidex(registers, leaf, subleaf);
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif // _WIN32
+	}
+
+	/** Returns the register states that the operating system saves on context switches (XCR0). Requires OSXSAVE */
+	uint64_t getEnabledRegisterStates()
+	{
+#ifdef _WIN32
+		return _xgetbv(0);
+#else
+		uint32_t eax;
+		uint32_t edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64_t)edx << 32) | eax;
+#endif // _WIN32
+	}
+
+	/** Returns true iff both the processor and the operating system support the given instruction set */
+	bool isInstructionSetSupported(EInstructionSet::Type instructionSet)
+	{
+		if(instructionSet == EInstructionSet::Type::SCALAR)
+		{
+			return true;
+		}
+
+		int registers[4];
+		cpuid(registers, 0, 0);
+		if(registers[0] < 7)
+		{
+			return false;
+		}
+
+		// the operating system must save the AVX registers (OSXSAVE and XCR0), and the processor must support AVX and FMA
+		cpuid(registers, 1, 0);
+		bool osxsave = (registers[2] & (1 << 27)) != 0;
+		bool avx = (registers[2] & (1 << 28)) != 0;
+		bool fma = (registers[2] & (1 << 12)) != 0;
+		if(!osxsave || !avx || !fma || (getEnabledRegisterStates() & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		// compilers may use BMI1 and BMI2 along with AVX2
+		cpuid(registers, 7, 0);
+		bool avx2 = (registers[1] & (1 << 5)) != 0;
+		bool bmi1 = (registers[1] & (1 << 3)) != 0;
+		bool bmi2 = (registers[1] & (1 << 8)) != 0;
+		if(!avx2 || !bmi1 || !bmi2)
+		{
+			return false;
+		}
+
+		if(instructionSet == EInstructionSet::Type::AVX2)
+		{
+			return true;
+		}
+
+		// AVX-512 also needs the operating system to save the mask registers and the upper halves of all 32 ZMM registers
+		bool avx512f = (registers[1] & (1 << 16)) != 0;
+		bool avx512bw = (registers[1] & (1 << 30)) != 0;
+		return avx512f && avx512bw && (getEnabledRegisterStates() & 0xE6) == 0xE6;
+	}
+
+	/** Returns the name of the given instruction set */
+	const char* getInstructionSetName(EInstructionSet::Type instructionSet)
+	{
+		switch(instructionSet)
+		{
+		case EInstructionSet::Type::AVX2:
+			return "AVX2";
+		case EInstructionSet::Type::AVX512:
+			return "AVX-512";
+		default:
+			return "scalar";
+		}
+	}
+
+	/** True iff the processor supports the instruction set of the vectorized kernel. Checked once, when the program starts */
+	const bool VECTOR_KERNEL_SUPPORTED = isInstructionSetSupported(BatchPlayoutKernel::VECTOR_INSTRUCTION_SET);
+
+	/** Prepares a batch for the given games, and seeds the random number generators of the lanes with the given generator */
+	void initBatch(BatchPlayoutKernel::Batch& batch, const uint64_t* blackBitboards, const uint64_t* whiteBitboards,
+				   const EPlayerColors::Type* playersToMove, EPlayerColors::Type* winners, int numGames, RNG::FastGenerator_64& random)
+	{
+		batch.blackBitboards = blackBitboards;
+		batch.whiteBitboards = whiteBitboards;
+		batch.playersToMove = playersToMove;
+		batch.winners = winners;
+		batch.numGames = numGames;
+		batch.nextGame = 0;
+
+		// only the lanes of the vectorized kernel are seeded, so that the scalar fallback plays exactly the same games
+		for(int groupIndex = 0; groupIndex < BATCH_PLAYOUT_GROUPS; ++groupIndex)
+		{
+			for(int lane = 0; lane < BATCH_PLAYOUT_MAX_LANES; ++lane)
+			{
+				bool used = (lane < BatchPlayoutKernel::VECTOR_LANES);
+				batch.randomStates[groupIndex][0][lane] = used ? (random.randomUint_64() | 1) : 1;
+				batch.randomStates[groupIndex][1][lane] = used ? random.randomUint_64() : 0;
+			}
+		}
+	}
+
+	/**
+	 * Plays the given game state out to the end with the same policy as the batched kernel, but through GameState and
+	 * MoveGenerator, as the search engines do, and returns the winner. The given vector is used to store moves
+	 */
+	EPlayerColors::Type playoutGameState(GameState& gameState, std::vector<Move>& moves, RNG::FastGenerator_64& random)
+	{
+		while(true)
+		{
+			EPlayerColors::Type winner = gameState.getWinner();
+
+			if(winner != EPlayerColors::Type::NOTHING)
+			{
+				return winner;
+			}
+
+			EPlayerColors::Type player = gameState.getCurrentPlayer();
+			EPlayerColors::Type opponent = gameState.getOpponentColor(player);
+			uint64_t playerBitboard = gameState.getBitboard(player);
+			uint64_t opponentBitboard = gameState.getBitboard(opponent);
+
+			if(playerBitboard & MoveGenerator::getDangerZone(player))		// we can move to the goal row right away
+			{
+				return player;
+			}
+
+			uint64_t threats = opponentBitboard & MoveGenerator::getDangerZone(opponent);
+			MoveGenerator moveGenerator(player, playerBitboard, opponentBitboard);
+			moves.clear();
+
+			// captures are generated before quiet moves, which are only needed if there are no captures
+			for(Move move = moveGenerator.nextMove(); !(move == INVALID_MOVE); move = moveGenerator.nextMove())
+			{
+				if(threats)
+				{
+					if(Bitboards::isSingleBit(threats) && Bitboards::isBitSet(threats, move.to))
+					{
+						moves.push_back(move);
+					}
+				}
+				else if(move.captured || moves.empty())
+				{
+					moves.push_back(move);
+				}
+				else if(moves[0].captured)
+				{
+					break;
+				}
+				else
+				{
+					moves.push_back(move);
+				}
+			}
+
+			if(moves.empty())		// the threat cannot be stopped, or there are no legal moves
+			{
+				return opponent;
+			}
+
+			gameState.applyMove(moves[random.randomBelow((uint32_t)moves.size())]);
+		}
+	}
+
+	/** Logs the playouts per second and the share of wins for black of a benchmarked playout implementation */
+	void logBenchmark(const std::string& name, int numPlayouts, int blackWins, double seconds)
+	{
+		LOG_MESSAGE(StringBuilder() << name << ":\t\t" << (int64_t)(numPlayouts / seconds) << " playouts/s, black wins " << (100.0 * blackWins / numPlayouts) << "%")
+	}
+}
+
+void BatchPlayout::playout(const uint64_t* blackBitboards, const uint64_t* whiteBitboards, const EPlayerColors::Type* playersToMove,
+						   EPlayerColors::Type* winners, int numGames, RNG::FastGenerator_64& random)
+{
+	if(!VECTOR_KERNEL_SUPPORTED)
+	{
+		playoutScalar(blackBitboards, whiteBitboards, playersToMove, winners, numGames, random);
+		return;
+	}
+
+	BatchPlayoutKernel::Batch batch;
+	initBatch(batch, blackBitboards, whiteBitboards, playersToMove, winners, numGames, random);
+	BatchPlayoutKernel::playoutVector(batch);
+}
+
+void BatchPlayout::playoutScalar(const uint64_t* blackBitboards, const uint64_t* whiteBitboards, const EPlayerColors::Type* playersToMove,
+								 EPlayerColors::Type* winners, int numGames, RNG::FastGenerator_64& random)
+{
+	BatchPlayoutKernel::Batch batch;
+	initBatch(batch, blackBitboards, whiteBitboards, playersToMove, winners, numGames, random);
+
+	// emulates as many lanes as the vectorized kernel has
+	if(BatchPlayoutKernel::VECTOR_LANES == 8)
+	{
+		BatchPlayoutKernel::playoutKernel<BatchPlayoutKernel::ScalarLanes<8>>(batch);
+	}
+	else
+	{
+		BatchPlayoutKernel::playoutKernel<BatchPlayoutKernel::ScalarLanes<4>>(batch);
+	}
+}
+
+const char* BatchPlayout::getInstructionSet()
+{
+	return getInstructionSetName(VECTOR_KERNEL_SUPPORTED ? BatchPlayoutKernel::VECTOR_INSTRUCTION_SET : EInstructionSet::Type::SCALAR);
+}
+
+void BatchPlayout::benchmark(int numPlayouts)
+{
+	GameState startState;
+	startState.reset();
+	uint64_t blackBitboard = startState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
+	uint64_t whiteBitboard = startState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
+	EPlayerColors::Type playerToMove = startState.getCurrentPlayer();
+
+	std::vector<uint64_t> blackBitboards(numPlayouts, blackBitboard);
+	std::vector<uint64_t> whiteBitboards(numPlayouts, whiteBitboard);
+	std::vector<EPlayerColors::Type> playersToMove(numPlayouts, playerToMove);
+	std::vector<EPlayerColors::Type> scalarWinners(numPlayouts, EPlayerColors::Type::NOTHING);
+	std::vector<EPlayerColors::Type> batchedWinners(numPlayouts, EPlayerColors::Type::NOTHING);
+
+	uint64_t seed = RNG::randomUint_64() | 1;
+	Timer timer;
+
+	LOG_MESSAGE(StringBuilder() << "Benchmarking " << numPlayouts << " playouts from the start position, batched kernel: " << getInstructionSet() << " with " << BatchPlayoutKernel::VECTOR_LANES << " lanes")
+	if(!VECTOR_KERNEL_SUPPORTED)
+	{
+		LOG_MESSAGE(StringBuilder() << "The processor does not support " << getInstructionSetName(BatchPlayoutKernel::VECTOR_INSTRUCTION_SET) << ", so the scalar fallback is used instead")
+	}
+
+	// the playouts through GameState and MoveGenerator
+	{
+		RNG::FastGenerator_64 random(seed);
+		GameState gameState;
+		std::vector<Move> moves;
+		int blackWins = 0;
+		timer.start();
+
+		for(int i = 0; i < numPlayouts; ++i)
+		{
+			gameState.copyFrom(startState);
+
+			if(playoutGameState(gameState, moves, random) == EPlayerColors::Type::BLACK_PLAYER)
+			{
+				++blackWins;
+			}
+		}
+
+		logBenchmark("GameState", numPlayouts, blackWins, timer.getElapsedTimeInSec());
+	}
+
+	// the bitboard playouts of MonteCarloTreeSearch, one game at a time
+	{
+		RNG::FastGenerator_64 random(seed);
+		int blackWins = 0;
+		timer.start();
+
+		for(int i = 0; i < numPlayouts; ++i)
+		{
+			if(MonteCarloTreeSearch::playout(blackBitboard, whiteBitboard, playerToMove, random) == EPlayerColors::Type::BLACK_PLAYER)
+			{
+				++blackWins;
+			}
+		}
+
+		logBenchmark("Bitboards", numPlayouts, blackWins, timer.getElapsedTimeInSec());
+	}
+
+	// the batched kernel, with the scalar fallback and with the widest instruction set available
+	{
+		RNG::FastGenerator_64 random(seed);
+		timer.start();
+		playoutScalar(blackBitboards.data(), whiteBitboards.data(), playersToMove.data(), scalarWinners.data(), numPlayouts, random);
+		double seconds = timer.getElapsedTimeInSec();
+		logBenchmark("Batched, scalar", numPlayouts, (int)std::count(scalarWinners.begin(), scalarWinners.end(), EPlayerColors::Type::BLACK_PLAYER), seconds);
+	}
+	{
+		RNG::FastGenerator_64 random(seed);
+		timer.start();
+		playout(blackBitboards.data(), whiteBitboards.data(), playersToMove.data(), batchedWinners.data(), numPlayouts, random);
+		double seconds = timer.getElapsedTimeInSec();
+		logBenchmark(StringBuilder() << "Batched, " << getInstructionSet(), numPlayouts, (int)std::count(batchedWinners.begin(), batchedWinners.end(), EPlayerColors::Type::BLACK_PLAYER), seconds);
+	}
+
+	// given the same seeds, both kernels must have played exactly the same games
+	if(scalarWinners != batchedWinners)
+	{
+		LOG_ERROR("The batched playouts of the scalar fallback and the vectorized kernel differ")
+	}
+
+	LOG_MESSAGE("")
+}
\ No newline at end of file
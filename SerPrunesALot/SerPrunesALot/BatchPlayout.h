@@ -0,0 +1,48 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "GameState.h"
+#include "RNG.h"
+
+/**
+ * Playouts of many independent games at once, with the same policy as MonteCarloTreeSearch::playout(): a player wins right
+ * away if it can, captures a knight that threatens to win if it can (and loses otherwise), and otherwise prefers captures
+ * over quiet moves.
+ *
+ * Every lane of a vector register holds one game, always seen from the perspective of the player to move: the bitboards are
+ * mirrored vertically (by reversing their bytes) whenever the player to move is white, so that the player to move always
+ * moves towards higher indices like black does. This way, all lanes compute their knight targets with the same shifts and
+ * masks, and check the same danger zones. Lanes hold 64-bit bitboards, so a kernel advances 8 games at once with AVX-512 and
+ * 4 with AVX2. The instruction set of the vectorized kernel is chosen when compiling BatchPlayoutVector.cpp (the project
+ * compiles it with /arch:AVX2, which can be changed to /arch:AVX512 on processors that support it). Whether the processor
+ * supports it is checked when the program starts, and the scalar fallback is used otherwise. The scalar fallback emulates as
+ * many lanes as the vectorized kernel, so that both play exactly the same games.
+ *
+ * A random move is chosen per lane without any branches, by rotating the candidate targets by a random amount and isolating
+ * the lowest bit, which is cheap but not exactly uniform. As soon as a game ends, its lane is refilled with the next game of
+ * the batch, so that no lanes idle until the last games of the batch.
+ */
+namespace BatchPlayout
+{
+	/**
+	 * Plays out the given number of games, given the bitboards and player to move of each, and stores their winners.
+	 * The random number generator is only used to seed the generators of the lanes.
+	 * Uses the vectorized kernel if the processor supports it, and the scalar fallback otherwise
+	 */
+	void playout(const uint64_t* blackBitboards, const uint64_t* whiteBitboards, const EPlayerColors::Type* playersToMove,
+				 EPlayerColors::Type* winners, int numGames, RNG::FastGenerator_64& random);
+
+	/** Same as above, but always uses the scalar fallback, which plays exactly the same games as the vectorized kernel */
+	void playoutScalar(const uint64_t* blackBitboards, const uint64_t* whiteBitboards, const EPlayerColors::Type* playersToMove,
+					   EPlayerColors::Type* winners, int numGames, RNG::FastGenerator_64& random);
+
+	/** Returns the name of the instruction set that playout() uses on this processor */
+	const char* getInstructionSet();
+
+	/**
+	 * Runs the given number of playouts from the start position with the scalar GameState path, the bitboard playouts of
+	 * MonteCarloTreeSearch, the scalar fallback and the vectorized kernel, and logs the playouts per second of each
+	 */
+	void benchmark(int numPlayouts);
+}
\ No newline at end of file
@@ -0,0 +1,478 @@
+#pragma once
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "GameConstants.h"
+
+/**
+ * The kernel of the batched playouts (see BatchPlayout.h), shared by BatchPlayout.cpp and BatchPlayoutVector.cpp.
+ *
+ * BatchPlayoutVector.cpp is the only source file that is compiled with a wider instruction set than the rest of the program,
+ * so this header must not include any header of the project with inline functions or static initializers: the linker may
+ * keep the copy of an inline function compiled with the wider instruction set, and static initializers run on every
+ * processor. For the same reason, all functions of the kernel are in an unnamed namespace, so that every source file gets its
+ * own copy, compiled with its own instruction set.
+ */
+
+/** The number of independent groups of lanes that the kernels advance in every iteration */
+#define BATCH_PLAYOUT_GROUPS 2
+/** The largest number of lanes of any kernel */
+#define BATCH_PLAYOUT_MAX_LANES 8
+
+/** The instruction sets that the vectorized kernel can be compiled for */
+namespace EInstructionSet
+{
+	enum Type
+	{
+		/** No vector instructions: the vectorized kernel is the scalar fallback */
+		SCALAR,
+		AVX2,
+		/** AVX-512 Foundation and Byte and Word instructions */
+		AVX512
+	};
+}
+
+namespace BatchPlayoutKernel
+{
+	/** The games to play out, and where to store their winners */
+	struct Batch
+	{
+		const uint64_t* blackBitboards;
+		const uint64_t* whiteBitboards;
+		const EPlayerColors::Type* playersToMove;
+		EPlayerColors::Type* winners;
+		int numGames;
+		/** The next game that has not been loaded into a lane yet */
+		int nextGame;
+		/** The initial states (state0, state1) of the random number generators of every lane of every group. State 0 must not be 0 */
+		uint64_t randomStates[BATCH_PLAYOUT_GROUPS][2][BATCH_PLAYOUT_MAX_LANES];
+	};
+
+	/** The number of lanes of the vectorized kernel */
+	extern const int VECTOR_LANES;
+	/** The instruction set that BatchPlayoutVector.cpp was compiled for. The processor must support it to run playoutVector() */
+	extern const EInstructionSet::Type VECTOR_INSTRUCTION_SET;
+
+	/** Plays out all games of the given batch with the vectorized kernel. Defined in BatchPlayoutVector.cpp */
+	void playoutVector(Batch& batch);
+
+	namespace
+	{
+		/** Constant with all bits set to 0 (Bitboards::ALL_ZERO) */
+		const uint64_t ALL_ZERO = 0ULL;
+		/** Constant with all bits set to 1 (Bitboards::ALL_ONES) */
+		const uint64_t ALL_ONES = ~0ULL;
+
+		/** The files A, B, G and H (Bitboards::FILE_A etc.) */
+		const uint64_t FILE_A = 0x0101010101010101ULL;
+		const uint64_t FILE_B = FILE_A << 1;
+		const uint64_t FILE_G = FILE_A << 6;
+		const uint64_t FILE_H = FILE_A << 7;
+
+		/** The squares from which black (Bitboards::DANGER_ZONE_BOTTOM) and white (Bitboards::DANGER_ZONE_TOP) win with their next move */
+		const uint64_t DANGER_ZONE_BOTTOM = 0x00FFFF0000000000ULL;
+		const uint64_t DANGER_ZONE_TOP = 0x0000000000FFFF00ULL;
+
+		/** The squares that knights cannot reach in every direction, because they would wrap around the board */
+		const uint64_t NOT_FILES_AB = ~(FILE_A | FILE_B);
+		const uint64_t NOT_FILES_GH = ~(FILE_G | FILE_H);
+		const uint64_t NOT_FILE_A = ~FILE_A;
+		const uint64_t NOT_FILE_H = ~FILE_H;
+
+		/** Lane operations of the scalar fallback, which loops over the given number of lanes */
+		template<int LANES>
+		struct ScalarLanes
+		{
+			static const int NUM_LANES = LANES;
+
+			struct Vector
+			{
+				uint64_t lanes[NUM_LANES];
+			};
+
+			static inline Vector load(const uint64_t* values)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = values[lane]; }
+				return result;
+			}
+
+			static inline void store(uint64_t* values, const Vector& a)
+			{
+				for(int lane = 0; lane < NUM_LANES; ++lane) { values[lane] = a.lanes[lane]; }
+			}
+
+			static inline Vector broadcast(uint64_t value)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = value; }
+				return result;
+			}
+
+			static inline Vector bitAnd(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] & b.lanes[lane]; }
+				return result;
+			}
+
+			static inline Vector bitOr(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] | b.lanes[lane]; }
+				return result;
+			}
+
+			static inline Vector bitXor(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] ^ b.lanes[lane]; }
+				return result;
+			}
+
+			/** Returns a & ~b */
+			static inline Vector andNot(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] & ~b.lanes[lane]; }
+				return result;
+			}
+
+			static inline Vector add(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] + b.lanes[lane]; }
+				return result;
+			}
+
+			static inline Vector subtract(const Vector& a, const Vector& b)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] - b.lanes[lane]; }
+				return result;
+			}
+
+			template<int SHIFT>
+			static inline Vector shiftLeft(const Vector& a)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] << SHIFT; }
+				return result;
+			}
+
+			template<int SHIFT>
+			static inline Vector shiftRight(const Vector& a)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = a.lanes[lane] >> SHIFT; }
+				return result;
+			}
+
+			/** Rotates every lane to the left by the amount in the same lane of the given amounts, which must be in [0, 63] */
+			static inline Vector rotateLeft(const Vector& a, const Vector& amounts)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane)
+				{
+					uint64_t amount = amounts.lanes[lane];
+					result.lanes[lane] = (amount == 0) ? a.lanes[lane] : ((a.lanes[lane] << amount) | (a.lanes[lane] >> (64 - amount)));
+				}
+				return result;
+			}
+
+			/** Rotates every lane to the right by the amount in the same lane of the given amounts, which must be in [0, 63] */
+			static inline Vector rotateRight(const Vector& a, const Vector& amounts)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane)
+				{
+					uint64_t amount = amounts.lanes[lane];
+					result.lanes[lane] = (amount == 0) ? a.lanes[lane] : ((a.lanes[lane] >> amount) | (a.lanes[lane] << (64 - amount)));
+				}
+				return result;
+			}
+
+			/** Returns all bits set in the lanes that are 0, and no bits set in the other lanes */
+			static inline Vector isZero(const Vector& a)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result.lanes[lane] = (a.lanes[lane] == 0) ? ALL_ONES : ALL_ZERO; }
+				return result;
+			}
+
+			/** Mirrors the bitboard in every lane vertically */
+			static inline Vector reverseBytes(const Vector& a)
+			{
+				Vector result;
+				for(int lane = 0; lane < NUM_LANES; ++lane)
+				{
+	#ifdef _WIN32
+					result.lanes[lane] = _byteswap_uint64(a.lanes[lane]);
+	#else
+					result.lanes[lane] = __builtin_bswap64(a.lanes[lane]);
+	#endif // _WIN32
+				}
+				return result;
+			}
+
+			/** Given a mask as returned by isZero(), returns a number with bit i set iff lane i of the mask is set */
+			static inline int getLaneBits(const Vector& mask)
+			{
+				int result = 0;
+				for(int lane = 0; lane < NUM_LANES; ++lane) { result |= (int)(mask.lanes[lane] & 1) << lane; }
+				return result;
+			}
+		};
+
+		/** Returns a in the lanes where the given mask (as returned by isZero()) is set, and b in the other lanes */
+		template<typename Lanes>
+		inline typename Lanes::Vector select(const typename Lanes::Vector& mask, const typename Lanes::Vector& a, const typename Lanes::Vector& b)
+		{
+			return Lanes::bitOr(Lanes::bitAnd(mask, a), Lanes::andNot(b, mask));
+		}
+
+		/** Returns the squares that knights of the player to move (moving towards higher indices) could reach the given squares from */
+		template<typename Lanes>
+		inline typename Lanes::Vector getKnightOrigins(const typename Lanes::Vector& squares)
+		{
+			typedef typename Lanes::Vector Vector;
+			Vector origins = Lanes::template shiftRight<10>(Lanes::bitAnd(squares, Lanes::broadcast(NOT_FILES_AB)));
+			origins = Lanes::bitOr(origins, Lanes::template shiftRight<6>(Lanes::bitAnd(squares, Lanes::broadcast(NOT_FILES_GH))));
+			origins = Lanes::bitOr(origins, Lanes::template shiftRight<17>(Lanes::bitAnd(squares, Lanes::broadcast(NOT_FILE_A))));
+			return Lanes::bitOr(origins, Lanes::template shiftRight<15>(Lanes::bitAnd(squares, Lanes::broadcast(NOT_FILE_H))));
+		}
+
+		/**
+		 * Returns a single knight of the given knights that can move to the given target square, in every lane.
+		 * If multiple knights can, the first direction in the order of MonteCarloTreeSearch is preferred
+		 */
+		template<typename Lanes>
+		inline typename Lanes::Vector getMovingKnight(const typename Lanes::Vector& target, const typename Lanes::Vector& knights)
+		{
+			typedef typename Lanes::Vector Vector;
+			Vector origin0 = Lanes::bitAnd(Lanes::template shiftRight<10>(Lanes::bitAnd(target, Lanes::broadcast(NOT_FILES_AB))), knights);
+			Vector origin1 = Lanes::bitAnd(Lanes::template shiftRight<6>(Lanes::bitAnd(target, Lanes::broadcast(NOT_FILES_GH))), knights);
+			Vector origin2 = Lanes::bitAnd(Lanes::template shiftRight<17>(Lanes::bitAnd(target, Lanes::broadcast(NOT_FILE_A))), knights);
+			Vector origin3 = Lanes::bitAnd(Lanes::template shiftRight<15>(Lanes::bitAnd(target, Lanes::broadcast(NOT_FILE_H))), knights);
+
+			Vector origin = select<Lanes>(Lanes::isZero(origin2), origin3, origin2);
+			origin = select<Lanes>(Lanes::isZero(origin1), origin, origin1);
+			return select<Lanes>(Lanes::isZero(origin0), origin, origin0);
+		}
+
+		/** Advances the xorshift128+ generators of all lanes, and returns their next random numbers */
+		template<typename Lanes>
+		inline typename Lanes::Vector nextRandom(typename Lanes::Vector& state0, typename Lanes::Vector& state1)
+		{
+			typedef typename Lanes::Vector Vector;
+			Vector s1 = state0;
+			Vector s0 = state1;
+			state0 = s0;
+			s1 = Lanes::bitXor(s1, Lanes::template shiftLeft<23>(s1));
+			state1 = Lanes::bitXor(Lanes::bitXor(s1, s0), Lanes::bitXor(Lanes::template shiftRight<17>(s1), Lanes::template shiftRight<26>(s0)));
+			return Lanes::add(state1, s0);
+		}
+
+		/**
+		 * A group of lanes, each holding one game: the bitboards of the player to move and of the opponent, seen from the side of
+		 * the player to move (so always moving towards higher indices), a mask that is set iff the player to move is white, and
+		 * the state of the random number generator of the lane
+		 */
+		template<typename Lanes>
+		struct LaneGroup
+		{
+			typename Lanes::Vector player;
+			typename Lanes::Vector opponent;
+			typename Lanes::Vector white;
+			typename Lanes::Vector randomState0;
+			typename Lanes::Vector randomState1;
+			/** The game played in every lane, or -1 if there are no games left for the lane */
+			int games[Lanes::NUM_LANES];
+			/** Bit i is set iff lane i is playing a game */
+			int activeLanes;
+		};
+
+		/**
+		 * Advances the games in all lanes of the given group by one ply, and mirrors the board for the next player to move.
+		 * Returns the lanes (in the same format as getLaneBits()) whose games ended, with the lanes won by the player who was to
+		 * move set in the given mask
+		 */
+		template<typename Lanes>
+		inline int advanceGroup(LaneGroup<Lanes>& group, typename Lanes::Vector& wins)
+		{
+			typedef typename Lanes::Vector Vector;
+			const Vector player = group.player;
+			const Vector opponent = group.opponent;
+
+			// knight targets in all four directions
+			Vector targets = Lanes::bitAnd(Lanes::template shiftLeft<10>(player), Lanes::broadcast(NOT_FILES_AB));
+			targets = Lanes::bitOr(targets, Lanes::bitAnd(Lanes::template shiftLeft<6>(player), Lanes::broadcast(NOT_FILES_GH)));
+			targets = Lanes::bitOr(targets, Lanes::bitAnd(Lanes::template shiftLeft<17>(player), Lanes::broadcast(NOT_FILE_A)));
+			targets = Lanes::bitOr(targets, Lanes::bitAnd(Lanes::template shiftLeft<15>(player), Lanes::broadcast(NOT_FILE_H)));
+			targets = Lanes::andNot(targets, player);
+			Vector captures = Lanes::bitAnd(targets, opponent);
+			Vector quietMoves = Lanes::andNot(targets, opponent);
+
+			// the opponent wins on its next move, unless we capture the only threatening knight
+			Vector threats = Lanes::bitAnd(opponent, Lanes::broadcast(DANGER_ZONE_TOP));
+			Vector noThreat = Lanes::isZero(threats);
+			Vector singleThreat = Lanes::isZero(Lanes::bitAnd(threats, Lanes::subtract(threats, Lanes::broadcast(1))));
+			Vector capturers = Lanes::bitAnd(Lanes::bitAnd(player, getKnightOrigins<Lanes>(threats)), singleThreat);
+
+			// if there is a threat, we choose among the knights that can capture it, and otherwise among the targets
+			Vector candidates = select<Lanes>(noThreat, select<Lanes>(Lanes::isZero(captures), quietMoves, captures), capturers);
+			Vector amounts = Lanes::template shiftRight<58>(nextRandom<Lanes>(group.randomState0, group.randomState1));
+			Vector rotated = Lanes::rotateLeft(candidates, amounts);
+			Vector chosen = Lanes::rotateRight(Lanes::bitAnd(rotated, Lanes::subtract(Lanes::broadcast(0), rotated)), amounts);
+
+			Vector to = select<Lanes>(noThreat, chosen, threats);
+			Vector from = select<Lanes>(noThreat, getMovingKnight<Lanes>(chosen, player), chosen);
+			Vector newPlayer = Lanes::bitXor(player, Lanes::bitOr(from, to));
+			Vector newOpponent = Lanes::andNot(opponent, to);
+
+			// lane-wise termination: moving to the goal row right away, no move that avoids a loss, or capturing the last knight
+			Vector winsNow = Lanes::bitXor(Lanes::isZero(Lanes::bitAnd(player, Lanes::broadcast(DANGER_ZONE_BOTTOM))), Lanes::broadcast(ALL_ONES));
+			Vector loses = Lanes::andNot(Lanes::isZero(candidates), winsNow);
+			wins = Lanes::bitOr(winsNow, Lanes::andNot(Lanes::isZero(newOpponent), loses));
+
+			// the opponent moves next, so mirror the board and swap the players
+			group.player = Lanes::reverseBytes(newOpponent);
+			group.opponent = Lanes::reverseBytes(newPlayer);
+
+			return Lanes::getLaneBits(Lanes::bitOr(wins, loses)) & group.activeLanes;
+		}
+
+		/**
+		 * Stores the winners of the given finished lanes of the given group (as returned by advanceGroup()), and loads the next
+		 * games of the batch into them. Lanes stay idle if there are no games left.
+		 * Also switches the player to move in all other lanes
+		 */
+		template<typename Lanes>
+		void refillGroup(LaneGroup<Lanes>& group, int finishedLanes, const typename Lanes::Vector& wins, Batch& batch)
+		{
+			const int NUM_LANES = Lanes::NUM_LANES;
+			uint64_t players[NUM_LANES];
+			uint64_t opponents[NUM_LANES];
+			uint64_t whiteToMove[NUM_LANES];
+			uint64_t playerWins[NUM_LANES];
+			Lanes::store(players, group.player);
+			Lanes::store(opponents, group.opponent);
+			Lanes::store(whiteToMove, group.white);
+			Lanes::store(playerWins, wins);
+
+			for(int lane = 0; lane < NUM_LANES; ++lane)
+			{
+				if(!(finishedLanes & (1 << lane)))
+				{
+					whiteToMove[lane] = ~whiteToMove[lane];
+					continue;
+				}
+
+				if(group.games[lane] >= 0)
+				{
+					bool whiteWins = (whiteToMove[lane] != 0) == (playerWins[lane] != 0);
+					batch.winners[group.games[lane]] = whiteWins ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+				}
+
+				if(batch.nextGame < batch.numGames)
+				{
+					int game = batch.nextGame++;
+					group.games[lane] = game;
+					group.activeLanes |= (1 << lane);
+
+					if(batch.playersToMove[game] == EPlayerColors::Type::BLACK_PLAYER)
+					{
+						players[lane] = batch.blackBitboards[game];
+						opponents[lane] = batch.whiteBitboards[game];
+						whiteToMove[lane] = ALL_ZERO;
+					}
+					else
+					{
+	#ifdef _WIN32
+						players[lane] = _byteswap_uint64(batch.whiteBitboards[game]);
+						opponents[lane] = _byteswap_uint64(batch.blackBitboards[game]);
+	#else
+						players[lane] = __builtin_bswap64(batch.whiteBitboards[game]);
+						opponents[lane] = __builtin_bswap64(batch.blackBitboards[game]);
+	#endif // _WIN32
+						whiteToMove[lane] = ALL_ONES;
+					}
+				}
+				else
+				{
+					group.games[lane] = -1;
+					group.activeLanes &= ~(1 << lane);
+					players[lane] = ALL_ZERO;
+					opponents[lane] = ALL_ZERO;
+				}
+			}
+
+			group.player = Lanes::load(players);
+			group.opponent = Lanes::load(opponents);
+			group.white = Lanes::load(whiteToMove);
+		}
+
+		/**
+		 * Plays out all games of the given batch with the given lane operations.
+		 * Every iteration advances BATCH_PLAYOUT_GROUPS independent groups of lanes, because a single ply is one long chain of
+		 * dependent instructions, so the processor can only overlap the plies of different groups
+		 */
+		template<typename Lanes>
+		void playoutKernel(Batch& batch)
+		{
+			typedef typename Lanes::Vector Vector;
+			const int NUM_LANES = Lanes::NUM_LANES;
+			LaneGroup<Lanes> groups[BATCH_PLAYOUT_GROUPS];
+			Vector wins[BATCH_PLAYOUT_GROUPS];
+
+			for(int groupIndex = 0; groupIndex < BATCH_PLAYOUT_GROUPS; ++groupIndex)
+			{
+				LaneGroup<Lanes>& group = groups[groupIndex];
+
+				for(int lane = 0; lane < NUM_LANES; ++lane)
+				{
+					group.games[lane] = -1;
+				}
+
+				group.randomState0 = Lanes::load(batch.randomStates[groupIndex][0]);
+				group.randomState1 = Lanes::load(batch.randomStates[groupIndex][1]);
+				group.white = Lanes::broadcast(ALL_ZERO);
+				group.activeLanes = 0;
+				refillGroup<Lanes>(group, (1 << NUM_LANES) - 1, Lanes::broadcast(ALL_ZERO), batch);
+			}
+
+			while(true)
+			{
+				int finishedLanes[BATCH_PLAYOUT_GROUPS];
+				int activeLanes = 0;
+
+				for(int groupIndex = 0; groupIndex < BATCH_PLAYOUT_GROUPS; ++groupIndex)
+				{
+					finishedLanes[groupIndex] = advanceGroup<Lanes>(groups[groupIndex], wins[groupIndex]);
+				}
+
+				for(int groupIndex = 0; groupIndex < BATCH_PLAYOUT_GROUPS; ++groupIndex)
+				{
+					LaneGroup<Lanes>& group = groups[groupIndex];
+
+					if(finishedLanes[groupIndex])
+					{
+						refillGroup<Lanes>(group, finishedLanes[groupIndex], wins[groupIndex], batch);
+					}
+					else
+					{
+						group.white = Lanes::bitXor(group.white, Lanes::broadcast(ALL_ONES));
+					}
+
+					activeLanes |= group.activeLanes;
+				}
+
+				if(!activeLanes)
+				{
+					break;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <inttypes.h>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "BatchPlayoutKernel.h"
+
+/**
+ * The vectorized kernel of the batched playouts. The project compiles this file with /arch:AVX2, which can be changed to
+ * /arch:AVX512 on processors that support it, and the widest lanes that the compiler supports are used. Only this file is
+ * compiled with that instruction set, so it includes nothing but BatchPlayoutKernel.h (see there), and BatchPlayout::playout()
+ * only calls it on processors that support the instruction set
+ */
+
+namespace BatchPlayoutKernel
+{
+	namespace
+	{
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+		/** Lane operations with AVX-512: 8 lanes */
+		struct Avx512Lanes
+		{
+			static const int NUM_LANES = 8;
+
+			typedef __m512i Vector;
+
+			static inline Vector load(const uint64_t* values) { return _mm512_loadu_si512((const void*)values); }
+			static inline void store(uint64_t* values, Vector a) { _mm512_storeu_si512((void*)values, a); }
+			static inline Vector broadcast(uint64_t value) { return _mm512_set1_epi64((long long)value); }
+			static inline Vector bitAnd(Vector a, Vector b) { return _mm512_and_si512(a, b); }
+			static inline Vector bitOr(Vector a, Vector b) { return _mm512_or_si512(a, b); }
+			static inline Vector bitXor(Vector a, Vector b) { return _mm512_xor_si512(a, b); }
+			static inline Vector andNot(Vector a, Vector b) { return _mm512_andnot_si512(b, a); }
+			static inline Vector add(Vector a, Vector b) { return _mm512_add_epi64(a, b); }
+			static inline Vector subtract(Vector a, Vector b) { return _mm512_sub_epi64(a, b); }
+			template<int SHIFT> static inline Vector shiftLeft(Vector a) { return _mm512_slli_epi64(a, SHIFT); }
+			template<int SHIFT> static inline Vector shiftRight(Vector a) { return _mm512_srli_epi64(a, SHIFT); }
+			static inline Vector rotateLeft(Vector a, Vector amounts) { return _mm512_rolv_epi64(a, amounts); }
+			static inline Vector rotateRight(Vector a, Vector amounts) { return _mm512_rorv_epi64(a, amounts); }
+
+			static inline Vector isZero(Vector a)
+			{
+				return _mm512_maskz_mov_epi64(_mm512_cmpeq_epi64_mask(a, _mm512_setzero_si512()), _mm512_set1_epi64(-1));
+			}
+
+			static inline Vector reverseBytes(Vector a)
+			{
+				const __m128i byteOrder = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+				return _mm512_shuffle_epi8(a, _mm512_broadcast_i32x4(byteOrder));
+			}
+
+			static inline int getLaneBits(Vector mask) { return (int)_mm512_test_epi64_mask(mask, mask); }
+		};
+#endif // defined(__AVX512F__) && defined(__AVX512BW__)
+
+#ifdef __AVX2__
+		/** Lane operations with AVX2: 4 lanes */
+		struct Avx2Lanes
+		{
+			static const int NUM_LANES = 4;
+
+			typedef __m256i Vector;
+
+			static inline Vector load(const uint64_t* values) { return _mm256_loadu_si256((const __m256i*)values); }
+			static inline void store(uint64_t* values, Vector a) { _mm256_storeu_si256((__m256i*)values, a); }
+			static inline Vector broadcast(uint64_t value) { return _mm256_set1_epi64x((long long)value); }
+			static inline Vector bitAnd(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+			static inline Vector bitOr(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+			static inline Vector bitXor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+			static inline Vector andNot(Vector a, Vector b) { return _mm256_andnot_si256(b, a); }
+			static inline Vector add(Vector a, Vector b) { return _mm256_add_epi64(a, b); }
+			static inline Vector subtract(Vector a, Vector b) { return _mm256_sub_epi64(a, b); }
+			template<int SHIFT> static inline Vector shiftLeft(Vector a) { return _mm256_slli_epi64(a, SHIFT); }
+			template<int SHIFT> static inline Vector shiftRight(Vector a) { return _mm256_srli_epi64(a, SHIFT); }
+
+			// variable shifts by 64 give 0, so rotating by 0 needs no special case
+			static inline Vector rotateLeft(Vector a, Vector amounts)
+			{
+				return _mm256_or_si256(_mm256_sllv_epi64(a, amounts), _mm256_srlv_epi64(a, _mm256_sub_epi64(_mm256_set1_epi64x(64), amounts)));
+			}
+
+			static inline Vector rotateRight(Vector a, Vector amounts)
+			{
+				return _mm256_or_si256(_mm256_srlv_epi64(a, amounts), _mm256_sllv_epi64(a, _mm256_sub_epi64(_mm256_set1_epi64x(64), amounts)));
+			}
+
+			static inline Vector isZero(Vector a) { return _mm256_cmpeq_epi64(a, _mm256_setzero_si256()); }
+
+			static inline Vector reverseBytes(Vector a)
+			{
+				const __m256i byteOrder = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+														   7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+				return _mm256_shuffle_epi8(a, byteOrder);
+			}
+
+			static inline int getLaneBits(Vector mask) { return _mm256_movemask_pd(_mm256_castsi256_pd(mask)); }
+		};
+#endif // __AVX2__
+	}
+}
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+const int BatchPlayoutKernel::VECTOR_LANES = 8;
+const EInstructionSet::Type BatchPlayoutKernel::VECTOR_INSTRUCTION_SET = EInstructionSet::Type::AVX512;
+#elif defined(__AVX2__)
+const int BatchPlayoutKernel::VECTOR_LANES = 4;
+const EInstructionSet::Type BatchPlayoutKernel::VECTOR_INSTRUCTION_SET = EInstructionSet::Type::AVX2;
+#else
+const int BatchPlayoutKernel::VECTOR_LANES = 4;
+const EInstructionSet::Type BatchPlayoutKernel::VECTOR_INSTRUCTION_SET = EInstructionSet::Type::SCALAR;
+#endif
+
+void BatchPlayoutKernel::playoutVector(Batch& batch)
+{
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+	playoutKernel<Avx512Lanes>(batch);
+#elif defined(__AVX2__)
+	playoutKernel<Avx2Lanes>(batch);
+#else
+	playoutKernel<ScalarLanes<4>>(batch);
+#endif
+}
\ No newline at end of file
@@ -39,10 +39,19 @@ namespace Bitboards
 	/** A constant representing 1's on the eighth row (labelled ''1'' in GUI) */
 	const uint64_t ROW_1 = ROW_2 << 8;
 
+	/** A constant representing 1's on the leftmost column (labelled ''A'' in GUI) */
+	const uint64_t FILE_A = 0x0101010101010101ULL;
+	/** A constant representing 1's on the second column (labelled ''B'' in GUI) */
+	const uint64_t FILE_B = FILE_A << 1;
+	/** A constant representing 1's on the seventh column (labelled ''G'' in GUI) */
+	const uint64_t FILE_G = FILE_A << 6;
+	/** A constant representing 1's on the rightmost column (labelled ''H'' in GUI) */
+	const uint64_t FILE_H = FILE_A << 7;
+
 	/** If a black piece is in this zone, and black is to move, he can win instantly */
-	const uint64_t DANGER_ZONE_BOTTOM = ROW_2 & ROW_3;
+	const uint64_t DANGER_ZONE_BOTTOM = ROW_2 | ROW_3;
 	/** If a white piece is in this zone, and white is to move, he can win instantly */
-	const uint64_t DANGER_ZONE_TOP = ROW_6 & ROW_7;
+	const uint64_t DANGER_ZONE_TOP = ROW_6 | ROW_7;
 
 	/**
 	 * Returns the index of the first bit that is set to 1 in the given bitset.
@@ -99,6 +108,30 @@ namespace Bitboards
 		return bitScanReverseIndices[(bitset * deBruijn64) >> 58];
 	}
 
+	/**
+	 * Returns the set of all squares that black knights on the given squares could move to, ignoring occupancy of the targets.
+	 * Black knights move down, which corresponds to increasing bit indices. Masks prevent moves from wrapping around the board edges.
+	 */
+	inline uint64_t blackKnightTargets(uint64_t knights)
+	{
+		return ((knights << 10) & ~(FILE_A | FILE_B)) |		// 2 right, 1 down
+			   ((knights << 6) & ~(FILE_G | FILE_H)) |		// 2 left, 1 down
+			   ((knights << 17) & ~FILE_A) |				// 1 right, 2 down
+			   ((knights << 15) & ~FILE_H);				// 1 left, 2 down
+	}
+
+	/**
+	 * Returns the set of all squares that white knights on the given squares could move to, ignoring occupancy of the targets.
+	 * White knights move up, which corresponds to decreasing bit indices. Masks prevent moves from wrapping around the board edges.
+	 */
+	inline uint64_t whiteKnightTargets(uint64_t knights)
+	{
+		return ((knights >> 6) & ~(FILE_A | FILE_B)) |		// 2 right, 1 up
+			   ((knights >> 10) & ~(FILE_G | FILE_H)) |		// 2 left, 1 up
+			   ((knights >> 15) & ~FILE_A) |				// 1 right, 2 up
+			   ((knights >> 17) & ~FILE_H);				// 1 left, 2 up
+	}
+
 	/** 
 	 * Initializes an array of 64 bitsets where bitset[i] is the set with only bit i set. 
 	 * Array is allocated on heap, memory is not de-allocated!
@@ -131,6 +164,27 @@ namespace Bitboards
 		return (bitset & singleBit(bitIndex));
 	}
 
+	/** Returns true iff exactly one bit is set in the given bitset */
+	inline bool isSingleBit(uint64_t bitset)
+	{
+		return (bitset != ALL_ZERO && (bitset & (bitset - 1)) == ALL_ZERO);
+	}
+
+	/**
+	 * Returns the number of bits that are set to 1 in the given bitset
+	 *
+	 * Implementation uses the SWAR population count (see link below for references), which compilers recognize and replace
+	 * by a single instruction where available.
+	 * Implementation adapted from: https://chessprogramming.wikispaces.com/Population+Count#SWAR-Popcount
+	 */
+	inline int popCount(uint64_t bitset)
+	{
+		bitset = bitset - ((bitset >> 1) & 0x5555555555555555ULL);
+		bitset = (bitset & 0x3333333333333333ULL) + ((bitset >> 2) & 0x3333333333333333ULL);
+		bitset = (bitset + (bitset >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+		return (int)((bitset * 0x0101010101010101ULL) >> 56);
+	}
+
 	/** Sets the bit at the given index in the given bitset and returns the result */
 	inline uint64_t setBit(uint64_t bitset, int bitIndex)
 	{
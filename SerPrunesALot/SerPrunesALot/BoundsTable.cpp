@@ -0,0 +1,165 @@
+#define NOMINMAX
+
+#include <algorithm>
+
+#include "BoundsTable.h"
+#include "MathConstants.h"
+#include "Options.h"
+
+BoundsData::BoundsData()
+	: bestMove(INVALID_MOVE),
+	hashValue(0),
+	lowerBound(MathConstants::LOW_ENOUGH_INT),
+	upperBound(MathConstants::LARGE_ENOUGH_INT),
+	depth(0)
+{}
+
+bool BoundsData::isValid() const
+{
+	return (lowerBound != MathConstants::LOW_ENOUGH_INT || upperBound != MathConstants::LARGE_ENOUGH_INT);
+}
+
+BoundsTable::BoundsTable() : numEntriesUsed(0), numReplacementsRequired(0)
+{
+	table = new BoundsEntry[TRANSPOSITION_TABLE_NUM_ENTRIES]();
+}
+
+BoundsTable::~BoundsTable()
+{
+	delete[] table;
+}
+
+void BoundsTable::clear()
+{
+	numEntriesUsed = 0;
+	numReplacementsRequired = 0;
+	delete[] table;
+	table = new BoundsEntry[TRANSPOSITION_TABLE_NUM_ENTRIES]();
+}
+
+const BoundsData& BoundsTable::retrieve(uint64_t zobrist) const
+{
+	HashValue zobristHash = HashValue(zobrist);
+	uint64_t index = zobristHash.hashCodes.primary;
+
+	BoundsEntry* entry = table + index;
+
+	if(entry->data1.hashValue == zobristHash && entry->data1.isValid())			// first element is the correct data
+	{
+		return entry->data1;
+	}
+	else if(entry->data2.hashValue == zobristHash && entry->data2.isValid())	// second element is the correct data
+	{
+		return entry->data2;
+	}
+	else
+	{
+		return INVALID_BOUNDS_DATA;
+	}
+}
+
+void BoundsTable::storeBounds(Move bestMove, uint64_t zobrist, int lowerBound, int upperBound, int depth)
+{
+	HashValue zobristHash = HashValue(zobrist);
+	uint64_t index = zobristHash.hashCodes.primary;
+
+	BoundsEntry* entry = table + index;
+
+	// fetch references to the two chunks of data we have in this table entry
+	BoundsData& data1 = entry->data1;
+	BoundsData& data2 = entry->data2;
+
+	// first check if one of them already contains data for this node
+	BoundsData* existing = nullptr;
+
+	if(data1.hashValue == zobristHash && data1.isValid())
+	{
+		existing = &data1;
+	}
+	else if(data2.hashValue == zobristHash && data2.isValid())
+	{
+		existing = &data2;
+	}
+
+	if(existing)
+	{
+		if(depth > existing->depth)				// deeper search, so old bounds are no longer relevant
+		{
+			overwrite(*existing, bestMove, zobristHash, lowerBound, upperBound, depth);
+		}
+		else if(depth == existing->depth)		// same search depth, so combine the bounds
+		{
+			if(lowerBound > existing->lowerBound)
+			{
+				existing->lowerBound = lowerBound;
+				existing->bestMove = bestMove;	// the move that raised the lower bound is the most informative move to try first
+			}
+
+			existing->upperBound = std::min(existing->upperBound, upperBound);
+
+			if(existing->bestMove == INVALID_MOVE)
+			{
+				existing->bestMove = bestMove;
+			}
+		}
+
+		return;
+	}
+
+#ifdef GATHER_STATISTICS
+	// did not search existing game state before, so hopefully we'll use a new entry
+	numEntriesUsed++;
+#endif // GATHER_STATISTICS
+
+	// now check if one of the slots in the entry is still empty, and if so, use that
+	if(!data1.isValid())
+	{
+		overwrite(data1, bestMove, zobristHash, lowerBound, upperBound, depth);
+		return;
+	}
+	else if(!data2.isValid())
+	{
+		overwrite(data2, bestMove, zobristHash, lowerBound, upperBound, depth);
+		return;
+	}
+
+#ifdef GATHER_STATISTICS
+	// did not manage to use a new entry, so we'll have to replace something
+	numEntriesUsed--;
+	numReplacementsRequired++;
+#endif // GATHER_STATISTICS
+
+	// both slots already filled, so replace whichever has the lowest depth
+	if(data1.depth < data2.depth)				// slot 1 searched less deep than slot 2, so replace that
+	{
+		overwrite(data1, bestMove, zobristHash, lowerBound, upperBound, depth);
+	}
+	else if(data2.depth < data1.depth)			// slot 2 searched less deep than slot 1, so replace that
+	{
+		overwrite(data2, bestMove, zobristHash, lowerBound, upperBound, depth);
+	}
+	else			// both existing slots have equal search depth, move data from 1 to 2 and then replace 1
+	{
+		overwrite(data2, data1.bestMove, data1.hashValue, data1.lowerBound, data1.upperBound, data1.depth);
+		overwrite(data1, bestMove, zobristHash, lowerBound, upperBound, depth);
+	}
+}
+
+int BoundsTable::getNumEntriesUsed() const
+{
+	return numEntriesUsed;
+}
+
+int BoundsTable::getNumReplacementsRequired() const
+{
+	return numReplacementsRequired;
+}
+
+void BoundsTable::overwrite(BoundsData& data, Move bestMove, HashValue hashValue, int lowerBound, int upperBound, int depth)
+{
+	data.bestMove = bestMove;
+	data.hashValue = hashValue;
+	data.lowerBound = lowerBound;
+	data.upperBound = upperBound;
+	data.depth = depth;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "Move.h"
+#include "TranspositionTable.h"
+
+/**
+ * Contains the data for a single node of the game tree to be stored in the Bounds Table.
+ *
+ * Unlike TableData, which stores a single value that is either exact or a bound, this stores both a lower
+ * and an upper bound on the value of the node. Zero-window searches that re-visit a node with a different window
+ * (such as the consecutive passes of MTD(f)) can then tighten both bounds independently, until they meet.
+ */
+struct BoundsData
+{
+public:
+	BoundsData::BoundsData();
+
+	Move bestMove;
+	HashValue hashValue;
+	int lowerBound;
+	int upperBound;
+	uint8_t depth;
+
+	/**
+	 * Returns true iff the data is valid.
+	 * Data is considered to be valid iff at least one of the bounds is known
+	 */
+	bool isValid() const;
+
+private:
+	// don't want accidental copying of the Bounds Data
+	BoundsData(const BoundsData&);
+	BoundsData& operator=(const BoundsData&);
+};
+
+/**
+ * An entry in the Bounds Table.
+ *
+ * Uses the same Two-Deep replacement scheme as the entries in the Transposition Table.
+ */
+struct BoundsEntry
+{
+	BoundsData data1;
+	BoundsData data2;
+};
+
+/**
+ * A table storing both a lower and an upper bound for every node, as required by memory-enhanced test algorithms like MTD(f).
+ *
+ * Uses the same hashing scheme and number of entries as the Transposition Table.
+ */
+class BoundsTable
+{
+public:
+	BoundsTable();
+	~BoundsTable();
+
+	/** Clears the bounds table */
+	void clear();
+
+	/**
+	 * Returns the number of entries that was used.
+	 * Only returns a meaningful number if GATHER_STATISTICS is defined
+	 */
+	int getNumEntriesUsed() const;
+
+	/**
+	 * Returns the number of entries that were overwritten by data for a new game state.
+	 * Only returns a meaningful number if GATHER_STATISTICS is defined
+	 */
+	int getNumReplacementsRequired() const;
+
+	/**
+	 * Retrieves the data corresponding to the given zobrist hash value in the Bounds Table
+	 * Data is returned by const reference, and cannot be copied!
+	 *
+	 * Will return data that returns false for isValid() if no data was found with the correct key
+	 */
+	const BoundsData& retrieve(uint64_t zobrist) const;
+
+	/**
+	 * Stores the result of a search of the given depth, where the value of the node was found to lie within [lowerBound, upperBound].
+	 * Unknown bounds should be passed as MathConstants::LOW_ENOUGH_INT or MathConstants::LARGE_ENOUGH_INT.
+	 *
+	 * If data for the same node and depth is already stored, the bounds are combined. Data of deeper searches replaces
+	 * data of shallower searches, and data of shallower searches for a node that is already in the table is ignored.
+	 */
+	void storeBounds(Move bestMove, uint64_t zobrist, int lowerBound, int upperBound, int depth);
+
+private:
+	BoundsEntry* table;
+
+	int numEntriesUsed;
+	int numReplacementsRequired;
+
+	/** Overwrites the given data with the given new data */
+	static void overwrite(BoundsData& data, Move bestMove, HashValue hashValue, int lowerBound, int upperBound, int depth);
+
+	// don't want accidental copying of the Bounds Table
+	BoundsTable(const BoundsTable&);
+	BoundsTable& operator=(const BoundsTable&);
+};
+
+// invalid bounds data
+static BoundsData INVALID_BOUNDS_DATA;
@@ -0,0 +1,293 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <vector>
+
+#include "DfpnSolver.h"
+#include "Logger.h"
+#include "RaceDetector.h"
+#include "SearchCore.h"
+
+/**
+ * The evaluation corresponding to a won game.
+ * The solver does not know the distance to the wins it proves, so they are reported as the slowest win that is still
+ * recognized as a win (see SearchCore::isWinScore())
+ */
+#define WIN_EVALUATION 1900
+
+/** The maximum number of moves in a single game state: 16 knights with at most 4 moves each */
+#define DFPN_MAX_MOVES (16 * 4)
+
+DfpnSolver::DfpnSolver()
+	: dfpnTable(),
+	clock(),
+	lastRootEvaluation(0),
+	activeSearchControl(nullptr),
+	nodesVisited(0),
+	maxNodesVisited(0),
+	terminated(false),
+	totalNodesVisited(0),
+	totalTimeSpent(0.0),
+	turnsPlayed(0)
+{
+}
+
+Move DfpnSolver::chooseMove(GameState& gameState)
+{
+	// unlike the alpha-beta engines, proof and disproof numbers only depend on the position, so the table is not cleared
+	clock.start();
+	searchControl.startSearch(0, (searchLimits.maxTimeMs > 0) ? searchLimits.maxTimeMs : MAX_SEARCH_TIME_MS, searchLimits.maxNodes);
+
+	if(gameState.getWinner() != EPlayerColors::Type::NOTHING)
+	{
+		return INVALID_MOVE;		// can't return any normal move if game already ended
+	}
+
+	Move bestMove = INVALID_MOVE;
+	EProofResult::Type result = solve(gameState, searchControl, 0, bestMove);
+
+	if(result == EProofResult::Type::PROVEN_WIN)
+	{
+		lastRootEvaluation = SearchCore::getWinScore(MAX_WIN_DISTANCE - 1, WIN_EVALUATION);
+	}
+	else if(result == EProofResult::Type::PROVEN_LOSS)
+	{
+		lastRootEvaluation = -SearchCore::getWinScore(MAX_WIN_DISTANCE - 1, WIN_EVALUATION);
+	}
+	else
+	{
+		lastRootEvaluation = 0;
+	}
+
+	clock.stop();
+	reportIteration(0, lastRootEvaluation, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+
+#ifdef GATHER_STATISTICS
+#ifdef LOG_STATS_PER_TURN
+	if(gameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		LOG_MESSAGE(StringBuilder() << "DFPN Solver engine searching move for Black Player")
+	}
+	else
+	{
+		LOG_MESSAGE(StringBuilder() << "DFPN Solver engine searching move for White Player")
+	}
+
+	LOG_MESSAGE(StringBuilder() << "Result (0 = win, 1 = loss, 2 = unknown):	" << result)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << nodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << clock.getElapsedTimeInMilliSec() << " ms")
+	LOG_MESSAGE(StringBuilder() << "DFPN Table replacements:			" << dfpnTable.getNumReplacementsRequired())
+	LOG_MESSAGE("")
+#endif // LOG_STATS_PER_TURN
+
+#ifdef LOG_STATS_END_OF_MATCH
+	totalNodesVisited += nodesVisited;
+	totalTimeSpent += clock.getElapsedTimeInMilliSec();
+	++turnsPlayed;
+#endif // LOG_STATS_END_OF_MATCH
+#endif // GATHER_STATISTICS
+
+	return bestMove;
+}
+
+EProofResult::Type DfpnSolver::solve(GameState& gameState, SearchControl& control, int64_t maxNodes, Move& bestMove)
+{
+	activeSearchControl = &control;
+	nodesVisited = 0;
+	maxNodesVisited = (maxNodes > 0) ? maxNodes : INT64_MAX;
+	terminated = false;
+
+	// the root is searched until it is either proven or disproven, or the search is terminated
+	uint32_t proofNumber = 1;
+	uint32_t disproofNumber = 1;
+	search(gameState, DFPN_INFINITY, DFPN_INFINITY, proofNumber, disproofNumber, bestMove);
+
+	if(proofNumber == 0)
+	{
+		return EProofResult::Type::PROVEN_WIN;
+	}
+	else if(disproofNumber == 0)
+	{
+		return EProofResult::Type::PROVEN_LOSS;
+	}
+
+	return EProofResult::Type::UNKNOWN;
+}
+
+int64_t DfpnSolver::getNodesVisited() const
+{
+	return nodesVisited;
+}
+
+double DfpnSolver::getSecondsSearched()
+{
+	return clock.getElapsedTimeInSec();
+}
+
+void DfpnSolver::search(GameState& gameState, uint32_t proofThreshold, uint32_t disproofThreshold,
+						uint32_t& proofNumber, uint32_t& disproofNumber, Move& bestMove)
+{
+	int64_t nodesAtStart = nodesVisited;
+	++nodesVisited;
+
+	if(activeSearchControl->visitNode() || nodesVisited > maxNodesVisited)
+	{
+		terminated = true;
+	}
+
+	// generate all children once, and keep their proof and disproof numbers here, so that they are not lost if the
+	// table entries of the children are replaced by their own subtrees
+	std::vector<Move> moves;
+	moves.reserve(DFPN_MAX_MOVES);
+	uint64_t childZobrists[DFPN_MAX_MOVES];
+	uint32_t childProofNumbers[DFPN_MAX_MOVES];
+	uint32_t childDisproofNumbers[DFPN_MAX_MOVES];
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)));
+
+	Move m = moveGenerator.nextMove();
+
+	while(!(m == INVALID_MOVE))
+	{
+		childZobrists[moves.size()] = gameState.getZobristAfterMove(m);
+		dfpnTable.prefetch(childZobrists[moves.size()]);
+		moves.push_back(m);
+		m = moveGenerator.nextMove();
+	}
+
+	int numMoves = (int)moves.size();
+
+	for(int i = 0; i < numMoves; ++i)
+	{
+		initChild(gameState, moves[i], childZobrists[i], childProofNumbers[i], childDisproofNumbers[i]);
+	}
+
+	while(true)
+	{
+		// we win if any child loses, and lose if all children win
+		proofNumber = DFPN_INFINITY;
+		disproofNumber = 0;
+		uint32_t secondBestDisproofNumber = DFPN_INFINITY;
+		int bestChild = 0;
+
+		for(int i = 0; i < numMoves; ++i)
+		{
+			if(childDisproofNumbers[i] < proofNumber)
+			{
+				secondBestDisproofNumber = proofNumber;
+				proofNumber = childDisproofNumbers[i];
+				bestChild = i;
+			}
+			else if(childDisproofNumbers[i] < secondBestDisproofNumber)
+			{
+				secondBestDisproofNumber = childDisproofNumbers[i];
+			}
+
+			disproofNumber = std::min(disproofNumber + childProofNumbers[i], (uint32_t)DFPN_INFINITY);
+		}
+
+		if(proofNumber != 0 && disproofNumber >= DFPN_INFINITY)
+		{
+			disproofNumber = DFPN_INFINITY - 1;		// a large sum does not disprove anything, only a proven win of a child does
+		}
+
+		bestMove = (numMoves > 0) ? moves[bestChild] : INVALID_MOVE;
+
+		if(terminated || proofNumber >= proofThreshold || disproofNumber >= disproofThreshold)
+		{
+			break;
+		}
+
+		// the most-proving child gets the thresholds at which it stops being the most-proving child, or at which this node
+		// exceeds one of its own thresholds
+		uint32_t childProofThreshold = std::min(disproofThreshold - disproofNumber + childProofNumbers[bestChild], (uint32_t)DFPN_INFINITY);
+		uint32_t childDisproofThreshold = std::min(proofThreshold, secondBestDisproofNumber + 1);
+
+		Move childBestMove = INVALID_MOVE;
+		const Move& move = moves[bestChild];
+		gameState.applyMove(move);
+		search(gameState, childProofThreshold, childDisproofThreshold, childProofNumbers[bestChild], childDisproofNumbers[bestChild], childBestMove);
+		gameState.undoMove(move);
+	}
+
+	if(!terminated)
+	{
+		uint32_t work = (uint32_t)std::min(nodesVisited - nodesAtStart, (int64_t)UINT32_MAX);
+		dfpnTable.store(gameState.getZobrist(), proofNumber, disproofNumber, work);
+	}
+}
+
+void DfpnSolver::initChild(GameState& gameState, const Move& move, uint64_t childZobrist, uint32_t& proofNumber, uint32_t& disproofNumber)
+{
+	if(dfpnTable.retrieve(childZobrist, proofNumber, disproofNumber))
+	{
+		return;
+	}
+
+	gameState.applyMove(move);
+	evaluateLeaf(gameState, proofNumber, disproofNumber);
+	gameState.undoMove(move);
+}
+
+void DfpnSolver::evaluateLeaf(const GameState& gameState, uint32_t& proofNumber, uint32_t& disproofNumber)
+{
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	bool won = false;
+	bool lost = false;
+
+	if(gameState.getWinner() != EPlayerColors::Type::NOTHING)		// the game can only have been won by the player who just moved
+	{
+		lost = true;
+	}
+	else if(gameState.getBitboard(currentPlayer) & MoveGenerator::getDangerZone(currentPlayer))		// can move to the goal row right away
+	{
+		won = true;
+	}
+#ifdef USE_RACE_DETECTION
+	else
+	{
+		int racePlies = RaceDetector::detectRace(gameState);
+		won = (racePlies > 0);
+		lost = (racePlies < 0);
+	}
+#endif // USE_RACE_DETECTION
+
+	if(won)
+	{
+		proofNumber = 0;
+		disproofNumber = DFPN_INFINITY;
+	}
+	else if(lost)
+	{
+		proofNumber = DFPN_INFINITY;
+		disproofNumber = 0;
+	}
+	else
+	{
+		proofNumber = 1;
+		disproofNumber = 1;
+	}
+}
+
+int DfpnSolver::getRootEvaluation()
+{
+	return lastRootEvaluation;
+}
+
+int DfpnSolver::getWinEvaluation()
+{
+	return WIN_EVALUATION;
+}
+
+void DfpnSolver::logEndOfMatchStats()
+{
+#ifdef LOG_STATS_END_OF_MATCH
+	LOG_MESSAGE("DFPN Solver engine END OF GAME stats:")
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << totalNodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << totalTimeSpent << " ms")
+	LOG_MESSAGE("")
+#endif // LOG_STATS_END_OF_MATCH
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "AiEngine.h"
+#include "DfpnTable.h"
+#include "Timer.hpp"
+
+/** The results that the DFPN solver can prove */
+namespace EProofResult
+{
+	enum Type
+	{
+		PROVEN_WIN,
+		PROVEN_LOSS,
+		UNKNOWN
+	};
+}
+
+/**
+ * Engine using Depth-First Proof-Number search (df-pn). Rather than evaluating positions, it tries to prove whether the
+ * player to move wins or loses, and is therefore mostly useful in endgames.
+ *
+ * Proof-number search always expands the most-proving node: the leaf node that contributes the most to the proof (or
+ * disproof) of the root, as measured by the proof and disproof numbers. df-pn finds that node with a depth-first search,
+ * which only returns from a subtree once its proof or disproof number exceeds a threshold set by its parent, and stores the
+ * proof and disproof numbers of searched nodes in a DFPN Table with a fixed size. Knights only ever move forwards, so the
+ * game tree is finite and acyclic, and df-pn does not need any special treatment of cycles here.
+ *
+ * In contrast to alpha-beta, df-pn does not need a depth limit, and spends its effort on the moves that are the easiest to
+ * prove or refute. It proves long, narrow wins far faster than alpha-beta can, but proves nothing about the distance to the
+ * win, and cannot say anything about positions that are not decided within its budget.
+ */
+class DfpnSolver : public AiEngine
+{
+public:
+	DfpnSolver::DfpnSolver();
+
+	virtual Move chooseMove(GameState& gameState);
+
+	/**
+	 * Tries to prove whether the player to move in the given game state wins or loses. The game must not be over yet.
+	 * Visits at most maxNodes nodes (0 = no limit), and calls visitNode() of the given search control for every node,
+	 * such that the search also stops as soon as the given search control says so.
+	 *
+	 * Stores the move to play in bestMove: a winning move if a win was proven, or otherwise the most promising move.
+	 */
+	EProofResult::Type solve(GameState& gameState, SearchControl& control, int64_t maxNodes, Move& bestMove);
+
+	/** Returns the number of nodes visited by the last call to solve() */
+	int64_t getNodesVisited() const;
+
+	/** Returns the number of seconds spent searching last time */
+	double getSecondsSearched();
+
+	virtual int getRootEvaluation();
+	virtual int getWinEvaluation();
+	virtual void logEndOfMatchStats();
+
+private:
+	/** The engine's DFPN Table */
+	DfpnTable dfpnTable;
+
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
+	Timer clock;
+
+	/** The evaluation of the root node during the last search */
+	int lastRootEvaluation;
+
+	/** The default amount of time in milliseconds that the solver may spend on a single move */
+	const int MAX_SEARCH_TIME_MS = 30000;
+
+	/** The search control of the current call to solve() */
+	SearchControl* activeSearchControl;
+	/** The number of nodes visited by the current call to solve() */
+	int64_t nodesVisited;
+	/** The maximum number of nodes that the current call to solve() may visit */
+	int64_t maxNodesVisited;
+	/** Set as soon as the current call to solve() must be terminated */
+	bool terminated;
+
+	// variables used for gathering and logging statistics
+	int64_t totalNodesVisited;
+	double totalTimeSpent;
+	int turnsPlayed;
+
+	/**
+	 * Searches the given game state until its proof number reaches at least proofThreshold, or its disproof number at least
+	 * disproofThreshold. Returns the node's proof and disproof numbers through the output arguments, and the move leading
+	 * to the child with the lowest disproof number through bestMove.
+	 */
+	void search(GameState& gameState, uint32_t proofThreshold, uint32_t disproofThreshold,
+				uint32_t& proofNumber, uint32_t& disproofNumber, Move& bestMove);
+
+	/**
+	 * Computes the initial proof and disproof numbers of the child (with the given zobrist hash value) reached by playing the
+	 * given move in the given game state. Uses the numbers stored in the DFPN Table if available, or otherwise evaluates the
+	 * child as a new leaf node.
+	 */
+	void initChild(GameState& gameState, const Move& move, uint64_t childZobrist, uint32_t& proofNumber, uint32_t& disproofNumber);
+
+	/** Computes the proof and disproof numbers of the given game state as a new leaf node, recognizing positions that are already decided */
+	static void evaluateLeaf(const GameState& gameState, uint32_t& proofNumber, uint32_t& disproofNumber);
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <xmmintrin.h>
+
+#include "DfpnTable.h"
+#include "Options.h"
+
+DfpnTable::DfpnTable() : numReplacementsRequired(0)
+{
+	table = new DfpnEntry[DFPN_TABLE_NUM_ENTRIES]();
+}
+
+DfpnTable::~DfpnTable()
+{
+	delete[] table;
+}
+
+void DfpnTable::clear()
+{
+	numReplacementsRequired = 0;
+	delete[] table;
+	table = new DfpnEntry[DFPN_TABLE_NUM_ENTRIES]();
+}
+
+bool DfpnTable::retrieve(uint64_t zobrist, uint32_t& proofNumber, uint32_t& disproofNumber) const
+{
+	const DfpnEntry* entry = table + (zobrist & (DFPN_TABLE_NUM_ENTRIES - 1));
+	const DfpnData* data = nullptr;
+
+	if(entry->data1.zobrist == zobrist)			// first element is the correct data
+	{
+		data = &entry->data1;
+	}
+	else if(entry->data2.zobrist == zobrist)	// second element is the correct data
+	{
+		data = &entry->data2;
+	}
+	else
+	{
+		return false;
+	}
+
+	proofNumber = data->proofNumber;
+	disproofNumber = data->disproofNumber;
+	return true;
+}
+
+void DfpnTable::prefetch(uint64_t zobrist) const
+{
+	_mm_prefetch(reinterpret_cast<const char*>(table + (zobrist & (DFPN_TABLE_NUM_ENTRIES - 1))), _MM_HINT_T0);
+}
+
+void DfpnTable::store(uint64_t zobrist, uint32_t proofNumber, uint32_t disproofNumber, uint32_t work)
+{
+	DfpnEntry* entry = table + (zobrist & (DFPN_TABLE_NUM_ENTRIES - 1));
+	DfpnData* data = nullptr;
+
+	if(entry->data1.zobrist == zobrist || entry->data1.zobrist == 0)		// same node, or empty slot
+	{
+		data = &entry->data1;
+	}
+	else if(entry->data2.zobrist == zobrist || entry->data2.zobrist == 0)
+	{
+		data = &entry->data2;
+	}
+	else
+	{
+#ifdef GATHER_STATISTICS
+		++numReplacementsRequired;
+#endif // GATHER_STATISTICS
+
+		// both slots filled with other nodes, so replace whichever took the least work
+		data = (entry->data1.work <= entry->data2.work) ? &entry->data1 : &entry->data2;
+	}
+
+	data->zobrist = zobrist;
+	data->proofNumber = proofNumber;
+	data->disproofNumber = disproofNumber;
+	data->work = work;
+}
+
+int64_t DfpnTable::getNumReplacementsRequired() const
+{
+	return numReplacementsRequired;
+}
\ No newline at end of file
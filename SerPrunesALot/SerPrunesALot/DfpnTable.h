@@ -0,0 +1,89 @@
+#pragma once
+
+#include <inttypes.h>
+
+/**
+ * The number of entries in the DFPN Table. Must be a power of 2.
+ * Every entry holds two nodes, so the table stores at most twice this number of nodes
+ */
+#define DFPN_TABLE_NUM_ENTRIES (1 << 20)
+
+/** Proof and disproof numbers of proven and disproven nodes. Sums of proof numbers are capped at this value */
+#define DFPN_INFINITY (1 << 28)
+
+/**
+ * Contains the data for a single node of the game tree to be stored in the DFPN Table.
+ *
+ * The proof number is the minimum number of leaf nodes that would have to be proven to prove that the player to move wins,
+ * and the disproof number the minimum number of leaf nodes that would have to be proven to prove that it loses.
+ */
+struct DfpnData
+{
+	DfpnData() : zobrist(0), proofNumber(1), disproofNumber(1), work(0) {}
+
+	/** The full Zobrist hash value of the node. 0 = empty slot */
+	uint64_t zobrist;
+	/** The proof number. 0 = proven win for the player to move */
+	uint32_t proofNumber;
+	/** The disproof number. 0 = proven loss for the player to move */
+	uint32_t disproofNumber;
+	/** The number of nodes visited by the search that produced this data. Nodes that took more work are more valuable to keep */
+	uint32_t work;
+};
+
+/**
+ * An entry in the DFPN Table.
+ *
+ * If both slots are filled, the node that took the least work to search is replaced.
+ */
+struct DfpnEntry
+{
+	DfpnData data1;
+	DfpnData data2;
+};
+
+/**
+ * A table storing the proof and disproof numbers of nodes searched by the DFPN solver.
+ *
+ * The table has a fixed size, so that the solver can run for a long time without running out of memory: as the table fills
+ * up, nodes that took little work to search are replaced, and will have to be searched again if they turn out to be needed.
+ */
+class DfpnTable
+{
+public:
+	DfpnTable();
+	~DfpnTable();
+
+	/** Clears the DFPN table */
+	void clear();
+
+	/**
+	 * Retrieves the proof and disproof numbers of the node with the given zobrist hash value.
+	 * Returns false, and leaves the output arguments unchanged, if no data was found for the node.
+	 */
+	bool retrieve(uint64_t zobrist, uint32_t& proofNumber, uint32_t& disproofNumber) const;
+
+	/**
+	 * Starts loading the entry of the node with the given zobrist hash value into the cache, without waiting for it.
+	 * Nodes have many children that are all looked up at once, so this hides most of the latency of those look ups
+	 */
+	void prefetch(uint64_t zobrist) const;
+
+	/** Stores the proof and disproof numbers of the node with the given zobrist hash value, found by searching the given number of nodes */
+	void store(uint64_t zobrist, uint32_t proofNumber, uint32_t disproofNumber, uint32_t work);
+
+	/**
+	 * Returns the number of nodes that were overwritten by data for a different node.
+	 * Only returns a meaningful number if GATHER_STATISTICS is defined
+	 */
+	int64_t getNumReplacementsRequired() const;
+
+private:
+	DfpnEntry* table;
+
+	int64_t numReplacementsRequired;
+
+	// don't want accidental copying of the DFPN Table
+	DfpnTable(const DfpnTable&);
+	DfpnTable& operator=(const DfpnTable&);
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "AspirationSearch.h"
+#include "EngineComparison.h"
+#include "Logger.h"
+#include "MTDf.h"
+#include "SearchHandle.h"
+
+/** Depth of the search used to generate the fixed position set */
+#define POSITION_SET_SEARCH_DEPTH 4
+
+std::vector<std::vector<Move>> EngineComparison::generatePositionSet(int numPositions)
+{
+	std::vector<std::vector<Move>> positions;
+	positions.reserve(numPositions);
+
+	GameState gameState;
+	gameState.reset();
+
+	AspirationSearch engine;
+	SearchLimits limits;
+	limits.maxDepth = POSITION_SET_SEARCH_DEPTH;
+
+	std::vector<Move> movesPlayed;
+
+	while(positions.size() < numPositions && gameState.getWinner() == EPlayerColors::Type::NOTHING)
+	{
+		positions.push_back(movesPlayed);
+
+		SearchHandle* search = engine.start(gameState, limits);
+		Move move = search->wait();
+		delete search;
+
+		gameState.applyMove(move);
+		movesPlayed.push_back(move);
+	}
+
+	return positions;
+}
+
+void EngineComparison::setUpPosition(GameState& gameState, const std::vector<Move>& moves)
+{
+	gameState.reset();
+
+	for(const Move& move : moves)
+	{
+		gameState.applyMove(move);
+	}
+}
+
+void EngineComparison::compareMtdfWithAspirationSearch(int depth, int numPositions)
+{
+	std::vector<std::vector<Move>> positions = generatePositionSet(numPositions);
+
+	AspirationSearch aspirationSearch;
+	MTDf mtdf;
+
+	// Aspiration Search does not use null-move pruning, which changes the scores that MTD(f) converges to (at depth 5 on the
+	// first 6 positions, 4 of them score 0 with it instead of 70), so it is disabled to compare both engines on equal terms
+	mtdf.setNullMovePruning(false);
+
+	SearchLimits limits;
+	limits.maxDepth = depth;
+
+	int64_t totalNodesAspirationSearch = 0;
+	int64_t totalNodesMtdf = 0;
+	int totalPasses = 0;
+	int totalIterations = 0;
+
+	LOG_MESSAGE(StringBuilder() << "Comparing MTD(f) with Aspiration Search on " << positions.size() << " positions, depth = " << depth)
+
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		GameState gameState;
+		setUpPosition(gameState, positions[i]);
+
+		SearchIterationInfo aspirationSearchInfo;
+		SearchHandle* search = aspirationSearch.start(gameState, limits, [&aspirationSearchInfo](const SearchIterationInfo& info){ aspirationSearchInfo = info; });
+		search->wait();
+		delete search;
+
+		SearchIterationInfo mtdfInfo;
+		search = mtdf.start(gameState, limits, [&mtdfInfo](const SearchIterationInfo& info){ mtdfInfo = info; });
+		search->wait();
+		delete search;
+
+		std::string passesString;
+		for(int passes : mtdf.getPassesPerIteration())
+		{
+			passesString += (StringBuilder() << passes << " ").getString();
+			totalPasses += passes;
+			++totalIterations;
+		}
+
+		totalNodesAspirationSearch += aspirationSearchInfo.nodes;
+		totalNodesMtdf += mtdfInfo.nodes;
+
+		LOG_MESSAGE(StringBuilder() << "Position " << i << ":	Aspiration Search nodes = " << aspirationSearchInfo.nodes << " (score " << aspirationSearchInfo.score
+									<< "),	MTD(f) nodes = " << mtdfInfo.nodes << " (score " << mtdfInfo.score << "),	MTD(f) passes per iteration = " << passesString)
+	}
+
+	LOG_MESSAGE(StringBuilder() << "Total Aspiration Search nodes:		" << totalNodesAspirationSearch)
+	LOG_MESSAGE(StringBuilder() << "Total MTD(f) nodes:			" << totalNodesMtdf)
+	LOG_MESSAGE(StringBuilder() << "Average MTD(f) passes per iteration:	" << ((totalIterations > 0) ? ((double)totalPasses / totalIterations) : 0.0))
+	LOG_MESSAGE("")
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "AiEngine.h"
+#include "GameState.h"
+#include "Move.h"
+
+/**
+ * Headless tools to compare AI engines on a fixed set of positions.
+ * Results are written to the log.
+ */
+namespace EngineComparison
+{
+	/**
+	 * Generates a fixed set of positions, by letting a shallow fixed-depth search play against itself from the initial position.
+	 * Every position is returned as the sequence of moves leading to it from the initial position.
+	 */
+	std::vector<std::vector<Move>> generatePositionSet(int numPositions);
+
+	/** Sets up the given game state in the position reached by playing the given moves from the initial position */
+	void setUpPosition(GameState& gameState, const std::vector<Move>& moves);
+
+	/**
+	 * Searches every position of the fixed position set with both engines to the given depth,
+	 * and logs the number of nodes visited by both engines, and the number of MTD(f) passes per iteration.
+	 * MTD(f) searches without null-move pruning, because Aspiration Search does not use it either
+	 */
+	void compareMtdfWithAspirationSearch(int depth, int numPositions);
+}
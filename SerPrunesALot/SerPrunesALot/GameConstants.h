@@ -7,4 +7,18 @@
 #define BOARD_WIDTH 8
 #define BOARD_HEIGHT 8
 
-#define NUM_PLAYERS 2
\ No newline at end of file
+#define NUM_PLAYERS 2
+
+/** Possible colors that players can have */
+namespace EPlayerColors
+{
+	enum Type
+	{
+		NOTHING,
+
+		BLACK_PLAYER,
+		WHITE_PLAYER,
+
+		NUM_PLAYER_COLORS
+	};
+}
\ No newline at end of file
@@ -1,13 +1,45 @@
+#include <algorithm>
+
 #include "Bitboards.hpp"
 #include "BoardUtils.hpp"
 #include "GameState.h"
 #include "Logger.h"
 #include "RNG.h"
 
+/**
+ * Seed of the random numbers used for Zobrist hashing. Fixed, so that hash values are the same in every run,
+ * which allows them to be stored in files (see OpeningBook)
+ */
+#define ZOBRIST_SEED 0x4B6E696768747468ULL
+
 std::vector<std::vector<uint64_t>> GameState::zobristRandomNums = std::vector<std::vector<uint64_t>>();
+uint64_t GameState::zobristPlayerNum = 0;
 std::vector<std::vector<int>> GameState::moveTargetsBlack = GameState::precomputeMoveTargetsBlack();
 std::vector<std::vector<int>> GameState::moveTargetsWhite = GameState::precomputeMoveTargetsWhite();
 
+const int GameState::PIECE_SQUARE_VALUES[NUM_PLAYERS][BOARD_WIDTH * BOARD_HEIGHT] = {
+	{	// black, moving down from the top row
+		0, 0, 0, 0, 0, 0, 0, 0,
+		1, 1, 1, 1, 1, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2,
+		3, 3, 3, 3, 3, 3, 3, 3,
+		4, 4, 4, 4, 4, 4, 4, 4,
+		5, 5, 5, 5, 5, 5, 5, 5,
+		6, 6, 6, 6, 6, 6, 6, 6,
+		7, 7, 7, 7, 7, 7, 7, 7
+	},
+	{	// white, moving up from the bottom row
+		7, 7, 7, 7, 7, 7, 7, 7,
+		6, 6, 6, 6, 6, 6, 6, 6,
+		5, 5, 5, 5, 5, 5, 5, 5,
+		4, 4, 4, 4, 4, 4, 4, 4,
+		3, 3, 3, 3, 3, 3, 3, 3,
+		2, 2, 2, 2, 2, 2, 2, 2,
+		1, 1, 1, 1, 1, 1, 1, 1,
+		0, 0, 0, 0, 0, 0, 0, 0
+	}
+};
+
 GameState::GameState()
 	: blackBitboard(0),
 	whiteBitboard(0),
@@ -19,6 +51,7 @@ GameState::GameState()
 	// initialize random numbers for Zobrist hashing if not done yet
 	if (zobristRandomNums.size() == 0)
 	{
+		RNG::Generator_64 generator(ZOBRIST_SEED);
 		zobristRandomNums.reserve(BOARD_HEIGHT * BOARD_WIDTH);
 
 		for (int y = 0; y < BOARD_HEIGHT; ++y)
@@ -32,15 +65,15 @@ GameState::GameState()
 				for (int i = 0; i < NUM_PLAYERS; ++i)
 				{
 					// add a random number corresponding to v's board location and the i'th player
-					v.push_back(RNG::randomUint_64());
+					v.push_back(generator.randomUint_64());
 				}
 
 				zobristRandomNums.push_back(v);
 			}
 		}
-	}
 
-	zobristPlayerNum = RNG::randomUint_64();
+		zobristPlayerNum = generator.randomUint_64();
+	}
 
 #ifdef ALLOW_LOGGING
 	if(moveTargetsBlack.empty() || moveTargetsWhite.empty())
@@ -48,6 +81,8 @@ GameState::GameState()
 		LOG_ERROR("ERROR: GameState::moveTargetsBlack and/or GameState::moveTargetsWhite not initialized!")
 	}
 #endif // ALLOW_LOGGING
+
+	initProgressions();
 }
 
 GameState::~GameState()
@@ -63,6 +98,8 @@ void GameState::applyMove(const Move& move)
 		// account for removal of enemy piece in the zobrist hash value
 		zobristHash ^= zobristRandomNums[move.to][opponentColor - 1];
 
+		removeKnight(opponentColor, move.to);
+
 		// update opponent's bitboard
 		if(opponentColor == EPlayerColors::Type::BLACK_PLAYER)
 		{
@@ -90,6 +127,10 @@ void GameState::applyMove(const Move& move)
 	zobristHash ^= zobristRandomNums[move.to][currentPlayer - 1];
 	zobristHash ^= zobristRandomNums[move.from][currentPlayer - 1];
 
+	// adding before removing means that the progression never has to be recomputed for a knight moving forwards
+	addKnight(currentPlayer, move.to);
+	removeKnight(currentPlayer, move.from);
+
 	// finally, switch player
 	switchCurrentPlayer();
 }
@@ -136,6 +177,19 @@ bool GameState::canMove(int from, int to, EPlayerColors::Type player) const
 	return false;
 }
 
+void GameState::copyFrom(const GameState& other)
+{
+	blackBitboard = other.blackBitboard;
+	whiteBitboard = other.whiteBitboard;
+	zobristHash = other.zobristHash;
+	currentPlayer = other.currentPlayer;
+	numBlackKnights = other.numBlackKnights;
+	numWhiteKnights = other.numWhiteKnights;
+
+	std::copy(other.progressions, other.progressions + NUM_PLAYERS, progressions);
+	std::copy(&other.rowCounts[0][0], &other.rowCounts[0][0] + NUM_PLAYERS * BOARD_HEIGHT, &rowCounts[0][0]);
+}
+
 std::vector<Move> GameState::generateMoves(int from) const
 {
 	std::vector<Move> moves;
@@ -270,6 +324,16 @@ int GameState::getNumWhiteKnights() const
 	return numWhiteKnights;
 }
 
+int GameState::getProgression(EPlayerColors::Type player) const
+{
+	return progressions[player - 1];
+}
+
+int GameState::getPieceSquareValue(EPlayerColors::Type player, int location)
+{
+	return PIECE_SQUARE_VALUES[player - 1][location];
+}
+
 
 EPlayerColors::Type GameState::getOpponentColor(EPlayerColors::Type color) const
 {
@@ -315,6 +379,21 @@ uint64_t GameState::getZobrist() const
 	return zobristHash;
 }
 
+uint64_t GameState::getZobristAfterMove(const Move& move) const
+{
+	uint64_t childHash = zobristHash ^ zobristPlayerNum;
+
+	if(move.captured)
+	{
+		childHash ^= zobristRandomNums[move.to][getOpponentColor(currentPlayer) - 1];
+	}
+
+	childHash ^= zobristRandomNums[move.to][currentPlayer - 1];
+	childHash ^= zobristRandomNums[move.from][currentPlayer - 1];
+
+	return childHash;
+}
+
 bool GameState::isMoveLegal(const Move& move) const
 {
 	if (currentPlayer == getOccupier(move.to))		// cannot move to square occupied by our own knights
@@ -385,6 +464,8 @@ void GameState::reset()
 
 	// reset current player status
 	currentPlayer = EPlayerColors::Type::WHITE_PLAYER;
+
+	initProgressions();
 }
 
 void GameState::switchCurrentPlayer()
@@ -415,6 +496,8 @@ void GameState::undoMove(const Move& move)
 		// account for removal of enemy piece in the zobrist hash value
 		zobristHash ^= zobristRandomNums[move.to][opponentColor - 1];
 
+		addKnight(opponentColor, move.to);
+
 		// update opponent's bitboard
 		if(opponentColor == EPlayerColors::Type::BLACK_PLAYER)
 		{
@@ -441,6 +524,64 @@ void GameState::undoMove(const Move& move)
 	// account for movement of our own piece in the zobrist hash value
 	zobristHash ^= zobristRandomNums[move.to][currentPlayer - 1];
 	zobristHash ^= zobristRandomNums[move.from][currentPlayer - 1];
+
+	addKnight(currentPlayer, move.from);
+	removeKnight(currentPlayer, move.to);
+}
+
+void GameState::addKnight(EPlayerColors::Type player, int location)
+{
+	int index = player - 1;
+	int value = PIECE_SQUARE_VALUES[index][location];
+
+	++rowCounts[index][location / BOARD_WIDTH];
+
+	if(value > progressions[index])
+	{
+		progressions[index] = value;
+	}
+}
+
+void GameState::removeKnight(EPlayerColors::Type player, int location)
+{
+	int index = player - 1;
+	int value = PIECE_SQUARE_VALUES[index][location];
+	int y = location / BOARD_WIDTH;
+
+	--rowCounts[index][y];
+
+	// only if the last knight on the furthest row is removed, the progression moves back to the next occupied row
+	if(rowCounts[index][y] == 0 && value == progressions[index])
+	{
+		int step = (player == EPlayerColors::Type::BLACK_PLAYER) ? -1 : 1;
+
+		while(progressions[index] > 0 && rowCounts[index][y] == 0)
+		{
+			--progressions[index];
+			y += step;
+		}
+	}
+}
+
+void GameState::initProgressions()
+{
+	for(int index = 0; index < NUM_PLAYERS; ++index)
+	{
+		progressions[index] = 0;
+		std::fill(rowCounts[index], rowCounts[index] + BOARD_HEIGHT, 0);
+	}
+
+	for(int location = 0; location < BOARD_WIDTH * BOARD_HEIGHT; ++location)
+	{
+		if(blackBitboard & Bitboards::singleBit(location))
+		{
+			addKnight(EPlayerColors::Type::BLACK_PLAYER, location);
+		}
+		else if(whiteBitboard & Bitboards::singleBit(location))
+		{
+			addKnight(EPlayerColors::Type::WHITE_PLAYER, location);
+		}
+	}
 }
 
 std::vector<std::vector<int>> GameState::precomputeMoveTargetsBlack()
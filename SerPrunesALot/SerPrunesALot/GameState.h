@@ -7,20 +7,6 @@
 #include "Move.h"
 #include "TranspositionTable.h"
 
-/** Possible colors that players can have */
-namespace EPlayerColors
-{
-	enum Type
-	{
-		NOTHING,
-
-		BLACK_PLAYER,
-		WHITE_PLAYER,
-
-		NUM_PLAYER_COLORS
-	};
-}
-
 /**
  * Defines a state of the game
  */
@@ -57,6 +43,14 @@ public:
 	 */
 	bool canMove(int from, int to, EPlayerColors::Type player) const;
 
+	/**
+	 * Makes this game state an exact copy of the given other game state.
+	 *
+	 * Explicit replacement for the (disabled) copy constructor and assignment operator, for the rare cases
+	 * where a copy is really required (such as giving a search running on a worker thread its own game state)
+	 */
+	void copyFrom(const GameState& other);
+
 	/** 
 	 * Generates a vector with all legal moves from the ''from'' location. 
 	 * Does NOT test whether the player on the ''from'' location actually is the current player 
@@ -75,6 +69,10 @@ public:
 	int getNumBlackKnights() const;
 	/** Returns the number of knights that the white player has */
 	int getNumWhiteKnights() const;
+	/** Returns the number of rows that the furthest knight of the given player has advanced from its back row */
+	int getProgression(EPlayerColors::Type player) const;
+	/** Returns the value of a knight of the given player on the given square: the number of rows it has advanced from its back row */
+	static int getPieceSquareValue(EPlayerColors::Type player, int location);
 	/** Returns an EPlayerColors::Type indicating what (if anything) is occupying a given BoardLocation */
 	EPlayerColors::Type getOccupier(int location) const;
 	/** Given a player's color, returns the color of the opponent */
@@ -83,6 +81,8 @@ public:
 	EPlayerColors::Type getWinner() const;
 	/** Returns the Zobrist Hash Value of the current game state */
 	uint64_t getZobrist() const;
+	/** Returns the Zobrist Hash Value the game state would have after applying the given move, without applying it */
+	uint64_t getZobristAfterMove(const Move& move) const;
 
 	/** Returns true iff the given move is legal in the current game state */
 	bool isMoveLegal(const Move& move) const;
@@ -103,6 +103,8 @@ public:
 private:
 	/** Matrix of random numbers corresponding to board locations and player colors. Used for computing Zobrist Hash Values*/
 	static std::vector<std::vector<uint64_t>> zobristRandomNums;
+	/** A single special random number that is XORd with the zobrist hash every time the turn switches, to indicate who the current player is */
+	static uint64_t zobristPlayerNum;
 
 	/** Pre-computed table of move targets for the Black Player */
 	static std::vector<std::vector<int>> moveTargetsBlack;
@@ -117,8 +119,6 @@ private:
 	/** The Zobrist Hash Value of this game state */
 	uint64_t zobristHash;
 
-	/** A single special random number that is XORd with the zobrist hash every time the turn switches, to indicate who the current player is */
-	uint64_t zobristPlayerNum;
 
 	/** The player whose turn it is */
 	EPlayerColors::Type currentPlayer;
@@ -128,6 +128,23 @@ private:
 	/** The number of white knights remaining in this state */
 	int numWhiteKnights;
 
+	// the progression is updated incrementally by applyMove() and undoMove(), so that evaluation functions do not have to
+	// compute it from the bitboards at every leaf. Both are indexed by player - 1 first
+	/** See getProgression() */
+	int progressions[NUM_PLAYERS];
+	/** The number of knights on every row, indexed by [player - 1][y], so that the progression can move back when a row empties */
+	int rowCounts[NUM_PLAYERS][BOARD_HEIGHT];
+
+	/** Piece-square values of both players, indexed by [player - 1][location] */
+	static const int PIECE_SQUARE_VALUES[NUM_PLAYERS][BOARD_WIDTH * BOARD_HEIGHT];
+
+	/** Updates the progression for a knight of the given player that is added to the given location */
+	void addKnight(EPlayerColors::Type player, int location);
+	/** Updates the progression for a knight of the given player that is removed from the given location */
+	void removeKnight(EPlayerColors::Type player, int location);
+	/** Computes the progression from scratch, from the bitboards */
+	void initProgressions();
+
 	// Functions to initialize static move target tables
 	static std::vector<std::vector<int>> precomputeMoveTargetsBlack();
 	static std::vector<std::vector<int>> precomputeMoveTargetsWhite();
@@ -0,0 +1,71 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "HistoryTable.h"
+
+HistoryTable::HistoryTable()
+	: countermoves(HISTORY_NUM_SQUARES * HISTORY_NUM_SQUARES, INVALID_MOVE)
+{
+	clear();
+}
+
+void HistoryTable::clear()
+{
+	std::fill(&history[0][0][0], &history[0][0][0] + NUM_PLAYERS * HISTORY_NUM_SQUARES * HISTORY_NUM_SQUARES, 0);
+	std::fill(countermoves.begin(), countermoves.end(), INVALID_MOVE);
+}
+
+void HistoryTable::age()
+{
+	int* score = &history[0][0][0];
+	int* end = score + NUM_PLAYERS * HISTORY_NUM_SQUARES * HISTORY_NUM_SQUARES;
+
+	for(; score != end; ++score)
+	{
+		*score /= 2;
+	}
+}
+
+void HistoryTable::updateHistory(EPlayerColors::Type playerColor, const Move& cutoffMove, const Move* searchedQuietMoves, int numSearchedQuietMoves, int depth)
+{
+	int bonus = std::min(depth * depth, HISTORY_MAX_SCORE);
+	int (*playerHistory)[HISTORY_NUM_SQUARES] = history[playerColor - 1];
+
+	applyBonus(playerHistory[cutoffMove.from][cutoffMove.to], bonus);
+
+	for(int i = 0; i < numSearchedQuietMoves; ++i)
+	{
+		const Move& move = searchedQuietMoves[i];
+
+		if(!(move == cutoffMove))
+		{
+			applyBonus(playerHistory[move.from][move.to], -bonus);
+		}
+	}
+}
+
+void HistoryTable::storeCountermove(const Move& previousMove, const Move& countermove)
+{
+	if(previousMove.from >= 0)
+	{
+		countermoves[previousMove.from * HISTORY_NUM_SQUARES + previousMove.to] = countermove;
+	}
+}
+
+Move HistoryTable::getCountermove(const Move& previousMove) const
+{
+	if(previousMove.from < 0)
+	{
+		return INVALID_MOVE;
+	}
+
+	return countermoves[previousMove.from * HISTORY_NUM_SQUARES + previousMove.to];
+}
+
+void HistoryTable::applyBonus(int& score, int bonus)
+{
+	// scale the update with the remaining distance to the limit, so that the score can never leave [-HISTORY_MAX_SCORE, HISTORY_MAX_SCORE]
+	score += bonus - score * std::abs(bonus) / HISTORY_MAX_SCORE;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#include "GameConstants.h"
+#include "GameState.h"
+#include "Move.h"
+
+/** The number of squares on the board, used as the size of the from and to dimensions of the history tables */
+#define HISTORY_NUM_SQUARES (BOARD_WIDTH * BOARD_HEIGHT)
+
+/**
+ * Tables used to order quiet moves, which the Move Generator otherwise returns in a fixed order.
+ *
+ * The butterfly history table contains a score for every (color, from, to) combination. Whenever a quiet move causes a
+ * beta cutoff, it receives a bonus of depth * depth, and all quiet moves searched before it in the same node receive an
+ * equally large malus. Scores are kept within [-HISTORY_MAX_SCORE, HISTORY_MAX_SCORE] by scaling every update down
+ * as the score approaches the limit, and are aged (halved) between searches so that old information gradually fades.
+ *
+ * The countermove table contains, for every move the opponent may have just played, the last quiet move that refuted it.
+ */
+class HistoryTable
+{
+public:
+	HistoryTable();
+
+	/** Clears both tables */
+	void clear();
+
+	/** Halves all history scores. Should be called between searches */
+	void age();
+
+	/**
+	 * Rewards the given quiet move that caused a beta cutoff at the given remaining depth, and penalizes the other quiet moves
+	 * that were searched before it in the same node.
+	 */
+	void updateHistory(EPlayerColors::Type playerColor, const Move& cutoffMove, const Move* searchedQuietMoves, int numSearchedQuietMoves, int depth);
+
+	/** Stores the given quiet move as the countermove of the given move previously played by the opponent */
+	void storeCountermove(const Move& previousMove, const Move& countermove);
+
+	/** Returns the history score of the given move, played by the given player */
+	inline int getHistoryScore(EPlayerColors::Type playerColor, const Move& move) const
+	{
+		return history[playerColor - 1][move.from][move.to];
+	}
+
+	/** Returns the countermove of the given move previously played by the opponent. Returns INVALID_MOVE if unknown */
+	Move getCountermove(const Move& previousMove) const;
+
+	/** The largest absolute value a history score can have */
+	static const int HISTORY_MAX_SCORE = 1 << 14;
+
+private:
+	/** history[color - 1][from][to] = score of the move from ''from'' to ''to'' by the player with the given color */
+	int history[NUM_PLAYERS][HISTORY_NUM_SQUARES][HISTORY_NUM_SQUARES];
+
+	/** countermoves[from * HISTORY_NUM_SQUARES + to] = countermove of the move from ''from'' to ''to'' */
+	std::vector<Move> countermoves;
+
+	/** Adds the given bonus (or malus, if negative) to the given score, scaled down as the score approaches HISTORY_MAX_SCORE */
+	static void applyBonus(int& score, int bonus);
+
+	// don't want accidental copying of the History Table
+	HistoryTable(const HistoryTable&);
+	HistoryTable& operator=(const HistoryTable&);
+};
\ No newline at end of file
@@ -6,17 +6,20 @@
 #include "Logger.h"
 #include "MathConstants.h"
 #include "MoveOrdering.h"
+#include "SearchCore.h"
 
 /**
 * The evaluation corresponding to a won game.
 * Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+* Wins are scored as this value minus their distance in plies from the root (see SearchCore::getWinScore())
 */
 #define WIN_EVALUATION 1900
 
 IterativeDeepening::IterativeDeepening() 
 	: transpositionTable(),
-	clock(), 
+	clock(),
 	lastRootEvaluation(0), 
+	timeManager(MIN_SEARCH_TIME_MS, MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS), 
 	totalNodesVisited(0), 
 	totalTimeSpent(0.0), 
 	turnsPlayed(0), 
@@ -28,7 +31,6 @@ Move IterativeDeepening::chooseMove(GameState& gameState)
 	transpositionTable.clear();	// clean up data from previous searches
 
 #ifdef GATHER_STATISTICS
-	nodesVisited = 0;
 	Timer timer;
 	timer.start();
 	Move moveToPlay = startIterativeDeepening(gameState);
@@ -45,7 +47,7 @@ Move IterativeDeepening::chooseMove(GameState& gameState)
 	}
 
 	LOG_MESSAGE(StringBuilder() << "Search depth:					" << searchDepth)
-	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << nodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
 	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
 	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries used:		" << ((double)transpositionTable.getNumEntriesUsed() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
 	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries replaced:	" << ((double)transpositionTable.getNumReplacementsRequired() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
@@ -53,7 +55,7 @@ Move IterativeDeepening::chooseMove(GameState& gameState)
 #endif // LOG_STATS_PER_TURN
 
 #ifdef LOG_STATS_END_OF_MATCH
-	totalNodesVisited += nodesVisited;
+	totalNodesVisited += searchControl.getNodesVisited();
 	totalTimeSpent += timer.getElapsedTimeInMilliSec();
 	++turnsPlayed;
 #endif // LOG_STATS_END_OF_MATCH
@@ -64,11 +66,17 @@ Move IterativeDeepening::chooseMove(GameState& gameState)
 #endif // GATHER_STATISTICS
 }
 
-int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int alpha, int beta)
+int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta)
 {
-#ifdef GATHER_STATISTICS
-	++nodesVisited;
-#endif // GATHER_STATISTICS
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+	if (SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
 
 	int originalAlpha = alpha;
 	uint64_t zobrist = gameState.getZobrist();
@@ -84,26 +92,29 @@ int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int alpha, in
 	}
 #endif
 
+	// wins are stored relative to the node, so convert back to a score relative to the root
+	int tableValue = (tableDataValid) ? SearchCore::scoreFromTable(tableData.value, ply, WIN_EVALUATION) : 0;
+
 	if (tableDataValid)
 	{
 		if (tableData.depth >= depth)	// ensure table stored in data resulted from a deep enough search
 		{
 			if (tableData.valueType == EValue::Type::REAL)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 			else if (tableData.valueType == EValue::Type::LOWER_BOUND)
 			{
-				alpha = std::max(alpha, tableData.value);
+				alpha = std::max(alpha, tableValue);
 			}
 			else if (tableData.valueType == EValue::Type::UPPER_BOUND)
 			{
-				beta = std::min(beta, tableData.value);
+				beta = std::min(beta, tableValue);
 			}
 
 			if (alpha >= beta)
 			{
-				return tableData.value;
+				return tableValue;
 			}
 		}
 	}
@@ -113,7 +124,7 @@ int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int alpha, in
 	// stop search if we reached max depth or have found a winner
 	if (depth == 0 || winner != EPlayerColors::Type::NOTHING)
 	{
-		return evaluate(gameState, winner);
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
 	}
 
 	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
@@ -130,10 +141,10 @@ int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int alpha, in
 	while(!(m == INVALID_MOVE))
 	{
 		gameState.applyMove(m);												// apply move
-		int value = -alphaBeta(gameState, depth - 1, -beta, -alpha);		// continue searching
+		int value = -alphaBeta(gameState, depth - 1, ply + 1, -beta, -alpha);		// continue searching
 		gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
-		if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS)		// exceeding time limit
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
 		{
 			return 0;
 		}
@@ -158,15 +169,15 @@ int IterativeDeepening::alphaBeta(GameState& gameState, int depth, int alpha, in
 	// Store data in Transposition Table
 	if (score <= originalAlpha)		// found upper bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::UPPER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::UPPER_BOUND, depth);
 	}
 	else if (score >= beta)			// found lower bound
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::LOWER_BOUND, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
 	}
 	else							// found exact value
 	{
-		transpositionTable.storeData(bestMove, zobrist, score, EValue::Type::REAL, depth);
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::REAL, depth);
 	}
 
 	return score;
@@ -197,65 +208,7 @@ int IterativeDeepening::evaluate(const GameState& gameState, EPlayerColors::Type
 	int materialDifference = 100 * (gameState.getNumWhiteKnights() - gameState.getNumBlackKnights());
 
 	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
-	int progression = 0;
-
-	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
-	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
-
-	int blackProgression = 0;
-	int whiteProgression = 0;
-
-	if(blackBitboard & Bitboards::ROW_2)
-	{
-		blackProgression = 6;
-	}
-	else if(blackBitboard & Bitboards::ROW_3)
-	{
-		blackProgression = 5;
-	}
-	else if(blackBitboard & Bitboards::ROW_4)
-	{
-		blackProgression = 4;
-	}
-	else if(blackBitboard & Bitboards::ROW_5)
-	{
-		blackProgression = 3;
-	}
-	else if(blackBitboard & Bitboards::ROW_6)
-	{
-		blackProgression = 2;
-	}
-	else if(blackBitboard & Bitboards::ROW_7)
-	{
-		blackProgression = 1;
-	}
-
-	if(whiteBitboard & Bitboards::ROW_7)
-	{
-		whiteProgression = 6;
-	}
-	else if(whiteBitboard & Bitboards::ROW_6)
-	{
-		whiteProgression = 5;
-	}
-	else if(whiteBitboard & Bitboards::ROW_5)
-	{
-		whiteProgression = 4;
-	}
-	else if(whiteBitboard & Bitboards::ROW_4)
-	{
-		whiteProgression = 3;
-	}
-	else if(whiteBitboard & Bitboards::ROW_3)
-	{
-		whiteProgression = 2;
-	}
-	else if(whiteBitboard & Bitboards::ROW_2)
-	{
-		whiteProgression = 1;
-	}
-
-	progression = 35 * (whiteProgression - blackProgression);
+	int progression = 35 * (gameState.getProgression(EPlayerColors::Type::WHITE_PLAYER) - gameState.getProgression(EPlayerColors::Type::BLACK_PLAYER));
 
 	// compute final score
 	int score = materialDifference + progression;
@@ -282,6 +235,8 @@ double IterativeDeepening::getSecondsSearched()
 Move IterativeDeepening::startIterativeDeepening(GameState& gameState)
 {
 	clock.start();
+	timeManager.startMove(searchLimits, gameState);
+	searchControl.startSearch(timeManager.getTargetTimeMs(), timeManager.getMaxTimeMs(), searchLimits.maxNodes);
 	EPlayerColors::Type winner = gameState.getWinner();
 
 	// stop search if we reached max depth or have found a winner
@@ -307,7 +262,7 @@ Move IterativeDeepening::startIterativeDeepening(GameState& gameState)
 	}
 
 	std::vector<int> moveScores;			// will store the scores of the moves here, to use for sorting
-	moveScores.reserve(moves.size());
+	moveScores.resize(moves.size(), 0);
 
 	searchDepth = 0;
 	// best move found from a complete search (so not considering searches that were terminated early)
@@ -324,16 +279,20 @@ Move IterativeDeepening::startIterativeDeepening(GameState& gameState)
 
 		// best move for only this particular search
 		Move bestMove = moves[0];
+		// best move of this particular search if it is terminated early
+		Move bestMovePartialSearch = INVALID_MOVE;
 
 		for (int i = 0; i < moves.size(); ++i)
 		{
 			const Move& m = moves[i];											// select move
 			gameState.applyMove(m);												// apply move
-			int value = -alphaBeta(gameState, searchDepth - 1, -beta, -alpha);	// continue searching
+			int value = -alphaBeta(gameState, searchDepth - 1, 1, -beta, -alpha);	// continue searching
 			gameState.undoMove(m);												// finished searching this subtree, so undo the move
 
-			if(clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS)		// exceeding time limit
+			if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
 			{
+				// the previous best move is always searched first, so any best move after that is at least as good
+				bestMovePartialSearch = (i > 0) ? bestMove : INVALID_MOVE;
 				bestMove = INVALID_MOVE;
 				break;
 			}
@@ -359,15 +318,15 @@ Move IterativeDeepening::startIterativeDeepening(GameState& gameState)
 		if (!(bestMove == INVALID_MOVE))	// managed to complete the search within time
 		{
 			lastRootEvaluation = score;
+			timeManager.iterationCompleted(score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+			reportIteration(searchDepth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
 
-			if (score == WIN_EVALUATION)	// the search was enough to prove a win for us, so return best move of this latest search
+			// the search proved a win or a loss, and searched deep enough to be sure that there is no faster one. The best move
+			// then either wins as fast as possible, or postpones the loss as long as possible
+			if (SearchCore::isWinScore(score, WIN_EVALUATION) && SearchCore::getWinDistance(score, WIN_EVALUATION) <= searchDepth)
 			{
 				return bestMove;
 			}
-			else if (score == -WIN_EVALUATION)	// the search proved a win for opponent, so return best move of the previous search
-			{
-				return bestMoveCompleteSearch;
-			}
 
 			// finished search, and didn't prove a win for either team, so save the new best result
 			bestMoveCompleteSearch = bestMove;
@@ -375,9 +334,15 @@ Move IterativeDeepening::startIterativeDeepening(GameState& gameState)
 		else
 		{
 			--searchDepth;	// since last search was unsuccessful, decrement this so GUI doesn't lie to us
+
+			if(!(bestMovePartialSearch == INVALID_MOVE))
+			{
+				bestMoveCompleteSearch = bestMovePartialSearch;
+			}
 		}
 
-		if (clock.getElapsedTimeInMilliSec() >= MIN_SEARCH_TIME_MS)		// exceeding time limit
+		if(searchControl.isStopped() || (searchLimits.maxDepth > 0 && searchDepth >= searchLimits.maxDepth) ||
+			!timeManager.shouldStartNextIteration(searchControl.getElapsedMs()))		// search terminated, exceeding depth limit, or next iteration not expected to finish in time
 		{
 			clock.stop();
 			return bestMoveCompleteSearch;
@@ -3,13 +3,15 @@
 #include <inttypes.h>
 
 #include "AiEngine.h"
+#include "TimeManager.h"
 #include "Timer.hpp"
 #include "TranspositionTable.h"
 
 /**
  * Engine using Iterative Deepening. Also uses a Transposition Table and the Evaluation Function
  * from the ''EnhancedEvalFunction'' engine. After searching to depth d, always re-orders the available
- * moves at the root based on the scores found before continuing search to depth d + 1
+ * moves at the root based on the scores found before continuing search to depth d + 1.
+ * Like the Aspiration Search engine, evaluates leaves directly, without quiescence search
  */
 class IterativeDeepening : public AiEngine
 {
@@ -31,29 +33,31 @@ private:
 	/** The engine's Transposition Table */
 	TranspositionTable transpositionTable;
 
-	/** A clock used to avoid overshooting the allowed search time by too much */
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
 	Timer clock;
 
 	/** The evaluation of the root node during the last search */
 	int lastRootEvaluation;
 
-	/** The minimum amount of time in milliseconds that the algorithm will spend search */
+	/** The default amount of time in milliseconds that the algorithm will spend search */
 	const int MIN_SEARCH_TIME_MS = 20000;
-	/** The maximum amount of time in milliseconds that the algorithm will spend trying to complete the current search when over MIN_SEARCH_TIME_MS */
+	/** The default amount of time in milliseconds that the algorithm may spend on top of MIN_SEARCH_TIME_MS to complete or extend its search */
 	const int MAX_EXTRA_SEARCH_TIME_MS = 10000;
 
+	/** Decides how much time to spend on every move, and whether or not to start new iterations. Initialized after the constants above */
+	TimeManager timeManager;
+
 	// variables used for gathering and logging statistics
-	int nodesVisited;
 	int64_t totalNodesVisited;
 	double totalTimeSpent;
 	int turnsPlayed;
 	int searchDepth;
 
 	/**
-	* Continues alpha-beta search, given the game state, maximum search depth, and current alpha and beta values.
+	* Continues alpha-beta search, given the game state, maximum search depth, distance from the root, and current alpha and beta values.
 	* Returns the node's evaluation.
 	*/
-	int alphaBeta(GameState& gameState, int depth, int alpha, int beta);
+	int alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta);
 
 	/**
 	* Returns an evaluation of the given game state.
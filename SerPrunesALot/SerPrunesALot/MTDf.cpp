@@ -0,0 +1,533 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <string>
+
+#include "Logger.h"
+#include "MathConstants.h"
+#include "MTDf.h"
+#include "SearchCore.h"
+
+/**
+* The evaluation corresponding to a won game.
+* Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+* Wins are scored as this value minus their distance in plies from the root (see SearchCore::getWinScore())
+*/
+#define WIN_EVALUATION 1900
+
+MTDf::MTDf()
+	: boundsTable(),
+	killerMoves(),
+	passesPerIteration(),
+	clock(),
+	lastRootEvaluation(0),
+	nullMovePruning(true),
+	timeManager(MIN_SEARCH_TIME_MS, MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS),
+	totalNodesVisited(0),
+	totalTimeSpent(0.0),
+	turnsPlayed(0),
+	searchDepth(0),
+	totalPasses(0),
+	totalIterations(0)
+{
+}
+
+Move MTDf::chooseMove(GameState& gameState)
+{
+	boundsTable.clear();	// clean up data from previous searches
+
+#ifdef GATHER_STATISTICS
+	Timer timer;
+	timer.start();
+	Move moveToPlay = startMTDf(gameState);
+	timer.stop();
+
+#ifdef LOG_STATS_PER_TURN
+	if(gameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		LOG_MESSAGE(StringBuilder() << "MTD(f) engine searching move for Black Player")
+	}
+	else
+	{
+		LOG_MESSAGE(StringBuilder() << "MTD(f) engine searching move for White Player")
+	}
+
+	std::string passesString;
+	for(int passes : passesPerIteration)
+	{
+		passesString += (StringBuilder() << passes << " ").getString();
+	}
+
+	LOG_MESSAGE(StringBuilder() << "Search depth:					" << searchDepth)
+	LOG_MESSAGE(StringBuilder() << "Passes per iteration:				" << passesString)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
+	LOG_MESSAGE(StringBuilder() << "% of Bounds Table entries used:			" << ((double)boundsTable.getNumEntriesUsed() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
+	LOG_MESSAGE(StringBuilder() << "% of Bounds Table entries replaced:		" << ((double)boundsTable.getNumReplacementsRequired() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
+	LOG_MESSAGE("")
+#endif // LOG_STATS_PER_TURN
+
+#ifdef LOG_STATS_END_OF_MATCH
+	totalNodesVisited += searchControl.getNodesVisited();
+	totalTimeSpent += timer.getElapsedTimeInMilliSec();
+	++turnsPlayed;
+#endif // LOG_STATS_END_OF_MATCH
+
+	return moveToPlay;
+#else
+	return startMTDf(gameState);
+#endif // GATHER_STATISTICS
+}
+
+int MTDf::alphaBetaWithMemory(GameState& gameState, int depth, int ply, int alpha, int beta, bool nullMoveAllowed)
+{
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+	if(SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
+
+	uint64_t zobrist = gameState.getZobrist();
+	const BoundsData& boundsData = boundsTable.retrieve(zobrist);
+	// true iff relevant data was retrieved from the Bounds Table
+	bool boundsDataValid = boundsData.isValid();
+
+#ifdef VERIFY_MOVE_LEGALITY
+	if(boundsDataValid && !gameState.isMoveLegal(boundsData.bestMove))
+	{
+		LOG_ERROR("ERROR: bounds data contains invalid move in MTDf::alphaBetaWithMemory")
+		boundsDataValid = false;
+	}
+#endif
+
+	// copied now, because the null-move searches below may store into the same bucket and overwrite the entry
+	Move tableMove = (boundsDataValid) ? boundsData.bestMove : INVALID_MOVE;
+
+	if(boundsDataValid)
+	{
+		if(boundsData.depth >= depth)	// ensure bounds stored in data resulted from a deep enough search
+		{
+			// wins are stored relative to the node, so convert back to scores relative to the root
+			int lowerBound = SearchCore::scoreFromTable(boundsData.lowerBound, ply, WIN_EVALUATION);
+			int upperBound = SearchCore::scoreFromTable(boundsData.upperBound, ply, WIN_EVALUATION);
+
+			if(lowerBound >= beta)
+			{
+				return lowerBound;
+			}
+			if(upperBound <= alpha)
+			{
+				return upperBound;
+			}
+
+			alpha = std::max(alpha, lowerBound);
+			beta = std::min(beta, upperBound);
+		}
+	}
+
+	EPlayerColors::Type winner = gameState.getWinner();
+
+	// stop search if we reached max depth or have found a winner
+	if(depth == 0 || winner != EPlayerColors::Type::NOTHING)
+	{
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
+	}
+
+#ifdef USE_NULL_MOVE_PRUNING
+	if(nullMovePruning && nullMoveAllowed && SearchCore::isNullMoveAllowed(gameState, depth))
+	{
+		int staticEvaluation = evaluate(gameState, winner);
+		int nullMoveValue;
+
+		// the returned bound is fail-soft, so that consecutive MTD(f) passes are not limited to steps of 1
+		if(staticEvaluation >= beta && SearchCore::tryNullMove(gameState, depth, ply, beta, staticEvaluation, searchControl,
+			[this, &gameState](int searchDepth, int searchPly, int searchAlpha, int searchBeta, bool allowNullMove)
+			{
+				return alphaBetaWithMemory(gameState, searchDepth, searchPly, searchAlpha, searchBeta, allowNullMove);
+			}, nullMoveValue))
+		{
+			return std::min(nullMoveValue, WIN_EVALUATION - MAX_WIN_DISTANCE);
+		}
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+	}
+#endif // USE_NULL_MOVE_PRUNING
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	Move transpositionMove = tableMove;
+
+	Move killerMove1 = INVALID_MOVE;
+	Move killerMove2 = INVALID_MOVE;
+
+	if(killerMoves.size() > depth)	// may have killer moves stored
+	{
+		std::vector<Move>& currentDepthKillerMoves = killerMoves[depth];
+
+		if(currentDepthKillerMoves.size() > 0)
+		{
+			killerMove1 = currentDepthKillerMoves[0];
+
+			if(currentDepthKillerMoves.size() > 1)
+			{
+				killerMove2 = currentDepthKillerMoves[1];
+			}
+		}
+	}
+
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)),
+								transpositionMove, killerMove1, killerMove2);
+
+	int score = MathConstants::LOW_ENOUGH_INT;
+	int currentAlpha = alpha;
+	Move m = moveGenerator.nextMove();
+	Move bestMove = m;
+
+	while(!(m == INVALID_MOVE))
+	{
+		gameState.applyMove(m);														// apply move
+		int value = -alphaBetaWithMemory(gameState, depth - 1, ply + 1, -beta, -currentAlpha);	// continue searching
+		gameState.undoMove(m);														// finished searching this subtree, so undo the move
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
+		if(value > score)		// new best move found
+		{
+			score = value;
+			bestMove = m;
+		}
+		if(score > currentAlpha)
+		{
+			currentAlpha = score;
+		}
+		if(score >= beta)
+		{
+			storeKillerMove(depth, m);
+			break;
+		}
+
+		m = moveGenerator.nextMove();
+	}
+
+	// Store bounds in Bounds Table
+	if(score <= alpha)				// fail low, so found upper bound
+	{
+		boundsTable.storeBounds(bestMove, zobrist, MathConstants::LOW_ENOUGH_INT, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), depth);
+	}
+	else if(score >= beta)			// fail high, so found lower bound
+	{
+		boundsTable.storeBounds(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), MathConstants::LARGE_ENOUGH_INT, depth);
+	}
+	else							// found exact value (can't happen with a zero window, unless bounds from the table narrowed it)
+	{
+		int tableScore = SearchCore::scoreToTable(score, ply, WIN_EVALUATION);
+		boundsTable.storeBounds(bestMove, zobrist, tableScore, tableScore, depth);
+	}
+
+	return score;
+}
+
+int MTDf::searchRoot(GameState& gameState, std::vector<Move>& moves, int depth, int beta, Move& bestMove)
+{
+	int score = MathConstants::LOW_ENOUGH_INT;
+
+	for(int i = 0; i < moves.size(); ++i)
+	{
+		const Move& m = moves[i];													// select move
+		gameState.applyMove(m);														// apply move
+		int value = -alphaBetaWithMemory(gameState, depth - 1, 1, -beta, -beta + 1);	// continue searching
+		gameState.undoMove(m);														// finished searching this subtree, so undo the move
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
+		if(value > score)
+		{
+			score = value;
+		}
+		if(score >= beta)
+		{
+			// move the move that caused the fail high to the front, so that it is searched first in the next pass
+			bestMove = m;
+			std::rotate(moves.begin(), moves.begin() + i, moves.begin() + i + 1);
+			break;
+		}
+	}
+
+	return score;
+}
+
+int MTDf::evaluate(const GameState& gameState) const
+{
+	return evaluate(gameState, gameState.getWinner());
+}
+
+int MTDf::evaluate(const GameState& gameState, EPlayerColors::Type winner) const
+{
+	EPlayerColors::Type evaluatingPlayer = gameState.getCurrentPlayer();
+
+	if(winner == evaluatingPlayer)						// evaluating player won
+	{
+		return WIN_EVALUATION;
+	}
+	else if(winner != EPlayerColors::Type::NOTHING)	// opponent won
+	{
+		return -WIN_EVALUATION;
+	}
+
+	// at this point in code, compute evaluation from white's perspective
+	// at the end, before returning, negate if black is evaluating
+
+	// simple material difference, weight = 100, range = [-1600, 1600]
+	int materialDifference = 100 * (gameState.getNumWhiteKnights() - gameState.getNumBlackKnights());
+
+	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
+	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
+
+	// If black is to move next and already has a piece in the bottom danger zone, simply treat it as a win for black
+	if(evaluatingPlayer == EPlayerColors::Type::BLACK_PLAYER && (blackBitboard & Bitboards::DANGER_ZONE_BOTTOM))
+	{
+		return WIN_EVALUATION;
+	}	// and similar check for white
+	else if(evaluatingPlayer == EPlayerColors::Type::WHITE_PLAYER && (whiteBitboard & Bitboards::DANGER_ZONE_TOP))
+	{
+		return WIN_EVALUATION;
+	}
+
+	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
+	int progression = 35 * (gameState.getProgression(EPlayerColors::Type::WHITE_PLAYER) - gameState.getProgression(EPlayerColors::Type::BLACK_PLAYER));
+
+	// compute final score
+	int score = materialDifference + progression;
+
+	// negate score in case we're black, since so far we assumed we're white
+	if(evaluatingPlayer == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		score = -score;
+	}
+
+	return score;
+}
+
+void MTDf::storeKillerMove(int depth, const Move& move)
+{
+	while(depth >= killerMoves.size()) // don't have a vector of killer moves yet for this depth
+	{
+		std::vector<Move> currentDepthKillerMoves;
+		currentDepthKillerMoves.reserve(2);		// 2 slots of Killer Moves
+		killerMoves.push_back(currentDepthKillerMoves);
+	}
+
+	std::vector<Move>& currentDepthKillerMoves = killerMoves[depth];	// killer moves for this depth
+	if(currentDepthKillerMoves.size() > 0)		// already have at least 1 killer move
+	{
+		if(currentDepthKillerMoves[0] == move)	// this killer move already stored in first slot
+		{
+			return;
+		}
+
+		if(currentDepthKillerMoves.size() > 1)	// already have 2 killer moves stored
+		{
+			if(currentDepthKillerMoves[1] == move)	// this killer move already stored in second slot
+			{
+				return;
+			}
+
+			currentDepthKillerMoves[0] = currentDepthKillerMoves[1];	// move second kill move to first slot
+			currentDepthKillerMoves.pop_back();							// and then remove second (which is now also in first slot)
+		}
+	}
+
+	currentDepthKillerMoves.push_back(move);							// and put the new kill move in second slot
+}
+
+int MTDf::getLastSearchDepth()
+{
+	return searchDepth;
+}
+
+double MTDf::getSecondsSearched()
+{
+	return clock.getElapsedTimeInSec();
+}
+
+const std::vector<int>& MTDf::getPassesPerIteration() const
+{
+	return passesPerIteration;
+}
+
+void MTDf::setNullMovePruning(bool enabled)
+{
+	nullMovePruning = enabled;
+}
+
+Move MTDf::startMTDf(GameState& gameState)
+{
+	clock.start();
+	timeManager.startMove(searchLimits, gameState);
+	searchControl.startSearch(timeManager.getTargetTimeMs(), timeManager.getMaxTimeMs(), searchLimits.maxNodes);
+	passesPerIteration.clear();
+	EPlayerColors::Type winner = gameState.getWinner();
+
+	// stop search if we reached max depth or have found a winner
+	if(winner != EPlayerColors::Type::NOTHING)
+	{
+		return INVALID_MOVE;		// can't return any normal move if game already ended
+	}
+
+	std::vector<Move> moves;				// will store all the moves in the root node, re-ordered whenever a move causes a fail high
+	moves.reserve(16 * 4);
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)));
+
+	Move rootMove = moveGenerator.nextMove();
+
+	while(!(rootMove == INVALID_MOVE))
+	{
+		moves.push_back(rootMove);
+		rootMove = moveGenerator.nextMove();
+	}
+
+	// best move found from a complete search (so not considering searches that were terminated early)
+	Move bestMoveCompleteSearch = moves[0];
+
+	// scores of all completed iterations, used as first guesses for later iterations
+	std::vector<int> iterationScores;
+
+	searchDepth = 0;
+	while(true)
+	{
+		++searchDepth;			// increment search depth for the new search
+		killerMoves.clear();	// clear table of killer moves
+
+		// scores of odd and even depths differ a lot in this game, so prefer the last score of the same parity as first guess
+		int guess;
+		if(iterationScores.size() >= 2)
+		{
+			guess = iterationScores[iterationScores.size() - 2];
+		}
+		else if(iterationScores.size() == 1)
+		{
+			guess = iterationScores[0];
+		}
+		else
+		{
+			guess = evaluate(gameState);
+		}
+
+		// ================= MTD(f) ALGORITHM STARTS HERE =================
+		int score = guess;
+		int lowerBound = MathConstants::LOW_ENOUGH_INT;
+		int upperBound = MathConstants::LARGE_ENOUGH_INT;
+		int passes = 0;
+
+		// move that caused the last fail high, which is the best move once the bounds meet
+		Move bestMove = INVALID_MOVE;
+
+		while(lowerBound < upperBound)
+		{
+			int beta = (score == lowerBound) ? score + 1 : score;
+			score = searchRoot(gameState, moves, searchDepth, beta, bestMove);
+
+			if(searchControl.isStopped())	// search terminated, so the result of this pass is useless
+			{
+				break;
+			}
+
+			++passes;
+
+			if(score < beta)	// fail low
+			{
+				upperBound = score;
+			}
+			else				// fail high
+			{
+				lowerBound = score;
+			}
+		}
+		// =================  MTD(f) ALGORITHM ENDS HERE  =================
+
+		if(!searchControl.isStopped())	// managed to complete the search within time
+		{
+			score = lowerBound;
+
+			if(bestMove == INVALID_MOVE)	// can only happen if no pass ever failed high, in which case all moves are equally bad
+			{
+				bestMove = moves[0];
+			}
+
+			lastRootEvaluation = score;
+			iterationScores.push_back(score);
+			passesPerIteration.push_back(passes);
+			totalPasses += passes;
+			++totalIterations;
+
+			timeManager.iterationCompleted(score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+			reportIteration(searchDepth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+
+			// the search proved a win or a loss, and searched deep enough to be sure that there is no faster one. The best move
+			// then either wins as fast as possible, or postpones the loss as long as possible
+			if(SearchCore::isWinScore(score, WIN_EVALUATION) && SearchCore::getWinDistance(score, WIN_EVALUATION) <= searchDepth)
+			{
+				return bestMove;
+			}
+
+			// finished search, and didn't prove a win for either team, so save the new best result
+			bestMoveCompleteSearch = bestMove;
+		}
+		else
+		{
+			--searchDepth;	// since last search was unsuccessful, decrement this so GUI doesn't lie to us
+
+			// the previous best move is always tried first, so a move that failed high in this iteration is at least as good
+			if(!(bestMove == INVALID_MOVE))
+			{
+				bestMoveCompleteSearch = bestMove;
+			}
+		}
+
+		if(searchControl.isStopped() || (searchLimits.maxDepth > 0 && searchDepth >= searchLimits.maxDepth) ||
+			!timeManager.shouldStartNextIteration(searchControl.getElapsedMs()))		// search terminated, exceeding depth limit, or next iteration not expected to finish in time
+		{
+			clock.stop();
+			return bestMoveCompleteSearch;
+		}
+	}
+}
+
+int MTDf::getRootEvaluation()
+{
+	return lastRootEvaluation;
+}
+
+int MTDf::getWinEvaluation()
+{
+	return WIN_EVALUATION;
+}
+
+void MTDf::logEndOfMatchStats()
+{
+#ifdef LOG_STATS_END_OF_MATCH
+	LOG_MESSAGE("MTD(f) engine END OF GAME stats:")
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << totalNodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << totalTimeSpent << " ms")
+	LOG_MESSAGE(StringBuilder() << "Average passes per iteration:			" << ((totalIterations > 0) ? ((double)totalPasses / totalIterations) : 0.0))
+	LOG_MESSAGE("")
+#endif // LOG_STATS_END_OF_MATCH
+}
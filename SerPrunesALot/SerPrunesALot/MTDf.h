@@ -0,0 +1,114 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#include "AiEngine.h"
+#include "BoundsTable.h"
+#include "TimeManager.h"
+#include "Timer.hpp"
+
+/**
+ * Engine using MTD(f) inside Iterative Deepening.
+ *
+ * Every iteration converges on the minimax value of the root with a sequence of zero-window searches (passes) of a
+ * memory-enhanced alpha-beta, which stores a lower and an upper bound for every node in a Bounds Table so that
+ * consecutive passes can re-use each other's work. The first guess of every iteration is the score of the last iteration
+ * with the same parity, which takes over the role of the odd-even compensation in the Aspiration Search engine.
+ *
+ * Uses the same Evaluation Function, Killer Moves and Move Generator as the Aspiration Search engine, and the
+ * null-move pruning of the shared search core. Like the Aspiration Search engine, evaluates leaves directly, without
+ * quiescence search, so that both engines can be compared on the same scores.
+ */
+class MTDf : public AiEngine
+{
+public:
+	MTDf();
+
+	virtual Move chooseMove(GameState& gameState);
+
+	/** Returns the last depth that the algorithm managed to fully search */
+	int getLastSearchDepth();
+	/** Returns the number of seconds spent searching last time */
+	double getSecondsSearched();
+	/** Returns the number of zero-window passes required by every completed iteration during the last search (index 0 = depth 1) */
+	const std::vector<int>& getPassesPerIteration() const;
+	/**
+	 * Enables or disables null-move pruning (if USE_NULL_MOVE_PRUNING is defined; enabled by default). Null-move pruning
+	 * is forward pruning, so with it enabled MTD(f) may return different scores than the Aspiration Search engine, which
+	 * does not use it
+	 */
+	void setNullMovePruning(bool enabled);
+
+	virtual int getRootEvaluation();
+	virtual int getWinEvaluation();
+	virtual void logEndOfMatchStats();
+
+private:
+	/** The engine's table of lower and upper bounds */
+	BoundsTable boundsTable;
+
+	/** Table of killer moves */
+	std::vector<std::vector<Move>> killerMoves;
+
+	/** The number of zero-window passes required by every completed iteration during the last search */
+	std::vector<int> passesPerIteration;
+
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
+	Timer clock;
+
+	/** The evaluation of the root node during the last search */
+	int lastRootEvaluation;
+
+	/** Whether null-move pruning may be tried, see setNullMovePruning() */
+	bool nullMovePruning;
+
+	/** The default amount of time in milliseconds that the algorithm will spend search */
+	const int MIN_SEARCH_TIME_MS = 25000;
+	/** The default amount of time in milliseconds that the algorithm may spend on top of MIN_SEARCH_TIME_MS to complete or extend its search */
+	const int MAX_EXTRA_SEARCH_TIME_MS = 5000;
+
+	/** Decides how much time to spend on every move, and whether or not to start new iterations. Initialized after the constants above */
+	TimeManager timeManager;
+
+	// variables used for gathering and logging statistics
+	int64_t totalNodesVisited;
+	double totalTimeSpent;
+	int turnsPlayed;
+	int searchDepth;
+	int64_t totalPasses;
+	int64_t totalIterations;
+
+	/**
+	* Memory-enhanced alpha-beta search, given the game state, remaining search depth, distance from the root, and current alpha and beta values.
+	* If nullMoveAllowed is false, null-move pruning is not tried at this node.
+	* Returns the node's evaluation.
+	*/
+	int alphaBetaWithMemory(GameState& gameState, int depth, int ply, int alpha, int beta, bool nullMoveAllowed = true);
+
+	/**
+	* Runs a single zero-window pass of MTD(f) over the given root moves, testing whether the value of the root is at least beta.
+	* Moves the move that caused a fail high to the front of the moves vector, and stores it in bestMove.
+	* Returns the result of the pass (a lower bound if >= beta, an upper bound otherwise).
+	*/
+	int searchRoot(GameState& gameState, std::vector<Move>& moves, int depth, int beta, Move& bestMove);
+
+	/**
+	* Returns an evaluation of the given game state.
+	*
+	* Assumes that the game state should be evaluated from the perspective of the ''currentPlayer'' value in the game state.
+	*/
+	int evaluate(const GameState& gameState) const;
+
+	/** Same as above, but requires passing an additional winner argument. Optimization if winner has already been determined in calling code */
+	int evaluate(const GameState& gameState, EPlayerColors::Type winner) const;
+
+	/** Stores the given move as a killer move for the given depth */
+	void storeKillerMove(int depth, const Move& move);
+
+	/**
+	* Starts search, given the current game state.
+	* Returns the best Move to play
+	*/
+	Move startMTDf(GameState& gameState);
+};
@@ -0,0 +1,138 @@
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+MemoryMappedFile::MemoryMappedFile()
+	: data(nullptr),
+	size(0),
+#ifdef _WIN32
+	fileHandle(INVALID_HANDLE_VALUE),
+	mappingHandle(nullptr)
+#else
+	fileDescriptor(-1)
+#endif // _WIN32
+{}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+bool MemoryMappedFile::open(const std::string& fileName)
+{
+	close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+	if(fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if(mappingHandle == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	size = (uint64_t)fileSize.QuadPart;
+#else
+	fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+	if(fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+
+	if(fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		close();
+		return false;
+	}
+
+	void* mapping = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	data = (mapping == MAP_FAILED) ? nullptr : static_cast<const uint8_t*>(mapping);
+	size = (uint64_t)fileStatus.st_size;
+#endif // _WIN32
+
+	if(data == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MemoryMappedFile::close()
+{
+#ifdef _WIN32
+	if(data != nullptr)
+	{
+		UnmapViewOfFile(data);
+	}
+
+	if(mappingHandle != nullptr)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+
+	if(fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(data != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(data), (size_t)size);
+	}
+
+	if(fileDescriptor >= 0)
+	{
+		::close(fileDescriptor);
+		fileDescriptor = -1;
+	}
+#endif // _WIN32
+
+	data = nullptr;
+	size = 0;
+}
+
+bool MemoryMappedFile::isOpen() const
+{
+	return (data != nullptr);
+}
+
+const uint8_t* MemoryMappedFile::getData() const
+{
+	return data;
+}
+
+uint64_t MemoryMappedFile::getSize() const
+{
+	return size;
+}
\ No newline at end of file
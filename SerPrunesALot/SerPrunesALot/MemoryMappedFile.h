@@ -0,0 +1,52 @@
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+
+/**
+ * A file that is mapped read-only into memory.
+ *
+ * Pages of the file are only read from disk once they are accessed, and are shared by all mappings of the same file
+ * (also those of other processes), so large read-only tables can be used without loading them into memory first.
+ */
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile();
+	~MemoryMappedFile();
+
+	/** Maps the file with the given name into memory, closing any previously mapped file first. Returns false if that failed */
+	bool open(const std::string& fileName);
+
+	/** Unmaps the file, if one is mapped */
+	void close();
+
+	/** Returns true iff a file is currently mapped */
+	bool isOpen() const;
+
+	/** Returns a pointer to the contents of the mapped file, or nullptr if no file is mapped */
+	const uint8_t* getData() const;
+
+	/** Returns the size of the mapped file in bytes */
+	uint64_t getSize() const;
+
+private:
+	/** The contents of the mapped file */
+	const uint8_t* data;
+	/** The size of the mapped file in bytes */
+	uint64_t size;
+
+#ifdef _WIN32
+	/** Handle of the opened file */
+	void* fileHandle;
+	/** Handle of the file mapping object */
+	void* mappingHandle;
+#else
+	/** Descriptor of the opened file. -1 = no file opened */
+	int fileDescriptor;
+#endif // _WIN32
+
+	// don't want accidental copying of the mapping
+	MemoryMappedFile(const MemoryMappedFile&);
+	MemoryMappedFile& operator=(const MemoryMappedFile&);
+};
\ No newline at end of file
@@ -0,0 +1,868 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "BatchPlayout.h"
+#include "Bitboards.hpp"
+#include "Logger.h"
+#include "MonteCarloTreeSearch.h"
+#include "SearchCore.h"
+
+/**
+ * The evaluation corresponding to a won game.
+ * The engine does not know the distance to the wins it proves, so they are reported as the slowest win that is still
+ * recognized as a win (see SearchCore::isWinScore())
+ */
+#define WIN_EVALUATION 1900
+
+/** Win rates are reported as evaluations in [-MCTS_EVALUATION_SCALE, MCTS_EVALUATION_SCALE], well below any win score */
+#define MCTS_EVALUATION_SCALE 1000
+
+/** The exploration constant C of the UCT formula: win rate + C * sqrt(ln(parent visits) / visits) */
+#define MCTS_EXPLORATION 0.4
+
+/** The number of visits of a leaf after which it is expanded. Leaves visited less often only run playouts */
+#define MCTS_EXPANSION_VISITS 8
+
+/** The number of losses added to every node on the path of a running playout, and removed again once it completes */
+#define MCTS_VIRTUAL_LOSS 3
+
+/**
+ * The number of playouts of every leaf. With batched playouts, a leaf is played out often enough at once to fill both
+ * groups of lanes of the kernel with AVX-512, which costs about as much time as a single playout one game at a time
+ */
+#ifdef USE_BATCH_PLAYOUTS
+#define MCTS_LEAF_PLAYOUTS 16
+#else
+#define MCTS_LEAF_PLAYOUTS 1
+#endif // USE_BATCH_PLAYOUTS
+
+/** Marks that selectChild() did not find a child that can be selected */
+#define MCTS_NO_CHILD 0xFFFFFFFF
+
+namespace
+{
+	/** The number of directions in which a knight can move forwards */
+	const int NUM_DIRECTIONS = 4;
+	/** The shifts of the bitboard of the player to move for every direction */
+	const int DIRECTION_SHIFTS[2][NUM_DIRECTIONS] = {
+		{10, 6, 17, 15},		// black moves towards higher indices
+		{6, 10, 15, 17}			// white moves towards lower indices
+	};
+	/** The squares that knights cannot reach in every direction, because they would wrap around the board */
+	const uint64_t DIRECTION_MASKS[NUM_DIRECTIONS] = {
+		~(Bitboards::FILE_A | Bitboards::FILE_B),
+		~(Bitboards::FILE_G | Bitboards::FILE_H),
+		~Bitboards::FILE_A,
+		~Bitboards::FILE_H
+	};
+
+	/** Returns the index of the given player in the direction tables */
+	inline int getColorIndex(EPlayerColors::Type player)
+	{
+		return (player == EPlayerColors::Type::BLACK_PLAYER) ? 0 : 1;
+	}
+
+	/** Returns the squares that the given knights of the player with the given index can move to in the given direction */
+	inline uint64_t getDirectionTargets(int colorIndex, uint64_t knights, int direction)
+	{
+		uint64_t shifted = (colorIndex == 0) ? (knights << DIRECTION_SHIFTS[0][direction]) : (knights >> DIRECTION_SHIFTS[1][direction]);
+		return shifted & DIRECTION_MASKS[direction];
+	}
+
+	/** Returns the square that a knight of the player with the given index moved from to reach the given square in the given direction */
+	inline int getDirectionOrigin(int colorIndex, int to, int direction)
+	{
+		return (colorIndex == 0) ? (to - DIRECTION_SHIFTS[0][direction]) : (to + DIRECTION_SHIFTS[1][direction]);
+	}
+
+	/** Returns the index of the n-th (0-based) bit that is set in the given bitset */
+	inline int selectBit(uint64_t bitset, uint32_t n)
+	{
+		for(uint32_t i = 0; i < n; ++i)
+		{
+			bitset &= bitset - 1;
+		}
+
+		return Bitboards::bitScanForward(bitset);
+	}
+
+	/** Applies the move leading to the given node, made by the player with the given index, to the given bitboards (black, white) */
+	inline void applyNodeMove(uint64_t bitboards[2], int colorIndex, const MctsNode& node)
+	{
+		bitboards[colorIndex] ^= Bitboards::singleBit(node.from) | Bitboards::singleBit(node.to);
+		bitboards[1 - colorIndex] &= ~Bitboards::singleBit(node.to);
+	}
+
+	/**
+	 * Chooses one of the given targets (per direction) uniformly at random, and returns its square and direction.
+	 * The given total must be the number of targets in all directions together, and must be positive
+	 */
+	inline void chooseTarget(const uint64_t targets[NUM_DIRECTIONS], int total, RNG::FastGenerator_64& random, int& to, int& direction)
+	{
+		uint32_t n = random.randomBelow(total);
+
+		for(direction = 0; direction < NUM_DIRECTIONS - 1; ++direction)
+		{
+			uint32_t count = Bitboards::popCount(targets[direction]);
+
+			if(n < count)
+			{
+				break;
+			}
+
+			n -= count;
+		}
+
+		to = selectBit(targets[direction], n);
+	}
+}
+
+MonteCarloTreeSearch::MonteCarloTreeSearch()
+	: currentArena(0),
+	numNodesUsed(0),
+	rootBlackBitboard(0),
+	rootWhiteBitboard(0),
+	rootPlayer(EPlayerColors::Type::NOTHING),
+	hasTree(false),
+	numThreads(std::max(1, std::min((int)std::thread::hardware_concurrency(), MCTS_MAX_THREADS))),
+	numPlayouts(0),
+	clock(),
+	lastRootEvaluation(0),
+	timeManager(MIN_SEARCH_TIME_MS, MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS),
+	totalPlayouts(0),
+	totalTimeSpent(0.0),
+	turnsPlayed(0)
+#ifdef GATHER_STATISTICS
+	, reusedNodes(0),
+	provenLeaves(0)
+#endif // GATHER_STATISTICS
+{
+}
+
+Move MonteCarloTreeSearch::chooseMove(GameState& gameState)
+{
+	clock.start();
+	timeManager.startMove(searchLimits, gameState);
+	// there are no iterations to complete, so the search simply runs until the target time
+	searchControl.startSearch(0, timeManager.getTargetTimeMs(), 0);
+
+	if(gameState.getWinner() != EPlayerColors::Type::NOTHING)
+	{
+		return INVALID_MOVE;		// can't return any normal move if game already ended
+	}
+
+	allocateArenas();
+	reuseTree(gameState);
+	numPlayouts = 0;
+
+	// the root is expanded before starting, so that there is a move to play even if the search is stopped right away
+	MctsNode& root = arenas[currentArena][0];
+	if(root.expansionState == 0)
+	{
+		int colorIndex = getColorIndex(rootPlayer);
+		uint64_t rootBitboards[2] = {rootBlackBitboard, rootWhiteBitboard};
+		root.expansionState = 1;
+
+		if(expand(root, rootBitboards[colorIndex], rootBitboards[1 - colorIndex], rootPlayer))
+		{
+			root.expansionState = 2;
+			updateProof(root);
+		}
+	}
+
+#ifdef GATHER_STATISTICS
+	provenLeaves = 0;
+#endif // GATHER_STATISTICS
+
+	std::vector<std::thread> threads;
+	for(int i = 1; i < numThreads; ++i)
+	{
+		threads.push_back(std::thread(&MonteCarloTreeSearch::searchThread, this, i));
+	}
+
+	searchThread(0);
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	const MctsNode* arena = arenas[currentArena].data();
+
+	if(root.numChildren == 0)		// no legal moves
+	{
+		clock.stop();
+		return INVALID_MOVE;
+	}
+
+	const MctsNode& bestChild = arena[getBestChild()];
+	Move bestMove(bestChild.from, bestChild.to, bestChild.captured != 0);
+
+	// the root's statistics are from the perspective of the opponent, who moved into it
+	if(root.proof == EMctsProof::Type::PROVEN_LOSS)
+	{
+		lastRootEvaluation = SearchCore::getWinScore(MAX_WIN_DISTANCE - 1, WIN_EVALUATION);
+	}
+	else if(root.proof == EMctsProof::Type::PROVEN_WIN)
+	{
+		lastRootEvaluation = -SearchCore::getWinScore(MAX_WIN_DISTANCE - 1, WIN_EVALUATION);
+	}
+	else
+	{
+		double winRate = (bestChild.visits > 0) ? ((double)bestChild.wins / bestChild.visits) : 0.5;
+		lastRootEvaluation = (int)((2.0 * winRate - 1.0) * MCTS_EVALUATION_SCALE);
+	}
+
+	clock.stop();
+	reportIteration(0, lastRootEvaluation, bestMove, numPlayouts, clock.getElapsedTimeInMilliSec());
+
+#ifdef GATHER_STATISTICS
+#ifdef LOG_STATS_PER_TURN
+	if(gameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		LOG_MESSAGE(StringBuilder() << "Monte Carlo Tree Search engine searching move for Black Player")
+	}
+	else
+	{
+		LOG_MESSAGE(StringBuilder() << "Monte Carlo Tree Search engine searching move for White Player")
+	}
+
+	LOG_MESSAGE(StringBuilder() << "Number of playouts:				" << numPlayouts)
+	LOG_MESSAGE(StringBuilder() << "Playouts per second:				" << (numPlayouts / clock.getElapsedTimeInSec()))
+	LOG_MESSAGE(StringBuilder() << "Threads:					" << numThreads)
+	LOG_MESSAGE(StringBuilder() << "Nodes in tree / reused:			" << std::min((uint32_t)numNodesUsed, (uint32_t)MCTS_NUM_NODES) << " / " << reusedNodes)
+	LOG_MESSAGE(StringBuilder() << "Playouts ending in proven nodes:		" << provenLeaves)
+	LOG_MESSAGE(StringBuilder() << "Root proof (0 = unknown, 1 = lost, 2 = won):	" << (int)root.proof)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << clock.getElapsedTimeInMilliSec() << " ms")
+	LOG_MESSAGE("")
+#endif // LOG_STATS_PER_TURN
+
+#ifdef LOG_STATS_END_OF_MATCH
+	totalPlayouts += numPlayouts;
+	totalTimeSpent += clock.getElapsedTimeInMilliSec();
+	++turnsPlayed;
+#endif // LOG_STATS_END_OF_MATCH
+#endif // GATHER_STATISTICS
+
+	return bestMove;
+}
+
+int64_t MonteCarloTreeSearch::getNumPlayouts() const
+{
+	return numPlayouts;
+}
+
+double MonteCarloTreeSearch::getSecondsSearched()
+{
+	return clock.getElapsedTimeInSec();
+}
+
+int MonteCarloTreeSearch::getRootEvaluation()
+{
+	return lastRootEvaluation;
+}
+
+int MonteCarloTreeSearch::getWinEvaluation()
+{
+	return WIN_EVALUATION;
+}
+
+void MonteCarloTreeSearch::logEndOfMatchStats()
+{
+#ifdef LOG_STATS_END_OF_MATCH
+	LOG_MESSAGE("Monte Carlo Tree Search engine END OF GAME stats:")
+	LOG_MESSAGE(StringBuilder() << "Number of playouts:				" << totalPlayouts)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << totalTimeSpent << " ms")
+	LOG_MESSAGE(StringBuilder() << "Average playouts per second:			" << (totalPlayouts / (totalTimeSpent / 1000.0)))
+	LOG_MESSAGE("")
+#endif // LOG_STATS_END_OF_MATCH
+}
+
+EPlayerColors::Type MonteCarloTreeSearch::playout(uint64_t blackBitboard, uint64_t whiteBitboard, EPlayerColors::Type playerToMove, RNG::FastGenerator_64& random)
+{
+	EPlayerColors::Type player = playerToMove;
+	EPlayerColors::Type opponent = (player == EPlayerColors::Type::BLACK_PLAYER) ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+	uint64_t playerBitboard = (player == EPlayerColors::Type::BLACK_PLAYER) ? blackBitboard : whiteBitboard;
+	uint64_t opponentBitboard = (player == EPlayerColors::Type::BLACK_PLAYER) ? whiteBitboard : blackBitboard;
+	uint64_t playerDangerZone = MoveGenerator::getDangerZone(player);
+	uint64_t opponentDangerZone = MoveGenerator::getDangerZone(opponent);
+
+	while(true)
+	{
+		if(playerBitboard & playerDangerZone)		// we can move to the goal row right away
+		{
+			return player;
+		}
+
+		int colorIndex = getColorIndex(player);
+		int from;
+		int to;
+		uint64_t threats = opponentBitboard & opponentDangerZone;
+
+		if(threats)		// the opponent wins on its next move, unless we capture the only threatening knight
+		{
+			// knights attacking the threat are found by moving from the threat in the opposite direction
+			uint64_t capturers = (Bitboards::isSingleBit(threats)) ? (playerBitboard & MoveGenerator::getKnightTargets(opponent, threats)) : Bitboards::ALL_ZERO;
+
+			if(!capturers)
+			{
+				return opponent;
+			}
+
+			from = selectBit(capturers, random.randomBelow(Bitboards::popCount(capturers)));
+			to = Bitboards::bitScanForward(threats);
+		}
+		else
+		{
+			uint64_t targets[NUM_DIRECTIONS];
+			int total = 0;
+
+			for(int direction = 0; direction < NUM_DIRECTIONS; ++direction)
+			{
+				targets[direction] = getDirectionTargets(colorIndex, playerBitboard, direction) & opponentBitboard;
+				total += Bitboards::popCount(targets[direction]);
+			}
+
+			if(total == 0)		// no captures, so choose among the quiet moves
+			{
+				for(int direction = 0; direction < NUM_DIRECTIONS; ++direction)
+				{
+					targets[direction] = getDirectionTargets(colorIndex, playerBitboard, direction) & ~(playerBitboard | opponentBitboard);
+					total += Bitboards::popCount(targets[direction]);
+				}
+
+				if(total == 0)		// a player without any legal moves has lost
+				{
+					return opponent;
+				}
+			}
+
+			int direction;
+			chooseTarget(targets, total, random, to, direction);
+			from = getDirectionOrigin(colorIndex, to, direction);
+		}
+
+		playerBitboard ^= Bitboards::singleBit(from) | Bitboards::singleBit(to);
+		opponentBitboard &= ~Bitboards::singleBit(to);
+
+		if(!opponentBitboard)		// captured the last knight
+		{
+			return player;
+		}
+
+		std::swap(player, opponent);
+		std::swap(playerBitboard, opponentBitboard);
+		std::swap(playerDangerZone, opponentDangerZone);
+	}
+}
+
+void MonteCarloTreeSearch::searchThread(int threadIndex)
+{
+	// every thread needs its own sequence of random numbers
+	RNG::FastGenerator_64 random((RNG::randomUint_64() ^ (0x9E3779B97F4A7C15ULL * (threadIndex + 1))) | 1);
+
+	while(!searchControl.isStopped())
+	{
+		// the node counter of the search control is not shared between threads, so only one thread uses it to check the clock
+		if(threadIndex == 0 && searchControl.visitNode())
+		{
+			break;
+		}
+
+		if(searchLimits.maxNodes > 0 && numPlayouts >= searchLimits.maxNodes)
+		{
+			break;
+		}
+
+		if(!runIteration(random))		// the root is proven, so there is nothing left to search
+		{
+			break;
+		}
+	}
+}
+
+bool MonteCarloTreeSearch::runIteration(RNG::FastGenerator_64& random)
+{
+	MctsNode* arena = arenas[currentArena].data();
+
+	if(arena[0].proof != EMctsProof::Type::UNKNOWN)
+	{
+		return false;
+	}
+
+	uint32_t path[MCTS_MAX_TREE_DEPTH + 1];
+	int pathLength = 0;
+	uint64_t bitboards[2] = {rootBlackBitboard, rootWhiteBitboard};
+	EPlayerColors::Type player = rootPlayer;
+	uint32_t nodeIndex = 0;
+
+	path[pathLength++] = 0;
+	arena[0].visits += MCTS_VIRTUAL_LOSS;
+
+	// selection: descend through the expanded nodes, expanding the leaf if it was visited often enough
+	while(pathLength <= MCTS_MAX_TREE_DEPTH)
+	{
+		MctsNode& node = arena[nodeIndex];
+
+		if(node.expansionState.load(std::memory_order_acquire) != 2)
+		{
+			uint8_t notExpanded = 0;
+
+			if(node.visits >= MCTS_EXPANSION_VISITS &&
+				node.expansionState.compare_exchange_strong(notExpanded, 1))
+			{
+				int colorIndex = getColorIndex(player);
+
+				// if the arena is full, the expansion state stays 1, so that the node is never expanded
+				if(!expand(node, bitboards[colorIndex], bitboards[1 - colorIndex], player))
+				{
+					break;
+				}
+
+				node.expansionState.store(2, std::memory_order_release);
+				updateProof(node);
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		uint32_t childIndex = selectChild(node);
+		if(childIndex == MCTS_NO_CHILD)		// all children are proven losses, so this node is proven as well
+		{
+			break;
+		}
+
+		MctsNode& child = arena[childIndex];
+		applyNodeMove(bitboards, getColorIndex(player), child);
+		player = (player == EPlayerColors::Type::BLACK_PLAYER) ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+
+		child.visits += MCTS_VIRTUAL_LOSS;
+		path[pathLength++] = childIndex;
+		nodeIndex = childIndex;
+
+		if(child.proof != EMctsProof::Type::UNKNOWN)
+		{
+			break;
+		}
+	}
+
+	// simulation: proven nodes do not need a playout, because their result is known
+	MctsNode& leaf = arena[nodeIndex];
+	EPlayerColors::Type opponent = (player == EPlayerColors::Type::BLACK_PLAYER) ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+	int playerWins = 0;		// the number of playouts won by the player to move at the leaf
+	uint8_t leafProof = leaf.proof;
+
+	if(leafProof != EMctsProof::Type::UNKNOWN)
+	{
+#ifdef GATHER_STATISTICS
+		++provenLeaves;
+#endif // GATHER_STATISTICS
+
+		// a proven result counts as many times as the playouts it replaces
+		playerWins = (leafProof == EMctsProof::Type::PROVEN_WIN) ? 0 : MCTS_LEAF_PLAYOUTS;
+
+		// the MCTS-solver: back up the proof as far as it decides the ancestors
+		for(int i = pathLength - 2; i >= 0; --i)
+		{
+			if(!updateProof(arena[path[i]]))
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+#ifdef USE_BATCH_PLAYOUTS
+		uint64_t blackBitboards[MCTS_LEAF_PLAYOUTS];
+		uint64_t whiteBitboards[MCTS_LEAF_PLAYOUTS];
+		EPlayerColors::Type playersToMove[MCTS_LEAF_PLAYOUTS];
+		EPlayerColors::Type winners[MCTS_LEAF_PLAYOUTS];
+		std::fill(blackBitboards, blackBitboards + MCTS_LEAF_PLAYOUTS, bitboards[0]);
+		std::fill(whiteBitboards, whiteBitboards + MCTS_LEAF_PLAYOUTS, bitboards[1]);
+		std::fill(playersToMove, playersToMove + MCTS_LEAF_PLAYOUTS, player);
+
+		BatchPlayout::playout(blackBitboards, whiteBitboards, playersToMove, winners, MCTS_LEAF_PLAYOUTS, random);
+		playerWins = (int)std::count(winners, winners + MCTS_LEAF_PLAYOUTS, player);
+#else
+		playerWins = (playout(bitboards[0], bitboards[1], player, random) == player) ? 1 : 0;
+#endif // USE_BATCH_PLAYOUTS
+	}
+
+	// backpropagation: replace the virtual losses by the real results. The leaf was moved into by the opponent of the player
+	// to move at the leaf, and the movers alternate from there up to the root
+	EPlayerColors::Type mover = opponent;
+	for(int i = pathLength - 1; i >= 0; --i)
+	{
+		MctsNode& node = arena[path[i]];
+		node.visits += MCTS_LEAF_PLAYOUTS - MCTS_VIRTUAL_LOSS;
+		node.wins += (mover == player) ? playerWins : MCTS_LEAF_PLAYOUTS - playerWins;
+		mover = (mover == EPlayerColors::Type::BLACK_PLAYER) ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+	}
+
+	numPlayouts += MCTS_LEAF_PLAYOUTS;
+	return true;
+}
+
+uint32_t MonteCarloTreeSearch::selectChild(const MctsNode& node)
+{
+	const MctsNode* arena = arenas[currentArena].data();
+	double logParentVisits = std::log((double)std::max(node.visits.load(std::memory_order_relaxed), 1));
+	uint32_t bestChild = MCTS_NO_CHILD;
+	double bestValue = -1.0;
+
+	for(uint32_t i = node.firstChild; i < node.firstChild + node.numChildren; ++i)
+	{
+		const MctsNode& child = arena[i];
+		uint8_t proof = child.proof.load(std::memory_order_relaxed);
+
+		if(proof == EMctsProof::Type::PROVEN_WIN)		// always play a proven win
+		{
+			return i;
+		}
+		else if(proof == EMctsProof::Type::PROVEN_LOSS)		// never play a proven loss
+		{
+			continue;
+		}
+
+		int32_t visits = child.visits.load(std::memory_order_relaxed);
+		if(visits == 0)		// unvisited children are tried first
+		{
+			return i;
+		}
+
+		double value = (double)child.wins.load(std::memory_order_relaxed) / visits + MCTS_EXPLORATION * std::sqrt(logParentVisits / visits);
+
+		if(value > bestValue)
+		{
+			bestValue = value;
+			bestChild = i;
+		}
+	}
+
+	return bestChild;
+}
+
+bool MonteCarloTreeSearch::expand(MctsNode& node, uint64_t playerBitboard, uint64_t opponentBitboard, EPlayerColors::Type player)
+{
+	MoveGenerator moveGenerator(player, playerBitboard, opponentBitboard);
+	std::vector<Move> moves;
+	moves.reserve(16 * 4);
+
+	for(Move move = moveGenerator.nextMove(); !(move == INVALID_MOVE); move = moveGenerator.nextMove())
+	{
+		moves.push_back(move);
+	}
+
+	uint32_t firstChild = numNodesUsed.fetch_add((uint32_t)moves.size());
+	if(firstChild + moves.size() > MCTS_NUM_NODES)
+	{
+		return false;
+	}
+
+	MctsNode* arena = arenas[currentArena].data();
+	uint64_t goalRow = MoveGenerator::getGoalRow(player);
+	bool capturesLastKnight = Bitboards::isSingleBit(opponentBitboard);
+
+	for(size_t i = 0; i < moves.size(); ++i)
+	{
+		MctsNode& child = arena[firstChild + i];
+		initNode(child, moves[i]);
+
+		// moves that end the game are proven right away
+		if(Bitboards::isBitSet(goalRow, moves[i].to) || (moves[i].captured && capturesLastKnight))
+		{
+			child.proof = EMctsProof::Type::PROVEN_WIN;
+		}
+	}
+
+	node.firstChild = firstChild;
+	node.numChildren = (uint8_t)moves.size();
+	return true;
+}
+
+bool MonteCarloTreeSearch::updateProof(MctsNode& node)
+{
+	if(node.proof != EMctsProof::Type::UNKNOWN)
+	{
+		return true;
+	}
+
+	const MctsNode* arena = arenas[currentArena].data();
+	bool allChildrenLost = true;
+
+	for(uint32_t i = node.firstChild; i < node.firstChild + node.numChildren; ++i)
+	{
+		uint8_t proof = arena[i].proof;
+
+		if(proof == EMctsProof::Type::PROVEN_WIN)		// the player to move can win, so the player who moved here loses
+		{
+			node.proof = EMctsProof::Type::PROVEN_LOSS;
+			return true;
+		}
+		else if(proof != EMctsProof::Type::PROVEN_LOSS)
+		{
+			allChildrenLost = false;
+		}
+	}
+
+	// also covers nodes without any legal moves, in which the player to move has lost
+	if(allChildrenLost)
+	{
+		node.proof = EMctsProof::Type::PROVEN_WIN;
+		return true;
+	}
+
+	return false;
+}
+
+void MonteCarloTreeSearch::initNode(MctsNode& node, const Move& move)
+{
+	node.visits.store(0, std::memory_order_relaxed);
+	node.wins.store(0, std::memory_order_relaxed);
+	node.firstChild = 0;
+	node.from = (uint8_t)move.from;
+	node.to = (uint8_t)move.to;
+	node.captured = (move.captured) ? 1 : 0;
+	node.numChildren = 0;
+	node.expansionState.store(0, std::memory_order_relaxed);
+	node.proof.store(EMctsProof::Type::UNKNOWN, std::memory_order_relaxed);
+}
+
+void MonteCarloTreeSearch::allocateArenas()
+{
+	if(arenas[0].empty())
+	{
+		arenas[0] = std::vector<MctsNode>(MCTS_NUM_NODES);
+		arenas[1] = std::vector<MctsNode>(MCTS_NUM_NODES);
+	}
+}
+
+void MonteCarloTreeSearch::reuseTree(const GameState& gameState)
+{
+	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
+	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
+	EPlayerColors::Type player = gameState.getCurrentPlayer();
+	const MctsNode* arena = arenas[currentArena].data();
+	uint32_t newRoot = MCTS_NO_CHILD;
+
+	if(hasTree)
+	{
+		int rootColorIndex = getColorIndex(rootPlayer);
+
+		if(blackBitboard == rootBlackBitboard && whiteBitboard == rootWhiteBitboard && player == rootPlayer)		// searching the same position again
+		{
+			newRoot = 0;
+		}
+		else if(arena[0].expansionState == 2)
+		{
+			// the game continued with a child of the root (if we play both sides), or with a grandchild (after our move and the reply)
+			for(uint32_t c = arena[0].firstChild; c < arena[0].firstChild + arena[0].numChildren && newRoot == MCTS_NO_CHILD; ++c)
+			{
+				uint64_t childBitboards[2] = {rootBlackBitboard, rootWhiteBitboard};
+				applyNodeMove(childBitboards, rootColorIndex, arena[c]);
+
+				if(childBitboards[0] == blackBitboard && childBitboards[1] == whiteBitboard && player != rootPlayer)
+				{
+					newRoot = c;
+				}
+				else if(arena[c].expansionState == 2 && player == rootPlayer)
+				{
+					for(uint32_t g = arena[c].firstChild; g < arena[c].firstChild + arena[c].numChildren; ++g)
+					{
+						uint64_t grandchildBitboards[2] = {childBitboards[0], childBitboards[1]};
+						applyNodeMove(grandchildBitboards, 1 - rootColorIndex, arena[g]);
+
+						if(grandchildBitboards[0] == blackBitboard && grandchildBitboards[1] == whiteBitboard)
+						{
+							newRoot = g;
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if(newRoot != MCTS_NO_CHILD)
+	{
+		uint32_t numCopied = copySubtree(newRoot);
+		currentArena = 1 - currentArena;
+		numNodesUsed = numCopied;
+#ifdef GATHER_STATISTICS
+		reusedNodes = numCopied;
+#endif // GATHER_STATISTICS
+	}
+	else
+	{
+		initNode(arenas[currentArena][0], INVALID_MOVE);
+		numNodesUsed = 1;
+#ifdef GATHER_STATISTICS
+		reusedNodes = 0;
+#endif // GATHER_STATISTICS
+	}
+
+	rootBlackBitboard = blackBitboard;
+	rootWhiteBitboard = whiteBitboard;
+	rootPlayer = player;
+	hasTree = true;
+}
+
+uint32_t MonteCarloTreeSearch::copySubtree(uint32_t rootIndex)
+{
+	const MctsNode* source = arenas[currentArena].data();
+	MctsNode* destination = arenas[1 - currentArena].data();
+	std::vector<std::pair<uint32_t, uint32_t>> queue;
+
+	// children stay next to each other, because the children of a node are copied together
+	initNode(destination[0], INVALID_MOVE);
+	queue.push_back(std::make_pair(rootIndex, 0u));
+	uint32_t numCopied = 1;
+
+	for(size_t q = 0; q < queue.size(); ++q)
+	{
+		const MctsNode& sourceNode = source[queue[q].first];
+		MctsNode& destinationNode = destination[queue[q].second];
+
+		destinationNode.visits.store(sourceNode.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		destinationNode.wins.store(sourceNode.wins.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		destinationNode.from = sourceNode.from;
+		destinationNode.to = sourceNode.to;
+		destinationNode.captured = sourceNode.captured;
+		destinationNode.proof.store(sourceNode.proof.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+		// nodes that could not be expanded because the arena was full may be expanded in the new arena
+		if(sourceNode.expansionState.load(std::memory_order_relaxed) == 2)
+		{
+			destinationNode.firstChild = numCopied;
+			destinationNode.numChildren = sourceNode.numChildren;
+			destinationNode.expansionState.store(2, std::memory_order_relaxed);
+
+			for(uint32_t i = 0; i < sourceNode.numChildren; ++i)
+			{
+				queue.push_back(std::make_pair(sourceNode.firstChild + i, numCopied + i));
+			}
+
+			numCopied += sourceNode.numChildren;
+		}
+		else
+		{
+			destinationNode.firstChild = 0;
+			destinationNode.numChildren = 0;
+			destinationNode.expansionState.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	return numCopied;
+}
+
+uint32_t MonteCarloTreeSearch::getBestChild() const
+{
+	const MctsNode* arena = arenas[currentArena].data();
+	const MctsNode& root = arena[0];
+	uint32_t bestChild = root.firstChild;
+	bool bestLost = true;
+
+	for(uint32_t i = root.firstChild; i < root.firstChild + root.numChildren; ++i)
+	{
+		const MctsNode& child = arena[i];
+
+		if(child.proof == EMctsProof::Type::PROVEN_WIN)
+		{
+			return i;
+		}
+
+		// the most visited child that is not a proven loss, or the most visited child if all of them are lost
+		bool lost = (child.proof == EMctsProof::Type::PROVEN_LOSS);
+		if((bestLost && !lost) || (lost == bestLost && child.visits > arena[bestChild].visits))
+		{
+			bestChild = i;
+			bestLost = lost;
+		}
+	}
+
+	return bestChild;
+}
+
+double MonteCarloTreeSearch::getRootChildrenWinRate() const
+{
+	const MctsNode* arena = arenas[currentArena].data();
+	const MctsNode& root = arena[0];
+	int64_t wins = 0;
+	int64_t visits = 0;
+
+	for(uint32_t i = root.firstChild; i < root.firstChild + root.numChildren; ++i)
+	{
+		wins += arena[i].wins;
+		visits += arena[i].visits;
+	}
+
+	return (visits > 0) ? ((double)wins / visits) : 0.5;
+}
+
+bool MonteCarloTreeSearch::checkRootStatistics()
+{
+	// 16 knights on their own starting rows against 4 knights on the opponent's home row, with either player to move
+	const uint64_t STRONG_BLACK = Bitboards::ROW_8 | Bitboards::ROW_7;
+	const uint64_t WEAK_WHITE = Bitboards::singleBit(56) | Bitboards::singleBit(58) | Bitboards::singleBit(61) | Bitboards::singleBit(63);
+	const uint64_t STRONG_WHITE = Bitboards::ROW_1 | Bitboards::ROW_2;
+	const uint64_t WEAK_BLACK = Bitboards::singleBit(0) | Bitboards::singleBit(2) | Bitboards::singleBit(5) | Bitboards::singleBit(7);
+
+	const uint64_t blackBitboards[2] = {STRONG_BLACK, WEAK_BLACK};
+	const uint64_t whiteBitboards[2] = {WEAK_WHITE, STRONG_WHITE};
+	const EPlayerColors::Type players[2] = {EPlayerColors::Type::BLACK_PLAYER, EPlayerColors::Type::WHITE_PLAYER};
+	const int NUM_ITERATIONS = 2000;
+
+	MonteCarloTreeSearch engine;
+	engine.allocateArenas();
+	RNG::FastGenerator_64 random(0x4D435453ULL);
+	bool passed = true;
+
+	for(int position = 0; position < 2; ++position)
+	{
+		engine.rootBlackBitboard = blackBitboards[position];
+		engine.rootWhiteBitboard = whiteBitboards[position];
+		engine.rootPlayer = players[position];
+		engine.hasTree = false;
+		engine.currentArena = 0;
+		engine.numNodesUsed = 1;
+		initNode(engine.arenas[0][0], INVALID_MOVE);
+
+		MctsNode& root = engine.arenas[0][0];
+		int colorIndex = getColorIndex(engine.rootPlayer);
+		uint64_t rootBitboards[2] = {engine.rootBlackBitboard, engine.rootWhiteBitboard};
+		root.expansionState = 1;
+		engine.expand(root, rootBitboards[colorIndex], rootBitboards[1 - colorIndex], engine.rootPlayer);
+		root.expansionState = 2;
+
+		// unvisited children are selected first, so this plays out every child of the root exactly once
+		for(int i = 0; i < root.numChildren; ++i)
+		{
+			engine.runIteration(random);
+		}
+		double winRateOnePly = engine.getRootChildrenWinRate();
+
+		for(int i = 0; i < NUM_ITERATIONS && engine.runIteration(random); ++i)
+		{
+		}
+		double winRateSearched = engine.getRootChildrenWinRate();
+
+		const char* playerName = (players[position] == EPlayerColors::Type::BLACK_PLAYER) ? "Black" : "White";
+		LOG_MESSAGE(StringBuilder() << playerName << " to move with 16 knights against 4: win rate of the root children = "
+					<< winRateOnePly << " after one playout each, " << winRateSearched << " after " << NUM_ITERATIONS << " more iterations")
+
+		if(winRateOnePly <= 0.5 || winRateSearched <= 0.5)
+		{
+			LOG_ERROR(StringBuilder() << "MonteCarloTreeSearch::checkRootStatistics(): the root children of " << playerName
+					  << " do not win most of their playouts, so the results are backed up for the wrong player!")
+			passed = false;
+		}
+	}
+
+	return passed;
+}
\ No newline at end of file
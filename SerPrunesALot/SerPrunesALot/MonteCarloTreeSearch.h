@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <inttypes.h>
+#include <vector>
+
+#include "AiEngine.h"
+#include "RNG.h"
+#include "TimeManager.h"
+#include "Timer.hpp"
+
+/** The number of nodes in each of the two node arenas of the Monte Carlo Tree Search engine */
+#define MCTS_NUM_NODES (1 << 22)
+
+/** The maximum number of threads that the Monte Carlo Tree Search engine searches with */
+#define MCTS_MAX_THREADS 64
+
+/** The maximum number of plies from the root to a leaf of the tree (a game cannot last longer than 6 * 16 * 2 plies) */
+#define MCTS_MAX_TREE_DEPTH 192
+
+/** The results of a node in the tree that the MCTS-solver can prove */
+namespace EMctsProof
+{
+	enum Type
+	{
+		/** The result is not known yet */
+		UNKNOWN,
+		/** The player who made the move leading to the node wins */
+		PROVEN_WIN,
+		/** The player who made the move leading to the node loses */
+		PROVEN_LOSS
+	};
+}
+
+/**
+ * A node of the Monte Carlo search tree, stored in a node arena.
+ *
+ * All statistics are kept from the perspective of the player who made the move leading to the node, so that a parent can
+ * directly compare the statistics of its children. The statistics are atomic, because the tree is shared by all threads.
+ */
+struct MctsNode
+{
+	/** The number of playouts through this node, including the virtual losses of playouts that are still running */
+	std::atomic<int32_t> visits;
+	/** The number of playouts through this node won by the player who made the move leading to it */
+	std::atomic<int32_t> wins;
+	/** Index of the first child in the arena. The children are stored consecutively */
+	uint32_t firstChild;
+	/** The square of the knight moved to reach this node */
+	uint8_t from;
+	/** The square the knight was moved to */
+	uint8_t to;
+	/** 1 if the move captured a knight, 0 otherwise */
+	uint8_t captured;
+	/** The number of children. Only valid once the node is expanded */
+	uint8_t numChildren;
+	/** 0 = not expanded, 1 = being expanded by some thread, 2 = expanded */
+	std::atomic<uint8_t> expansionState;
+	/** The result proven by the MCTS-solver, see EMctsProof */
+	std::atomic<uint8_t> proof;
+};
+
+/**
+ * Engine using Monte Carlo Tree Search with the UCT selection policy.
+ *
+ * Every iteration descends the tree by choosing the child with the highest upper confidence bound on its win rate, expands
+ * the reached leaf once it has been visited often enough, plays the game out to the end with a fast randomized policy, and
+ * backs up the result along the path. Playouts run on bare bitboards: a player always wins right away if it can, captures a
+ * knight that threatens to win if it can, and otherwise prefers captures over quiet moves, choosing uniformly at random
+ * within each category. With USE_BATCH_PLAYOUTS, every leaf is played out many times at once by the vectorized kernel of
+ * BatchPlayout instead.
+ *
+ * Nodes are allocated from a fixed arena, with all children of a node stored next to each other. After every search, the
+ * subtree of the move that was played is kept, and at the next search, the subtree of the opponent's reply becomes the new
+ * root. It is copied into a second arena, so that the nodes of all other subtrees are freed at once.
+ *
+ * The MCTS-solver backs up proven results: a node is a loss for the player who moved into it if any of its children is a
+ * win for the player to move, and a win if all of its children are losses. Proven losses are never selected again, and
+ * the search stops as soon as the root is proven.
+ *
+ * Multiple threads search the same tree (tree parallelization). Every thread adds virtual losses to the nodes on its path
+ * while its playout is running, which steers other threads to different parts of the tree.
+ */
+class MonteCarloTreeSearch : public AiEngine
+{
+public:
+	MonteCarloTreeSearch();
+
+	virtual Move chooseMove(GameState& gameState);
+
+	/** Returns the number of playouts run during the last search */
+	int64_t getNumPlayouts() const;
+	/** Returns the number of seconds spent searching last time */
+	double getSecondsSearched();
+
+	virtual int getRootEvaluation();
+	virtual int getWinEvaluation();
+	virtual void logEndOfMatchStats();
+
+	/**
+	 * Plays the position with the given bitboards out to the end with the playout policy, and returns the winner.
+	 * The player to move must not have lost already
+	 */
+	static EPlayerColors::Type playout(uint64_t blackBitboard, uint64_t whiteBitboard, EPlayerColors::Type playerToMove, RNG::FastGenerator_64& random);
+
+	/**
+	 * Headless check of the statistics that the search backs up: searches positions in which the player to move has 16 knights
+	 * against 4, and checks that the root children, whose statistics are those of the player to move, win more than half of
+	 * their playouts. Checks this once every child was played out from the root (so the leaves are at an odd ply), and again
+	 * after a longer search (so the leaves are at all depths). Logs the win rates, and returns true iff all checks passed
+	 */
+	static bool checkRootStatistics();
+
+private:
+	/**
+	 * The two node arenas. The tree of the current search is in arenas[currentArena], with the root at index 0.
+	 * They are only allocated by the first search (see allocateArenas()), so engines that are never used take up no memory
+	 */
+	std::vector<MctsNode> arenas[2];
+	/** The arena that the current tree is stored in */
+	int currentArena;
+	/** The number of nodes allocated from the current arena */
+	std::atomic<uint32_t> numNodesUsed;
+
+	/** The position at the root of the tree, kept to find the subtree that can be reused in the next search */
+	uint64_t rootBlackBitboard;
+	uint64_t rootWhiteBitboard;
+	EPlayerColors::Type rootPlayer;
+	/** True iff the tree contains the results of a previous search */
+	bool hasTree;
+
+	/** The number of threads to search with */
+	int numThreads;
+
+	/** The number of playouts run during the current search, by all threads */
+	std::atomic<int64_t> numPlayouts;
+
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
+	Timer clock;
+
+	/** The evaluation of the root node during the last search */
+	int lastRootEvaluation;
+
+	/** The default amount of time in milliseconds that the algorithm will spend search */
+	const int MIN_SEARCH_TIME_MS = 25000;
+	/** The default amount of time in milliseconds that the algorithm may spend on top of MIN_SEARCH_TIME_MS */
+	const int MAX_EXTRA_SEARCH_TIME_MS = 5000;
+
+	/** Decides how much time to spend on every move. Initialized after the constants above */
+	TimeManager timeManager;
+
+	// variables used for gathering and logging statistics
+	int64_t totalPlayouts;
+	double totalTimeSpent;
+	int turnsPlayed;
+
+#ifdef GATHER_STATISTICS
+	/** Number of nodes of the tree that were reused from the previous search */
+	int64_t reusedNodes;
+	/** Number of playouts that reached a node that was already proven, so no playout was run */
+	std::atomic<int64_t> provenLeaves;
+#endif // GATHER_STATISTICS
+
+	/** Runs iterations on the shared tree until the search is stopped. Thread 0 also polls the search control */
+	void searchThread(int threadIndex);
+
+	/** Runs a single iteration from the root. Returns false if the iteration could not run, because the root is proven */
+	bool runIteration(RNG::FastGenerator_64& random);
+
+	/** Selects the child of the given expanded node to descend into */
+	uint32_t selectChild(const MctsNode& node);
+
+	/**
+	 * Expands the given node of the given position. Returns false if the arena is full, in which case the node stays a leaf.
+	 * Must only be called by the thread that changed the expansion state of the node to 1
+	 */
+	bool expand(MctsNode& node, uint64_t playerBitboard, uint64_t opponentBitboard, EPlayerColors::Type player);
+
+	/** Updates the proven result of the given expanded node from its children. Returns true iff the node is proven now */
+	bool updateProof(MctsNode& node);
+
+	/** Initializes a freshly allocated node for the given move */
+	static void initNode(MctsNode& node, const Move& move);
+
+	/** Allocates both node arenas, if that was not done yet */
+	void allocateArenas();
+
+	/**
+	 * Makes the subtree of the given game state, if it is found in the tree within two plies of the current root, the root of
+	 * a new tree in the other arena. Starts a new tree with only a root node otherwise
+	 */
+	void reuseTree(const GameState& gameState);
+
+	/** Copies the subtree rooted at the given node of the current arena into the other arena, with the root at index 0 */
+	uint32_t copySubtree(uint32_t rootIndex);
+
+	/** Returns the index of the child of the root that should be played */
+	uint32_t getBestChild() const;
+
+	/** Returns the fraction of the playouts through the children of the root that were won by the player to move at the root */
+	double getRootChildrenWinRate() const;
+};
\ No newline at end of file
@@ -1,5 +1,24 @@
+#include "BoardUtils.hpp"
 #include "Move.h"
 
 Move::Move(int from, int to, bool captured)
 	: from(from), to(to), captured(captured)
-{}
\ No newline at end of file
+{}
+
+std::string Move::toString() const
+{
+	if(from < 0 || to < 0)
+	{
+		return "INVALID";
+	}
+
+	// columns are named A - H from left to right, rows are numbered 8 - 1 from top to bottom
+	std::string result;
+	result += (char)('A' + BoardUtils::x(from));
+	result += (char)('0' + BOARD_HEIGHT - BoardUtils::y(from));
+	result += (captured) ? 'x' : '-';
+	result += (char)('A' + BoardUtils::x(to));
+	result += (char)('0' + BOARD_HEIGHT - BoardUtils::y(to));
+
+	return result;
+}
\ No newline at end of file
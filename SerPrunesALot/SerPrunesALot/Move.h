@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 /**
  * A Move in the game of KnightThrough.
  * A Move consists of:
@@ -18,6 +20,9 @@ struct Move
 
 	Move(int from, int to, bool captured);
 
+	/** Returns a human-readable representation of the move, such as ''B1-C3'' (or ''B1xC3'' for captures) */
+	std::string toString() const;
+
 	/** Overloaded == operator. Considers two objects to be equal iff all fields are equal */
 	inline bool operator==(const Move& other) const
 	{
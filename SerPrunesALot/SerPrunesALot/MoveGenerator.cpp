@@ -5,26 +5,34 @@
 #include <algorithm>
 
 MoveGenerator::MoveGenerator(EPlayerColors::Type playerColor, uint64_t playerBitboard, uint64_t opponentBitboard,
-														Move transpositionMove, Move killerMove1, Move killerMove2)
+														Move transpositionMove, Move killerMove1, Move killerMove2,
+														const HistoryTable* historyTable, Move countermove, Move excludedMove)
 	: moves(),
 	transpositionMove(transpositionMove),
 	killerMove1(killerMove1),
 	killerMove2(killerMove2),
+	countermove(countermove),
+	excludedMove(excludedMove),
+	historyTable(historyTable),
 	playerBitboard(playerBitboard),
 	opponentBitboard(opponentBitboard),
 	playerColor(playerColor),
 	moveIndex(0),
+	numCaptureMoves(0),
+	numMovesReturned(0),
+	hasTranspositionMove(false),
 	generatedMoves(false)
 {
 	moves.reserve(16 * 4);		// upper bound on number of possible moves
 
 	// Add move from TT and any Killer Moves
-	if(!(transpositionMove == INVALID_MOVE))
+	if(!(transpositionMove == INVALID_MOVE) && !(transpositionMove == excludedMove))
 	{
 		moves.push_back(transpositionMove);
+		hasTranspositionMove = true;
 	}
 	
-	if(!(killerMove1 == INVALID_MOVE) && !(killerMove1 == transpositionMove))
+	if(!(killerMove1 == INVALID_MOVE) && !(killerMove1 == transpositionMove) && !(killerMove1 == excludedMove))
 	{
 		// check if killer move is actually valid
 		uint64_t fromBit = Bitboards::singleBit(killerMove1.from);
@@ -42,7 +50,7 @@ MoveGenerator::MoveGenerator(EPlayerColors::Type playerColor, uint64_t playerBit
 		}
 	}
 
-	if(!(killerMove2 == INVALID_MOVE) && !(killerMove2 == killerMove1) && !(killerMove2 == transpositionMove))
+	if(!(killerMove2 == INVALID_MOVE) && !(killerMove2 == killerMove1) && !(killerMove2 == transpositionMove) && !(killerMove2 == excludedMove))
 	{
 		// check if killer move is actually valid
 		uint64_t fromBit = Bitboards::singleBit(killerMove2.from);
@@ -92,7 +100,7 @@ Move MoveGenerator::nextMove()
 					{
 						Move move(knightSquare, moveTarget, true);
 
-						if(!(move == transpositionMove) && !(move == killerMove1) && !(move == killerMove2))
+						if(!(move == transpositionMove) && !(move == killerMove1) && !(move == killerMove2) && !(move == excludedMove))
 						{
 							moves.push_back(move);
 						}
@@ -101,7 +109,7 @@ Move MoveGenerator::nextMove()
 					{
 						Move move(knightSquare, moveTarget, false);
 
-						if(!(move == transpositionMove) && !(move == killerMove1) && !(move == killerMove2))
+						if(!(move == transpositionMove) && !(move == killerMove1) && !(move == killerMove2) && !(move == excludedMove))
 						{
 							nonCaptureMoves.push_back(move);
 						}
@@ -112,6 +120,8 @@ Move MoveGenerator::nextMove()
 			copyPlayerBitboard &= copyPlayerBitboard - 1;	// set the bit we just processed to 0
 		}
 
+		numCaptureMoves = moves.size();
+
 		if(playerColor == EPlayerColors::Type::BLACK_PLAYER)	// actually want moves to be in the reverse order for Black
 		{
 			for(Move m : moves)									// so add the capture moves to the back of non-capture moves
@@ -132,6 +142,20 @@ Move MoveGenerator::nextMove()
 				moves.push_back(m);
 			}
 		}
+
+		if(historyTable)		// order quiet moves by history score, keeping the fixed order for equal scores
+		{
+			const HistoryTable& history = *historyTable;
+			EPlayerColors::Type color = playerColor;
+			Move counter = countermove;
+
+			std::stable_sort(moves.begin() + numCaptureMoves, moves.end(), [&history, color, counter](const Move& a, const Move& b)
+			{
+				int scoreA = (a == counter) ? HistoryTable::HISTORY_MAX_SCORE + 1 : history.getHistoryScore(color, a);
+				int scoreB = (b == counter) ? HistoryTable::HISTORY_MAX_SCORE + 1 : history.getHistoryScore(color, b);
+				return scoreA > scoreB;
+			});
+		}
 	}
 
 	Move move = INVALID_MOVE;
@@ -140,7 +164,54 @@ Move MoveGenerator::nextMove()
 	{
 		move = moves[moveIndex];
 		++moveIndex;
+		++numMovesReturned;
 	}
 
 	return move;
+}
+
+EMoveStage::Type MoveGenerator::getMoveStage() const
+{
+	if(moveIndex == 0 || moveIndex > moves.size())
+	{
+		return EMoveStage::Type::NO_MOVES_LEFT;
+	}
+
+	if(!generatedMoves)		// still returning TT / Killer Moves
+	{
+		return (moveIndex == 1 && hasTranspositionMove) ? EMoveStage::Type::TRANSPOSITION_MOVE : EMoveStage::Type::KILLER_MOVE;
+	}
+
+	return (moveIndex <= numCaptureMoves) ? EMoveStage::Type::CAPTURE_MOVE : EMoveStage::Type::QUIET_MOVE;
+}
+
+int MoveGenerator::getNumMovesReturned() const
+{
+	return numMovesReturned;
+}
+
+bool MoveGenerator::isTacticalMove(const Move& move, EPlayerColors::Type playerColor)
+{
+	if(move.captured)
+	{
+		return true;
+	}
+
+	uint64_t moveBits = Bitboards::singleBit(move.from) | Bitboards::singleBit(move.to);
+	return ((moveBits & (getDangerZone(playerColor) | getGoalRow(playerColor))) != Bitboards::ALL_ZERO);
+}
+
+uint64_t MoveGenerator::getDangerZone(EPlayerColors::Type playerColor)
+{
+	return (playerColor == EPlayerColors::Type::WHITE_PLAYER) ? Bitboards::DANGER_ZONE_TOP : Bitboards::DANGER_ZONE_BOTTOM;
+}
+
+uint64_t MoveGenerator::getGoalRow(EPlayerColors::Type playerColor)
+{
+	return (playerColor == EPlayerColors::Type::WHITE_PLAYER) ? Bitboards::ROW_8 : Bitboards::ROW_1;
+}
+
+uint64_t MoveGenerator::getKnightTargets(EPlayerColors::Type playerColor, uint64_t knights)
+{
+	return (playerColor == EPlayerColors::Type::WHITE_PLAYER) ? Bitboards::whiteKnightTargets(knights) : Bitboards::blackKnightTargets(knights);
 }
\ No newline at end of file
@@ -5,14 +5,32 @@
 #include <vector>
 
 #include "GameState.h"
+#include "HistoryTable.h"
 #include "Move.h"
 
+/** The stages in which the Move Generator returns moves */
+namespace EMoveStage
+{
+	enum Type
+	{
+		TRANSPOSITION_MOVE,
+		KILLER_MOVE,
+		CAPTURE_MOVE,
+		QUIET_MOVE,
+
+		NO_MOVES_LEFT
+	};
+}
+
 /**
  * A Move Generator class.
  *
  * Objects of this class can be initialized with moves from Transposition Table and Killer Moves,
  * and then queried for moves. They will automatically return TT moves and Killer Moves first if provided, 
  * and only then actually generate the other moves if necessary.
+ *
+ * If a History Table is provided, the quiet moves are ordered by their history scores, with the countermove
+ * (if provided) first. Otherwise, they are returned in a fixed order.
  */
 class MoveGenerator
 {
@@ -26,13 +44,42 @@ public:
 	 * transpositionMove = Best move according to Transposition Table
 	 * killerMove1 = The first killer move
 	 * killerMove2 = The second killer move
+	 * historyTable = The History Table used to order quiet moves. nullptr = keep the fixed order
+	 * countermove = The countermove of the move previously played by the opponent
+	 * excludedMove = A move that should never be returned, used by the exclusion searches of singular extensions
 	 */
 	MoveGenerator(EPlayerColors::Type playerColor, uint64_t playerBitboard, uint64_t opponentBitboard,
-				  Move transpositionMove = INVALID_MOVE, Move killerMove1 = INVALID_MOVE, Move killerMove2 = INVALID_MOVE);
+				  Move transpositionMove = INVALID_MOVE, Move killerMove1 = INVALID_MOVE, Move killerMove2 = INVALID_MOVE,
+				  const HistoryTable* historyTable = nullptr, Move countermove = INVALID_MOVE, Move excludedMove = INVALID_MOVE);
 
 	/** Returns the next move. Returns INVALID_MOVE if there are no more moves */
 	Move nextMove();
 
+	/** Returns the stage of the move that was last returned by nextMove() */
+	EMoveStage::Type getMoveStage() const;
+
+	/** Returns the number of moves returned by nextMove() so far, so the 1-based index of the last returned move */
+	int getNumMovesReturned() const;
+
+	/**
+	 * Returns true iff the given move is tactical for the given moving player, meaning that it is a capture, it reaches
+	 * the goal row, or it moves into or out of the danger zone from which the player can win in a single move.
+	 * Such moves should never be reduced or pruned.
+	 */
+	static bool isTacticalMove(const Move& move, EPlayerColors::Type playerColor);
+
+	/** Returns the danger zone from which the given player can reach the goal row in a single move */
+	static uint64_t getDangerZone(EPlayerColors::Type playerColor);
+
+	/** Returns the goal row of the given player */
+	static uint64_t getGoalRow(EPlayerColors::Type playerColor);
+
+	/**
+	 * Returns the set of all squares that knights of the given player on the given squares could move to, computed set-wise
+	 * with a few shifts and masks. Does not take into account whether the targets are occupied.
+	 */
+	static uint64_t getKnightTargets(EPlayerColors::Type playerColor, uint64_t knights);
+
 private:
 	/** This vector will contain the moves when the generator creates them */
 	std::vector<Move> moves;
@@ -43,6 +90,13 @@ private:
 	Move killerMove1;
 	/** Second killer move */
 	Move killerMove2;
+	/** Countermove of the move previously played by the opponent */
+	Move countermove;
+	/** Move that is never returned */
+	Move excludedMove;
+
+	/** History Table used to order quiet moves. nullptr if quiet moves should not be ordered */
+	const HistoryTable* historyTable;
 
 	/** The bitboard corresponding to the player to move */
 	const uint64_t playerBitboard;
@@ -54,6 +108,15 @@ private:
 	/** The index of the last move that was returned. */
 	size_t moveIndex;
 
+	/** The number of capture moves at the start of the moves vector, once all moves have been generated */
+	size_t numCaptureMoves;
+
+	/** The number of moves returned so far */
+	int numMovesReturned;
+
+	/** True iff the first move of the moves vector is the transposition move, before all moves have been generated */
+	bool hasTranspositionMove;
+
 	/** True iff all moves have been generated (can still be false if first returning TT / Killer Moves) */
 	bool generatedMoves;
 };
\ No newline at end of file
@@ -19,9 +19,9 @@ void MoveOrdering::orderMoves(std::vector<Move>& moves, const std::vector<int>&
 		pairs.push_back(std::make_pair(moves[i], moveScores[i]));
 	}
 
-	// sort the vector of pairs
-	std::sort(pairs.begin(), pairs.end(), [](std::pair<Move, int>& pair1, std::pair<Move, int>& pair2)
-											{return (pair1.second < pair2.second); }					);
+	// sort the vector of pairs, highest scores first. Stable sort keeps the order of the previous search for equal scores
+	std::stable_sort(pairs.begin(), pairs.end(), [](const std::pair<Move, int>& pair1, const std::pair<Move, int>& pair2)
+													{return (pair1.second > pair2.second); }					);
 
 	// overwrite the objects in moves with the properly sorted versions
 	for (size_t i = 0; i < numMoves; ++i)
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <fstream>
+
+#include "Logger.h"
+#include "OpeningBook.h"
+
+namespace
+{
+	/** Orders entries by Zobrist hash value */
+	bool compareEntries(const OpeningBookEntry& a, const OpeningBookEntry& b)
+	{
+		return a.zobrist < b.zobrist;
+	}
+}
+
+OpeningBook::OpeningBook() : mapping(), entries(nullptr), numEntries(0)
+{
+	load(OPENING_BOOK_FILE);
+}
+
+bool OpeningBook::load(const std::string& fileName)
+{
+	close();
+
+	if(!mapping.open(fileName) || mapping.getSize() < sizeof(OpeningBookHeader))
+	{
+		return false;
+	}
+
+	const OpeningBookHeader* header = reinterpret_cast<const OpeningBookHeader*>(mapping.getData());
+
+	if(header->magic != OPENING_BOOK_MAGIC ||
+		mapping.getSize() < sizeof(OpeningBookHeader) + (uint64_t)header->numEntries * sizeof(OpeningBookEntry))
+	{
+		LOG_ERROR(StringBuilder() << "Invalid opening book file: " << fileName)
+		close();
+		return false;
+	}
+
+	entries = reinterpret_cast<const OpeningBookEntry*>(mapping.getData() + sizeof(OpeningBookHeader));
+	numEntries = header->numEntries;
+	return true;
+}
+
+void OpeningBook::close()
+{
+	mapping.close();
+	entries = nullptr;
+	numEntries = 0;
+}
+
+uint32_t OpeningBook::getNumEntries() const
+{
+	return numEntries;
+}
+
+bool OpeningBook::probe(const GameState& gameState, Move& move, int& score) const
+{
+	if(numEntries == 0)
+	{
+		return false;
+	}
+
+	OpeningBookEntry key;
+	key.zobrist = gameState.getZobrist();
+	const OpeningBookEntry* entry = std::lower_bound(entries, entries + numEntries, key, compareEntries);
+
+	if(entry == entries + numEntries || entry->zobrist != key.zobrist)
+	{
+		return false;
+	}
+
+	Move bookMove(entry->from, entry->to, entry->captured != 0);
+
+	if(!gameState.isMoveLegal(bookMove))		// a different position with the same hash value
+	{
+		return false;
+	}
+
+	move = bookMove;
+	score = entry->score;
+	return true;
+}
+
+bool OpeningBook::write(std::vector<OpeningBookEntry>& entries, const std::string& fileName)
+{
+	std::sort(entries.begin(), entries.end(), compareEntries);
+
+	std::ofstream output(fileName.c_str(), std::ios::binary | std::ios::trunc);
+	if(!output)
+	{
+		LOG_ERROR(StringBuilder() << "OpeningBook::write(): could not open " << fileName << "!")
+		return false;
+	}
+
+	OpeningBookHeader header;
+	header.magic = OPENING_BOOK_MAGIC;
+	header.numEntries = (uint32_t)entries.size();
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(OpeningBookHeader));
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningBookEntry));
+	return (bool)output;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "MemoryMappedFile.h"
+#include "Move.h"
+
+/** The first 4 bytes of every opening book file */
+#define OPENING_BOOK_MAGIC 0x314B424B		// "KBK1"
+/** The file in which the engines look for the opening book */
+#define OPENING_BOOK_FILE "OpeningBook.kbk"
+
+/** The header at the start of every opening book file, followed by the entries sorted by Zobrist hash value */
+struct OpeningBookHeader
+{
+	/** Identifies the file as an opening book file. Must be OPENING_BOOK_MAGIC */
+	uint32_t magic;
+	/** The number of entries in the file */
+	uint32_t numEntries;
+};
+
+/** A single position of the opening book */
+struct OpeningBookEntry
+{
+	/** The Zobrist hash value of the position */
+	uint64_t zobrist;
+	/** The evaluation of the position from the perspective of the player to move */
+	int32_t score;
+	/** The square of the knight to move */
+	uint8_t from;
+	/** The square to move the knight to */
+	uint8_t to;
+	/** 1 if the move captures a knight, 0 otherwise */
+	uint8_t captured;
+	/** Unused, keeps the size of an entry a multiple of 8 bytes */
+	uint8_t padding;
+};
+
+/**
+ * Opening book: the best moves of positions close to the start of the game, found in advance by OpeningBookBuilder with much
+ * deeper searches than the engines can afford during a game, and probed through a memory-mapped file.
+ *
+ * The file consists of a header followed by entries sorted by Zobrist hash value, so that a position is found by a binary
+ * search without any loading or parsing. This relies on the Zobrist hash values being the same in every run (see GameState).
+ */
+class OpeningBook
+{
+public:
+	OpeningBook();
+
+	/** Maps the opening book file with the given name into memory, replacing any previously loaded book. Returns false if that failed */
+	bool load(const std::string& fileName);
+
+	/** Unmaps the loaded book, if there is one */
+	void close();
+
+	/** Returns the number of positions in the loaded book. 0 = no book loaded */
+	uint32_t getNumEntries() const;
+
+	/**
+	 * Looks up the given game state in the book. Returns true and sets move and score (from the perspective of the
+	 * player to move) if it was found, returns false otherwise
+	 */
+	bool probe(const GameState& gameState, Move& move, int& score) const;
+
+	/** Sorts the given entries and writes them to an opening book file with the given name. Returns false if that failed */
+	static bool write(std::vector<OpeningBookEntry>& entries, const std::string& fileName);
+
+private:
+	/** The mapping of the book file */
+	MemoryMappedFile mapping;
+	/** The sorted entries, following the header. nullptr = no book loaded */
+	const OpeningBookEntry* entries;
+	/** The number of entries */
+	uint32_t numEntries;
+
+	// don't want accidental copying of the mapped file
+	OpeningBook(const OpeningBook&);
+	OpeningBook& operator=(const OpeningBook&);
+};
\ No newline at end of file
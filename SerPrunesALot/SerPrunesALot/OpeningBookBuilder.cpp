@@ -0,0 +1,359 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "EngineComparison.h"
+#include "Logger.h"
+#include "MathConstants.h"
+#include "OpeningBook.h"
+#include "OpeningBookBuilder.h"
+#include "PrincipalVariationSearch.h"
+#include "SearchCore.h"
+#include "SearchHandle.h"
+#include "Timer.hpp"
+
+/**
+ * The penalty (in units of the evaluation function) for every ply along a path in the book tree, on top of the evaluation lost
+ * by the moves along the path. Higher penalties make the book broader, lower penalties make it deeper
+ */
+#define BOOK_DROP_OUT_PLY_PENALTY 15
+/** The number of expanded positions between two progress messages */
+#define BOOK_LOG_INTERVAL 50
+
+namespace
+{
+	/** A position of the book tree */
+	struct BookNode
+	{
+		/** The moves leading to the position from the start position, along the path on which it was first reached */
+		std::vector<Move> line;
+		/** The Zobrist hash value of the position */
+		uint64_t zobrist;
+		/** True iff the game is over in the position */
+		bool gameOver;
+		/** The legal moves of the position. Only filled in once the position is expanded */
+		std::vector<Move> moves;
+		/** The nodes reached by the moves, in the same order */
+		std::vector<int> children;
+		/** The score found by the search of the position, from the perspective of the player to move */
+		int searchScore;
+		/** The negamax value of the position: the search score for unexpanded positions, or the best value of its children */
+		int value;
+		/** The cost of the cheapest path from the start position to this position */
+		int priority;
+		/** True iff the children of the position were added to the tree */
+		bool expanded;
+		/** Used to visit every node once when traversing the tree, in which positions may be reached along several paths */
+		int visitedPass;
+
+		BookNode(const std::vector<Move>& moveLine, const GameState& gameState)
+			: line(moveLine), zobrist(gameState.getZobrist()), gameOver(gameState.getWinner() != EPlayerColors::Type::NOTHING), moves(), children(), searchScore(0), value(0), priority(0), expanded(false), visitedPass(-1)
+		{}
+	};
+
+	/** The book tree, and the engines used to evaluate its positions */
+	struct BookTree
+	{
+		/** All nodes. The start position is node 0 */
+		std::vector<BookNode> nodes;
+		/** Index of the node of every position, by Zobrist hash value */
+		std::unordered_map<uint64_t, int> nodeIndices;
+		/** One engine for every thread */
+		std::vector<std::unique_ptr<PrincipalVariationSearch>> engines;
+		/** The depth of the searches */
+		int searchDepth;
+		/** Counts the traversals of the tree, so that nodes can be marked as visited without resetting the marks */
+		int pass;
+		/** The evaluation of a win, which is the same for all engines */
+		int winEvaluation;
+	};
+
+	/** Returns the value of a node as seen from its parent, given the value of the node itself. Wins are one ply further away */
+	int getParentValue(int childValue, int winEvaluation)
+	{
+		int value = -childValue;
+
+		if(SearchCore::isWinScore(value, winEvaluation))
+		{
+			value += (value > 0) ? -1 : 1;
+		}
+
+		return value;
+	}
+
+	/** Returns true iff the given node can be expanded */
+	bool isExpandable(const BookNode& node, int winEvaluation)
+	{
+		return !node.expanded && !node.gameOver && !SearchCore::isWinScore(node.value, winEvaluation);
+	}
+
+	/** Searches the given nodes, which are split over all engines */
+	void searchNodes(BookTree& tree, const std::vector<int>& nodeIndices)
+	{
+		std::atomic<size_t> nextNode(0);
+		SearchLimits limits;
+		limits.maxDepth = tree.searchDepth;
+
+		auto worker = [&](PrincipalVariationSearch* engine)
+		{
+			for(size_t i = nextNode++; i < nodeIndices.size(); i = nextNode++)
+			{
+				BookNode& node = tree.nodes[nodeIndices[i]];
+				GameState gameState;
+				EngineComparison::setUpPosition(gameState, node.line);
+				SearchHandle* search = engine->start(gameState, limits);
+				search->wait();
+				delete search;
+				node.searchScore = engine->getRootEvaluation();
+				node.value = node.searchScore;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for(size_t i = 1; i < tree.engines.size(); ++i)
+		{
+			threads.push_back(std::thread(worker, tree.engines[i].get()));
+		}
+
+		worker(tree.engines[0].get());
+
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	/** Adds the children of the given node to the tree, and searches the new ones */
+	void expand(BookTree& tree, int nodeIndex)
+	{
+		std::vector<int> newNodes;
+		std::vector<Move> line = tree.nodes[nodeIndex].line;
+		GameState gameState;
+		EngineComparison::setUpPosition(gameState, line);
+		EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+		MoveGenerator moveGenerator(currentPlayer,
+									gameState.getBitboard(currentPlayer),
+									gameState.getBitboard(gameState.getOpponentColor(currentPlayer)));
+
+		for(Move move = moveGenerator.nextMove(); !(move == INVALID_MOVE); move = moveGenerator.nextMove())
+		{
+			gameState.applyMove(move);
+			auto found = tree.nodeIndices.find(gameState.getZobrist());
+			int childIndex;
+
+			if(found != tree.nodeIndices.end())		// transposition
+			{
+				childIndex = found->second;
+			}
+			else
+			{
+				childIndex = (int)tree.nodes.size();
+				line.push_back(move);
+				tree.nodes.push_back(BookNode(line, gameState));
+				tree.nodeIndices[gameState.getZobrist()] = childIndex;
+				line.pop_back();
+
+				if(!tree.nodes[childIndex].gameOver)
+				{
+					newNodes.push_back(childIndex);
+				}
+				else		// the player to move has lost
+				{
+					tree.nodes[childIndex].searchScore = -SearchCore::getWinScore(0, tree.winEvaluation);
+					tree.nodes[childIndex].value = tree.nodes[childIndex].searchScore;
+				}
+			}
+
+			gameState.undoMove(move);
+
+			// pushing new nodes may have moved the vector, so the node is looked up again
+			tree.nodes[nodeIndex].moves.push_back(move);
+			tree.nodes[nodeIndex].children.push_back(childIndex);
+		}
+
+		tree.nodes[nodeIndex].expanded = true;
+		searchNodes(tree, newNodes);
+	}
+
+	/** Updates the values of the given node and all nodes below it, and appends them to the given post-order */
+	void updateValues(BookTree& tree, int nodeIndex, std::vector<int>& postOrder)
+	{
+		BookNode& node = tree.nodes[nodeIndex];
+		node.visitedPass = tree.pass;
+
+		if(node.expanded)
+		{
+			int value = MathConstants::LOW_ENOUGH_INT;
+
+			for(int childIndex : node.children)
+			{
+				if(tree.nodes[childIndex].visitedPass != tree.pass)
+				{
+					updateValues(tree, childIndex, postOrder);
+				}
+
+				value = std::max(value, getParentValue(tree.nodes[childIndex].value, tree.winEvaluation));
+			}
+
+			node.value = value;
+		}
+
+		postOrder.push_back(nodeIndex);
+	}
+
+	/**
+	 * Updates the values and priorities of all nodes, and returns the expandable node with the cheapest path from the
+	 * start position, or -1 if there is none
+	 */
+	int selectNode(BookTree& tree)
+	{
+		++tree.pass;
+		std::vector<int> postOrder;
+		postOrder.reserve(tree.nodes.size());
+		updateValues(tree, 0, postOrder);
+
+		for(BookNode& node : tree.nodes)
+		{
+			node.priority = MathConstants::LARGE_ENOUGH_INT;
+		}
+		tree.nodes[0].priority = 0;
+
+		int bestNode = -1;
+
+		// in reverse post-order, every node is visited after all nodes that lead to it
+		for(auto it = postOrder.rbegin(); it != postOrder.rend(); ++it)
+		{
+			BookNode& node = tree.nodes[*it];
+
+			if(isExpandable(node, tree.winEvaluation))
+			{
+				if(bestNode == -1 || node.priority < tree.nodes[bestNode].priority)
+				{
+					bestNode = *it;
+				}
+			}
+			else if(node.expanded)
+			{
+				for(int childIndex : node.children)
+				{
+					// the evaluation that the player to move gives away by choosing this child instead of the best one
+					int dropOut = node.value - getParentValue(tree.nodes[childIndex].value, tree.winEvaluation);
+					int priority = node.priority + dropOut + BOOK_DROP_OUT_PLY_PENALTY;
+					tree.nodes[childIndex].priority = std::min(tree.nodes[childIndex].priority, priority);
+				}
+			}
+		}
+
+		return bestNode;
+	}
+
+	/** Returns the entries of all expanded nodes */
+	std::vector<OpeningBookEntry> createEntries(const BookTree& tree)
+	{
+		std::vector<OpeningBookEntry> entries;
+
+		for(const BookNode& node : tree.nodes)
+		{
+			if(!node.expanded)
+			{
+				continue;
+			}
+
+			OpeningBookEntry entry;
+			entry.zobrist = node.zobrist;
+			entry.score = node.value;
+			entry.padding = 0;
+
+			// among equally good moves, prefer those leading to expanded positions, which stay in the book
+			int bestChild = -1;
+			for(size_t i = 0; i < node.children.size(); ++i)
+			{
+				const BookNode& child = tree.nodes[node.children[i]];
+
+				if(getParentValue(child.value, tree.winEvaluation) == node.value && (bestChild == -1 || child.expanded))
+				{
+					bestChild = (int)i;
+
+					if(child.expanded)
+					{
+						break;
+					}
+				}
+			}
+
+			entry.from = (uint8_t)node.moves[bestChild].from;
+			entry.to = (uint8_t)node.moves[bestChild].to;
+			entry.captured = (node.moves[bestChild].captured) ? 1 : 0;
+
+			entries.push_back(entry);
+		}
+
+		return entries;
+	}
+}
+
+bool OpeningBookBuilder::build(int numPositions, int searchDepth, int numThreads, const std::string& fileName)
+{
+	LOG_MESSAGE(StringBuilder() << "Building opening book: positions = " << numPositions << ", search depth = " << searchDepth << ", threads = " << numThreads)
+
+	Timer timer;
+	timer.start();
+
+	BookTree tree;
+	tree.searchDepth = searchDepth;
+	tree.pass = 0;
+
+	for(int i = 0; i < std::max(numThreads, 1); ++i)
+	{
+		tree.engines.push_back(std::unique_ptr<PrincipalVariationSearch>(new PrincipalVariationSearch()));
+		// the book that is being built must not be based on an older book
+		tree.engines.back()->disableOpeningBook();
+	}
+
+	tree.winEvaluation = tree.engines[0]->getWinEvaluation();
+
+	GameState startPosition;
+	startPosition.reset();
+	tree.nodes.push_back(BookNode(std::vector<Move>(), startPosition));
+	tree.nodeIndices[startPosition.getZobrist()] = 0;
+	searchNodes(tree, std::vector<int>(1, 0));
+
+	int numExpanded = 0;
+
+	while(numExpanded < numPositions)
+	{
+		int nodeIndex = selectNode(tree);
+		if(nodeIndex == -1)		// every line in the book is decided
+		{
+			break;
+		}
+
+		expand(tree, nodeIndex);
+		++numExpanded;
+
+		if(numExpanded % BOOK_LOG_INTERVAL == 0)
+		{
+			timer.stop();
+			LOG_MESSAGE(StringBuilder() << "Positions expanded: " << numExpanded << ", searched: " << tree.nodes.size() << ", time: " << timer.getElapsedTimeInSec() << " s")
+		}
+	}
+
+	selectNode(tree);		// brings the values up to date with the last expansion
+	std::vector<OpeningBookEntry> entries = createEntries(tree);
+
+	if(!OpeningBook::write(entries, fileName))
+	{
+		return false;
+	}
+
+	timer.stop();
+	LOG_MESSAGE(StringBuilder() << "Opening book written to " << fileName << ": " << entries.size() << " positions, start position value = " << tree.nodes[0].value)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInSec() << " s")
+	LOG_MESSAGE("")
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Headless tool to build the opening book probed through OpeningBook.
+ *
+ * The book is built by drop-out expansion. Every position in the book tree that has not been expanded yet is evaluated by a
+ * deep search of the Principal Variation Search engine, and the values of the expanded positions are the negamax values of
+ * their children. Every path from the start position is penalized by how much worse its moves are than the best moves
+ * (for either player), plus a fixed amount per ply, and the position reached by the cheapest path is expanded next. This
+ * grows the book deepest along the main lines, while still covering the alternatives that are nearly as good, so that the
+ * book is not left after a single unexpected move of the opponent.
+ *
+ * Expanding a position searches all of its new children, which are split over the given number of threads with one engine
+ * each. Positions that are reached through different move orders are shared.
+ */
+namespace OpeningBookBuilder
+{
+	/**
+	 * Builds an opening book by expanding the given number of positions, evaluating every leaf with a search of the given
+	 * depth on the given number of threads, and writes the expanded positions to the given file.
+	 * Returns false if the file could not be written.
+	 */
+	bool build(int numPositions, int searchDepth, int numThreads, const std::string& fileName);
+}
\ No newline at end of file
@@ -20,5 +20,55 @@
 
 #endif // GATHER_STATISTICS
 
+// If defined, the Principal Variation Search engine searches late quiet moves with a reduced depth
+#define USE_LATE_MOVE_REDUCTIONS
+// If defined, the Principal Variation Search engine does not search late quiet moves at all close to the leaves
+#define USE_LATE_MOVE_PRUNING
+// If defined, the Principal Variation Search engine resolves captures and danger zone threats with a quiescence search at the leaves (the other engines evaluate leaves directly)
+#define USE_QUIESCENCE_SEARCH
+// If defined, the Principal Variation Search engine orders quiet moves using history and countermove tables
+#define USE_HISTORY_HEURISTIC
+// If defined, the Principal Variation Search engine returns early from frontier nodes where the static evaluation is far above beta
+#define USE_REVERSE_FUTILITY_PRUNING
+// If defined, the Principal Variation Search engine skips quiet moves at frontier nodes where the static evaluation is far below alpha
+#define USE_FUTILITY_PRUNING
+// If defined, the Principal Variation Search engine drops into quiescence search at frontier nodes where the static evaluation is far below alpha
+#define USE_RAZORING
+// If defined, the Principal Variation Search and MTD(f) engines use null-move pruning (with verification searches)
+#define USE_NULL_MOVE_PRUNING
+// If defined, the Principal Variation Search engine prunes nodes where a shallow search predicts the result of the deep search (ProbCut)
+#define USE_PROBCUT
+// If defined, the Principal Variation Search engine prunes nodes where several of the first moves fail high at a reduced depth (Multi-Cut)
+#define USE_MULTI_CUT
+// If defined, the Principal Variation Search engine probes the Transposition Table for all children before searching any of them
+#define USE_ENHANCED_TRANSPOSITION_CUTOFFS
+// If defined, the Principal Variation Search engine extends moves that create or remove threats to win, and single replies
+#define USE_THREAT_EXTENSIONS
+// If defined, the Principal Variation Search engine extends Transposition Table moves that are much better than all alternatives
+#define USE_SINGULAR_EXTENSIONS
+// If defined, the Principal Variation Search engine runs a reduced search to find a move to search first at deep PV nodes without a Transposition Table move
+#define USE_INTERNAL_ITERATIVE_DEEPENING
+// If defined, the Principal Variation Search and Aspiration Search engines (and the DFPN solver) recognize races to the goal row that one player is certain to win
+#define USE_RACE_DETECTION
+// If defined, the Principal Variation Search engine first tries to prove a forced win with a threat-space search at the root
+#define USE_THREAT_SPACE_SEARCH
+// If defined, the Principal Variation Search engine also runs a small threat-space search at deep PV nodes
+#define USE_THREAT_SPACE_SEARCH_AT_PV_NODES
+// If defined, the Principal Variation Search engine probes the endgame tablebases (if they were generated) at interior nodes
+#define USE_TABLEBASES
+// If defined, the Aspiration Search engine first tries to prove a win with the DFPN solver once few knights are left
+#define USE_DFPN_HANDOFF
+// If defined, the Principal Variation Search and Aspiration Search engines play moves from the opening book (if it was built) without searching
+#define USE_OPENING_BOOK
+// If defined, the Monte Carlo Tree Search engine plays out every leaf 16 times at once with the batched (vectorized) playout kernel
+#define USE_BATCH_PLAYOUTS
+// If defined, the Aspiration Search engine evaluates the advancement of all knights with bit-sliced piece-square tables, instead of only the furthest knight
+//#define USE_PIECE_SQUARE_EVALUATION
+
+// the amount of time in milliseconds that every AI player gets on its clock at the start of a game
+static const int GAME_TIME_BUDGET_MS = 10 * 60 * 1000;
+// the amount of time in milliseconds added to an AI player's clock after every move it plays
+static const int GAME_TIME_INCREMENT_MS = 2000;
+
 // the desired number of entries in a Transposition Table
 static const uint64_t TRANSPOSITION_TABLE_NUM_ENTRIES = (uint64_t)(std::pow(2, 22));
\ No newline at end of file
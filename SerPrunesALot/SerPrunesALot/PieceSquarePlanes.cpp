@@ -0,0 +1,232 @@
+#include <vector>
+
+#include "GameState.h"
+#include "Logger.h"
+#include "MoveGenerator.h"
+#include "PieceSquarePlanes.h"
+#include "RNG.h"
+#include "Timer.hpp"
+
+/** Seed of the random games that the benchmark takes its positions from, fixed so that runs are reproducible */
+#define BENCHMARK_SEED 0x5045535451ULL
+/** The number of times the benchmark evaluates every position, so that the timings are long enough to be meaningful */
+#define BENCHMARK_REPETITIONS 50
+
+namespace
+{
+	/** Sums the values of the given table over all given knights, one knight at a time */
+	inline int evaluateLoop(const int values[BOARD_WIDTH * BOARD_HEIGHT], uint64_t knights)
+	{
+		int sum = 0;
+
+		while(knights)
+		{
+			sum += values[Bitboards::bitScanForward(knights)];
+			knights &= knights - 1;
+		}
+
+		return sum;
+	}
+
+	/** Returns the number of rows that the furthest of the given black knights advanced, with the row cascade of the engines */
+	inline int getBlackProgression(uint64_t blackBitboard)
+	{
+		if(blackBitboard & Bitboards::ROW_2) { return 6; }
+		else if(blackBitboard & Bitboards::ROW_3) { return 5; }
+		else if(blackBitboard & Bitboards::ROW_4) { return 4; }
+		else if(blackBitboard & Bitboards::ROW_5) { return 3; }
+		else if(blackBitboard & Bitboards::ROW_6) { return 2; }
+		else if(blackBitboard & Bitboards::ROW_7) { return 1; }
+
+		return 0;
+	}
+
+	/** Returns the number of rows that the furthest of the given white knights advanced, with the row cascade of the engines */
+	inline int getWhiteProgression(uint64_t whiteBitboard)
+	{
+		if(whiteBitboard & Bitboards::ROW_7) { return 6; }
+		else if(whiteBitboard & Bitboards::ROW_6) { return 5; }
+		else if(whiteBitboard & Bitboards::ROW_5) { return 4; }
+		else if(whiteBitboard & Bitboards::ROW_4) { return 3; }
+		else if(whiteBitboard & Bitboards::ROW_3) { return 2; }
+		else if(whiteBitboard & Bitboards::ROW_2) { return 1; }
+
+		return 0;
+	}
+
+	/** Logs the evaluations per second of a benchmarked evaluation, and the checksum of its results */
+	void logBenchmark(const std::string& name, int64_t numEvaluations, int64_t checksum, double seconds)
+	{
+		LOG_MESSAGE(StringBuilder() << name << ":\t\t" << (int64_t)(numEvaluations / seconds) << " evaluations/s (checksum " << checksum << ")")
+	}
+}
+
+PieceSquarePlanes::PieceSquarePlanes(const int values[BOARD_WIDTH * BOARD_HEIGHT])
+	: numPlanes(0),
+	offset(values[0])
+{
+	for(int location = 1; location < BOARD_WIDTH * BOARD_HEIGHT; ++location)
+	{
+		if(values[location] < offset)
+		{
+			offset = values[location];
+		}
+	}
+
+	for(int k = 0; k < PIECE_SQUARE_MAX_PLANES; ++k)
+	{
+		planes[k] = Bitboards::ALL_ZERO;
+	}
+
+	for(int location = 0; location < BOARD_WIDTH * BOARD_HEIGHT; ++location)
+	{
+		int value = values[location] - offset;
+
+		if(value >= (1 << PIECE_SQUARE_MAX_PLANES))
+		{
+			LOG_ERROR(StringBuilder() << "PieceSquarePlanes: the values of the table span more than " << PIECE_SQUARE_MAX_PLANES << " bits!")
+			value = (1 << PIECE_SQUARE_MAX_PLANES) - 1;
+		}
+
+		for(int k = 0; k < PIECE_SQUARE_MAX_PLANES; ++k)
+		{
+			if(value & (1 << k))
+			{
+				planes[k] |= Bitboards::singleBit(location);
+
+				if(k >= numPlanes)
+				{
+					numPlanes = k + 1;
+				}
+			}
+		}
+	}
+}
+
+int PieceSquarePlanes::getNumPlanes() const
+{
+	return numPlanes;
+}
+
+void PieceSquarePlanes::benchmark(int numPositions)
+{
+	// positions from random games, taken at random plies
+	std::vector<uint64_t> blackBitboards;
+	std::vector<uint64_t> whiteBitboards;
+	blackBitboards.reserve(numPositions);
+	whiteBitboards.reserve(numPositions);
+
+	RNG::FastGenerator_64 random(BENCHMARK_SEED);
+	GameState gameState;
+	std::vector<Move> moves;
+
+	while((int)blackBitboards.size() < numPositions)
+	{
+		gameState.reset();
+		int numMoves = random.randomBelow(60);
+
+		for(int i = 0; i < numMoves && gameState.getWinner() == EPlayerColors::Type::NOTHING; ++i)
+		{
+			EPlayerColors::Type player = gameState.getCurrentPlayer();
+			MoveGenerator moveGenerator(player, gameState.getBitboard(player), gameState.getBitboard(gameState.getOpponentColor(player)));
+			moves.clear();
+
+			for(Move move = moveGenerator.nextMove(); !(move == INVALID_MOVE); move = moveGenerator.nextMove())
+			{
+				moves.push_back(move);
+			}
+
+			if(moves.empty())
+			{
+				break;
+			}
+
+			gameState.applyMove(moves[random.randomBelow((uint32_t)moves.size())]);
+		}
+
+		if(gameState.getWinner() == EPlayerColors::Type::NOTHING)
+		{
+			blackBitboards.push_back(gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER));
+			whiteBitboards.push_back(gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER));
+		}
+	}
+
+	// the advancement table of GameState, and a table with many more distinct values, including negative ones
+	int advancementValues[NUM_PLAYERS][BOARD_WIDTH * BOARD_HEIGHT];
+	int richValues[NUM_PLAYERS][BOARD_WIDTH * BOARD_HEIGHT];
+
+	for(int location = 0; location < BOARD_WIDTH * BOARD_HEIGHT; ++location)
+	{
+		advancementValues[0][location] = GameState::getPieceSquareValue(EPlayerColors::Type::BLACK_PLAYER, location);
+		advancementValues[1][location] = GameState::getPieceSquareValue(EPlayerColors::Type::WHITE_PLAYER, location);
+		richValues[0][location] = (int)random.randomBelow(1000) - 200;
+		richValues[1][location] = (int)random.randomBelow(1000) - 200;
+	}
+
+	int64_t numEvaluations = (int64_t)numPositions * BENCHMARK_REPETITIONS;
+	Timer timer;
+
+	LOG_MESSAGE(StringBuilder() << "Benchmarking evaluations of " << numPositions << " positions, " << BENCHMARK_REPETITIONS << " times each")
+
+	// the progression term as the engines used to compute it
+	{
+		int64_t checksum = 0;
+		timer.start();
+
+		for(int repetition = 0; repetition < BENCHMARK_REPETITIONS; ++repetition)
+		{
+			for(int i = 0; i < numPositions; ++i)
+			{
+				checksum += getWhiteProgression(whiteBitboards[i]) - getBlackProgression(blackBitboards[i]);
+			}
+		}
+
+		logBenchmark("Row cascade (progression)", numEvaluations, checksum, timer.getElapsedTimeInSec());
+	}
+
+	const int (*tables[2])[BOARD_WIDTH * BOARD_HEIGHT] = {advancementValues, richValues};
+	const char* tableNames[2] = {"advancement table", "rich table"};
+
+	for(int table = 0; table < 2; ++table)
+	{
+		const int (*values)[BOARD_WIDTH * BOARD_HEIGHT] = tables[table];
+		PieceSquarePlanes blackPlanes(values[0]);
+		PieceSquarePlanes whitePlanes(values[1]);
+		int64_t loopChecksum = 0;
+		int64_t planesChecksum = 0;
+
+		timer.start();
+		for(int repetition = 0; repetition < BENCHMARK_REPETITIONS; ++repetition)
+		{
+			for(int i = 0; i < numPositions; ++i)
+			{
+				loopChecksum += evaluateLoop(values[1], whiteBitboards[i]) - evaluateLoop(values[0], blackBitboards[i]);
+			}
+		}
+		logBenchmark(StringBuilder() << "Loop over knights, " << tableNames[table], numEvaluations, loopChecksum, timer.getElapsedTimeInSec());
+
+		timer.start();
+		for(int repetition = 0; repetition < BENCHMARK_REPETITIONS; ++repetition)
+		{
+			for(int i = 0; i < numPositions; ++i)
+			{
+				planesChecksum += whitePlanes.evaluate(whiteBitboards[i]) - blackPlanes.evaluate(blackBitboards[i]);
+			}
+		}
+		logBenchmark(StringBuilder() << "Bit-sliced (" << blackPlanes.getNumPlanes() << " + " << whitePlanes.getNumPlanes() << " planes), " << tableNames[table],
+					 numEvaluations, planesChecksum, timer.getElapsedTimeInSec());
+
+		// both must compute exactly the same sums
+		for(int i = 0; i < numPositions; ++i)
+		{
+			if(blackPlanes.evaluate(blackBitboards[i]) != evaluateLoop(values[0], blackBitboards[i]) ||
+				whitePlanes.evaluate(whiteBitboards[i]) != evaluateLoop(values[1], whiteBitboards[i]))
+			{
+				LOG_ERROR(StringBuilder() << "PieceSquarePlanes::benchmark(): the bit-sliced evaluation of position " << i << " is wrong!")
+				break;
+			}
+		}
+	}
+
+	LOG_MESSAGE("")
+}
\ No newline at end of file
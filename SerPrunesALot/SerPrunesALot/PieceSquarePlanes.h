@@ -0,0 +1,55 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "Bitboards.hpp"
+#include "GameConstants.h"
+
+/** The maximum number of weight planes, so piece-square values may span a range of at most 2^PIECE_SQUARE_MAX_PLANES */
+#define PIECE_SQUARE_MAX_PLANES 16
+
+/**
+ * A piece-square table stored bit-sliced: as weight planes, where plane k is the bitboard of all squares whose value has bit
+ * k set. The sum of the values of all knights on a bitboard then equals the sum over all planes of popcount(knights & plane)
+ * shifted left by k, so evaluating the table takes one popcount per plane instead of a loop over all knights.
+ *
+ * Values are stored relative to the smallest value in the table (which is added once per knight), so tables with negative
+ * values are supported, and a table with values in a small range needs only few planes.
+ */
+class PieceSquarePlanes
+{
+public:
+	/** Converts the given ordinary piece-square table, indexed by location, into weight planes */
+	explicit PieceSquarePlanes(const int values[BOARD_WIDTH * BOARD_HEIGHT]);
+
+	/** Returns the sum of the values of the squares occupied by the given knights */
+	inline int evaluate(uint64_t knights) const
+	{
+		int sum = offset * Bitboards::popCount(knights);
+
+		for(int k = 0; k < numPlanes; ++k)
+		{
+			sum += Bitboards::popCount(knights & planes[k]) << k;
+		}
+
+		return sum;
+	}
+
+	/** Returns the number of weight planes that the table needs */
+	int getNumPlanes() const;
+
+	/**
+	 * Headless benchmark: evaluates piece-square tables on the given number of positions from random games with the bit-sliced
+	 * planes and with a loop over all knights, checks that both agree, and logs the evaluations per second of each, next to the
+	 * row cascade that the search engines used to compute the progression term with
+	 */
+	static void benchmark(int numPositions);
+
+private:
+	/** Plane k holds the squares whose value (relative to offset) has bit k set */
+	uint64_t planes[PIECE_SQUARE_MAX_PLANES];
+	/** The number of planes in use */
+	int numPlanes;
+	/** The smallest value in the table */
+	int offset;
+};
\ No newline at end of file
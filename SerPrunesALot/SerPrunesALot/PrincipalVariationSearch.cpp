@@ -0,0 +1,1429 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <cmath>
+
+#include "Logger.h"
+#include "MathConstants.h"
+#include "MoveOrdering.h"
+#include "PrincipalVariationSearch.h"
+#include "RaceDetector.h"
+#include "SearchCore.h"
+#include "ThreatSpaceSearch.h"
+
+/**
+* The evaluation corresponding to a won game.
+* Should be a non-tight upper bound on values the evaluation function can return in non-terminal game states
+*/
+#define WIN_EVALUATION 1900
+
+/** Late Move Reductions are only applied at nodes with at least this remaining depth */
+#define LMR_MIN_DEPTH 3
+/** Late Move Reductions are only applied to moves with at least this (1-based) move index */
+#define LMR_MIN_MOVE_INDEX 3
+/** reduction = LMR_BASE + ln(depth) * ln(moveIndex) / LMR_DIVISOR */
+#define LMR_BASE 0.5
+#define LMR_DIVISOR 2.0
+
+/** Late Move Pruning is only applied at nodes with at most this remaining depth */
+#define LMP_MAX_DEPTH 3
+/** At depth d, Late Move Pruning prunes quiet moves with a (1-based) move index larger than LMP_BASE + LMP_FACTOR * d * d */
+#define LMP_BASE 4
+#define LMP_FACTOR 2
+
+/**
+ * The quiescence search skips captures if the stand-pat score plus this margin still does not exceed alpha.
+ * Covers the material of the captured knight (100) plus a generous change in progression (4 rows of 35)
+ */
+#define QS_DELTA_MARGIN 240
+
+/**
+ * Margins for frontier pruning. A quiet move changes the evaluation by at most a progression of two rows (70), so the margins
+ * per ply are set slightly above that. Captures and threats are excluded from pruning and resolved by the quiescence search
+ */
+/** Reverse futility pruning is only applied at nodes with at most this remaining depth */
+#define RFP_MAX_DEPTH 3
+/** Reverse futility pruning returns if the static evaluation minus depth * RFP_MARGIN is at least beta */
+#define RFP_MARGIN 100
+/** Futility pruning of quiet moves is only applied at nodes with at most this remaining depth */
+#define FUTILITY_MAX_DEPTH 2
+/** Futility pruning skips quiet moves if the static evaluation plus depth * FUTILITY_MARGIN is at most alpha */
+#define FUTILITY_MARGIN 100
+/** Razoring is only applied at nodes with at most this remaining depth */
+#define RAZORING_MAX_DEPTH 2
+/** Razoring drops into the quiescence search if the static evaluation plus depth * RAZORING_MARGIN is at most alpha */
+#define RAZORING_MARGIN 150
+/** The largest of the maximum depths above, at which the static evaluation needs to be computed */
+#define FRONTIER_MAX_DEPTH 3
+
+/** ProbCut is only applied at nodes with at least this remaining depth */
+#define PROBCUT_MIN_DEPTH 5
+/** The difference in depth between the shallow and the deep search of ProbCut */
+#define PROBCUT_DEPTH_REDUCTION 4
+/**
+ * ProbCut regression coefficients: deepScore = PROBCUT_A * shallowScore + PROBCUT_B, with standard deviation PROBCUT_SIGMA.
+ * Fitted with ''--calibrate-probcut 4 8 300'' (145 samples)
+ */
+#define PROBCUT_A 0.9472
+#define PROBCUT_B 6.076
+#define PROBCUT_SIGMA 51.81
+/** ProbCut only prunes if the deep search is predicted to fail high with a confidence of PROBCUT_THRESHOLD standard deviations */
+#define PROBCUT_THRESHOLD 1.0
+
+/** Multi-Cut is only applied at nodes with at least this remaining depth */
+#define MULTICUT_MIN_DEPTH 6
+/** The additional depth reduction of the searches of Multi-Cut */
+#define MULTICUT_REDUCTION 3
+/** The number of moves searched by Multi-Cut */
+#define MULTICUT_NUM_MOVES 10
+/** The number of those moves that must fail high for Multi-Cut to prune the node */
+#define MULTICUT_NUM_CUTOFFS 2
+
+/** Enhanced Transposition Cutoffs are only tried at nodes with at least this remaining depth */
+#define ETC_MIN_DEPTH 4
+
+/** Singular extensions are only tried at nodes with at least this remaining depth */
+#define SINGULAR_MIN_DEPTH 6
+/** The Transposition Table value needs to come from a search at most this many plies shallower than the current one */
+#define SINGULAR_TT_DEPTH_MARGIN 3
+/** The Transposition Table move is singular if all other moves score this margin per ply below its value */
+#define SINGULAR_MARGIN 4
+/** XORed with the zobrist hash value of exclusion searches, so that their results are stored separately */
+#define EXCLUSION_SEARCH_KEY 0x9E3779B97F4A7C15ULL
+
+/** Internal iterative deepening is only used at PV nodes with at least this remaining depth */
+#define IID_MIN_DEPTH 4
+/** The depth reduction of the internal iterative deepening search */
+#define IID_REDUCTION 2
+
+/** The maximum length in plies of the forced wins that the threat-space search at the root looks for */
+#define TSS_ROOT_MAX_PLIES 31
+/** The maximum number of nodes that the threat-space search at the root may visit */
+#define TSS_ROOT_MAX_NODES 200000
+/** The threat-space search is only run at PV nodes with at least this remaining depth */
+#define TSS_PV_MIN_DEPTH 4
+/** The maximum length in plies of the forced wins that the threat-space search at PV nodes looks for */
+#define TSS_PV_MAX_PLIES 15
+/** The maximum number of nodes that the threat-space search at a PV node may visit */
+#define TSS_PV_MAX_NODES 2000
+
+PrincipalVariationSearch::PrincipalVariationSearch()
+	: transpositionTable(),
+	killerMoves(),
+	historyTable(),
+	threatSpaceSearch(),
+	tablebase(),
+	openingBook(),
+	plyMoves(PVS_MAX_PLY + 1, INVALID_MOVE),
+	pathExtensions(PVS_MAX_PLY + 1, 0),
+	searchedQuietMoves(PVS_MAX_PLY + 1),
+	pvTable(PVS_MAX_PLY + 1, std::vector<Move>(PVS_MAX_PLY + 1, INVALID_MOVE)),
+	pvLength(PVS_MAX_PLY + 1, 0),
+	principalVariation(),
+	lateMoveReductions(PVS_MAX_PLY + 1, std::vector<int>(PVS_MAX_MOVES + 1, 0)),
+	clock(),
+	lastRootEvaluation(0),
+	probCutEnabled(true),
+	timeManager(MIN_SEARCH_TIME_MS, MIN_SEARCH_TIME_MS + MAX_EXTRA_SEARCH_TIME_MS),
+	totalNodesVisited(0),
+	totalTimeSpent(0.0),
+	turnsPlayed(0),
+	searchDepth(0)
+#ifdef GATHER_STATISTICS
+	, nullWindowNodes(0),
+	reSearches(0),
+	scoutSearches(0),
+	reducedMoves(0),
+	reductionReSearches(0),
+	lateMovesPruned(0),
+	quiescenceNodes(0),
+	deltaPrunedMoves(0),
+	reverseFutilityCutoffs(0),
+	futilityPrunedMoves(0),
+	razoringCutoffs(0),
+	nullMovesTried(0),
+	nullMoveCutoffs(0),
+	probCutCutoffs(0),
+	multiCutCutoffs(0),
+	etcProbedNodes(0),
+	etcCutoffs(0),
+	extendedMoves(0),
+	singularSearches(0),
+	singularMoves(0),
+	iidSearches(0),
+	raceCutoffs(0),
+	tablebaseHits(0),
+	threatSpaceSearches(0),
+	threatSpaceNodes(0),
+	threatSpaceWins(0)
+#endif // GATHER_STATISTICS
+{
+	// precompute the reductions, such that the reduced search always keeps at least 1 ply
+	for(int depth = LMR_MIN_DEPTH; depth <= PVS_MAX_PLY; ++depth)
+	{
+		for(int moveIndex = LMR_MIN_MOVE_INDEX; moveIndex <= PVS_MAX_MOVES; ++moveIndex)
+		{
+			int reduction = (int)(LMR_BASE + std::log((double)depth) * std::log((double)moveIndex) / LMR_DIVISOR);
+			lateMoveReductions[depth][moveIndex] = std::max(0, std::min(reduction, depth - 2));
+		}
+	}
+}
+
+Move PrincipalVariationSearch::chooseMove(GameState& gameState)
+{
+#ifdef USE_OPENING_BOOK
+	// checked before anything else, because even clearing the Transposition Table takes much longer than probing the book
+	Move bookMove = INVALID_MOVE;
+	clock.start();
+	if(openingBook.probe(gameState, bookMove, lastRootEvaluation))
+	{
+		clock.stop();
+		searchDepth = 0;
+		principalVariation.clear();
+		principalVariation.push_back(bookMove);
+		reportIteration(searchDepth, lastRootEvaluation, bookMove, 0, clock.getElapsedTimeInMilliSec(), principalVariation);
+		return bookMove;
+	}
+#endif // USE_OPENING_BOOK
+
+	transpositionTable.clear();	// clean up data from previous searches
+
+#ifdef GATHER_STATISTICS
+	nullWindowNodes = 0;
+	reSearches = 0;
+	scoutSearches = 0;
+	reducedMoves = 0;
+	reductionReSearches = 0;
+	lateMovesPruned = 0;
+	quiescenceNodes = 0;
+	deltaPrunedMoves = 0;
+	reverseFutilityCutoffs = 0;
+	futilityPrunedMoves = 0;
+	razoringCutoffs = 0;
+	nullMovesTried = 0;
+	nullMoveCutoffs = 0;
+	probCutCutoffs = 0;
+	multiCutCutoffs = 0;
+	etcProbedNodes = 0;
+	etcCutoffs = 0;
+	extendedMoves = 0;
+	singularSearches = 0;
+	singularMoves = 0;
+	iidSearches = 0;
+	raceCutoffs = 0;
+	tablebaseHits = 0;
+	threatSpaceSearches = 0;
+	threatSpaceNodes = 0;
+	threatSpaceWins = 0;
+
+	Timer timer;
+	timer.start();
+	Move moveToPlay = startPrincipalVariationSearch(gameState);
+	timer.stop();
+
+#ifdef LOG_STATS_PER_TURN
+	if(gameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		LOG_MESSAGE(StringBuilder() << "Principal Variation Search engine searching move for Black Player")
+	}
+	else
+	{
+		LOG_MESSAGE(StringBuilder() << "Principal Variation Search engine searching move for White Player")
+	}
+
+	std::string pvString;
+	for(const Move& pvMove : principalVariation)
+	{
+		pvString += pvMove.toString() + " ";
+	}
+
+	LOG_MESSAGE(StringBuilder() << "Search depth:					" << searchDepth)
+	LOG_MESSAGE(StringBuilder() << "Principal variation:				" << pvString)
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << searchControl.getNodesVisited())
+	LOG_MESSAGE(StringBuilder() << "% of nodes with null window:			" << ((double)nullWindowNodes / searchControl.getNodesVisited()))
+	LOG_MESSAGE(StringBuilder() << "Scout searches / re-searches:			" << scoutSearches << " / " << reSearches)
+	LOG_MESSAGE(StringBuilder() << "Reduced moves / re-searches:			" << reducedMoves << " / " << reductionReSearches)
+	LOG_MESSAGE(StringBuilder() << "Late moves pruned:				" << lateMovesPruned)
+	LOG_MESSAGE(StringBuilder() << "% of nodes in quiescence search:		" << ((double)quiescenceNodes / searchControl.getNodesVisited()))
+	LOG_MESSAGE(StringBuilder() << "Captures skipped by delta pruning:		" << deltaPrunedMoves)
+	LOG_MESSAGE(StringBuilder() << "Reverse futility / razoring cutoffs:		" << reverseFutilityCutoffs << " / " << razoringCutoffs)
+	LOG_MESSAGE(StringBuilder() << "Moves pruned by futility pruning:		" << futilityPrunedMoves)
+	LOG_MESSAGE(StringBuilder() << "Null moves tried / cutoffs:			" << nullMovesTried << " / " << nullMoveCutoffs)
+	LOG_MESSAGE(StringBuilder() << "ProbCut / Multi-Cut cutoffs:			" << probCutCutoffs << " / " << multiCutCutoffs)
+	LOG_MESSAGE(StringBuilder() << "ETC nodes probed / cutoffs:			" << etcProbedNodes << " / " << etcCutoffs)
+	LOG_MESSAGE(StringBuilder() << "Moves extended:					" << extendedMoves)
+	LOG_MESSAGE(StringBuilder() << "Singular searches / moves:			" << singularSearches << " / " << singularMoves)
+	LOG_MESSAGE(StringBuilder() << "Internal iterative deepening searches:		" << iidSearches)
+	LOG_MESSAGE(StringBuilder() << "Race detector cutoffs:				" << raceCutoffs)
+	LOG_MESSAGE(StringBuilder() << "Tablebase hits:					" << tablebaseHits)
+	LOG_MESSAGE(StringBuilder() << "Threat-space searches / nodes / wins:		" << threatSpaceSearches << " / " << threatSpaceNodes << " / " << threatSpaceWins)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << timer.getElapsedTimeInMilliSec() << " ms")
+	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries used:		" << ((double)transpositionTable.getNumEntriesUsed() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
+	LOG_MESSAGE(StringBuilder() << "% of Transposition Table entries replaced:	" << ((double)transpositionTable.getNumReplacementsRequired() / (TRANSPOSITION_TABLE_NUM_ENTRIES * 2.0)))
+	LOG_MESSAGE("")
+#endif // LOG_STATS_PER_TURN
+
+#ifdef LOG_STATS_END_OF_MATCH
+	totalNodesVisited += searchControl.getNodesVisited();
+	totalTimeSpent += timer.getElapsedTimeInMilliSec();
+	++turnsPlayed;
+#endif // LOG_STATS_END_OF_MATCH
+
+	return moveToPlay;
+#else
+	return startPrincipalVariationSearch(gameState);
+#endif // GATHER_STATISTICS
+}
+
+int PrincipalVariationSearch::alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta, bool nullMoveAllowed, Move excludedMove)
+{
+#ifdef USE_QUIESCENCE_SEARCH
+	if(depth <= 0)		// reached the horizon, so only resolve captures and threats from here on
+	{
+		return quiescence(gameState, ply, alpha, beta);
+	}
+#endif // USE_QUIESCENCE_SEARCH
+
+	pvLength[ply] = 0;		// no principal variation known yet for this node
+
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+#ifdef GATHER_STATISTICS
+	if(beta - alpha == 1)
+	{
+		++nullWindowNodes;
+	}
+#endif // GATHER_STATISTICS
+
+	if(SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
+
+	int originalAlpha = alpha;
+	// the result of an exclusion search is not the value of the node, so it must not be confused with it in the table
+	bool exclusionSearch = !(excludedMove == INVALID_MOVE);
+	uint64_t zobrist = (exclusionSearch) ? (gameState.getZobrist() ^ EXCLUSION_SEARCH_KEY) : gameState.getZobrist();
+	const TableData& tableData = transpositionTable.retrieve(zobrist);
+	// true iff relevant data was retrieved from the Transposition Table
+	bool tableDataValid = tableData.isValid();
+
+#ifdef VERIFY_MOVE_LEGALITY
+	if(tableDataValid && !gameState.isMoveLegal(tableData.bestMove))
+	{
+		LOG_ERROR("ERROR: table data contains invalid move in PrincipalVariationSearch::alphaBeta")
+		tableDataValid = false;
+	}
+#endif
+
+	// wins are stored relative to the node, so convert back to a score relative to the root
+	int tableValue = (tableDataValid) ? SearchCore::scoreFromTable(tableData.value, ply, WIN_EVALUATION) : 0;
+	// copied now, because the searches below (razoring, null move, ProbCut) may store into the same bucket and overwrite the entry
+	Move tableMove = (tableDataValid) ? tableData.bestMove : INVALID_MOVE;
+
+	if(tableDataValid)
+	{
+		if(tableData.depth >= depth)	// ensure table stored in data resulted from a deep enough search
+		{
+			if(tableData.valueType == EValue::Type::REAL)
+			{
+				return tableValue;
+			}
+			else if(tableData.valueType == EValue::Type::LOWER_BOUND)
+			{
+				alpha = std::max(alpha, tableValue);
+			}
+			else if(tableData.valueType == EValue::Type::UPPER_BOUND)
+			{
+				beta = std::min(beta, tableValue);
+			}
+
+			if(alpha >= beta)
+			{
+				return tableValue;
+			}
+		}
+	}
+
+	EPlayerColors::Type winner = gameState.getWinner();
+
+	// stop search if we reached max depth or have found a winner
+	if(depth == 0 || ply >= PVS_MAX_PLY || winner != EPlayerColors::Type::NOTHING)
+	{
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
+	}
+
+#ifdef USE_TABLEBASES
+	// the exact result is known, so there is no need to search the subtree
+	int tablebasePlies = tablebase.probe(gameState);
+	if(tablebasePlies != 0)
+	{
+#ifdef GATHER_STATISTICS
+		++tablebaseHits;
+#endif // GATHER_STATISTICS
+
+		return SearchCore::scoreEvaluation(SearchCore::getDistanceEvaluation(tablebasePlies, WIN_EVALUATION), ply, WIN_EVALUATION);
+	}
+#endif // USE_TABLEBASES
+
+#ifdef USE_RACE_DETECTION
+	// the race to the goal row is already decided, so there is no need to search the subtree
+	int racePlies = RaceDetector::detectRace(gameState);
+	if(racePlies != 0)
+	{
+#ifdef GATHER_STATISTICS
+		++raceCutoffs;
+#endif // GATHER_STATISTICS
+
+		return SearchCore::scoreEvaluation(SearchCore::getDistanceEvaluation(racePlies, WIN_EVALUATION), ply, WIN_EVALUATION);
+	}
+#endif // USE_RACE_DETECTION
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	EPlayerColors::Type opponent = gameState.getOpponentColor(currentPlayer);
+	bool pvNode = (beta - alpha > 1);
+
+#ifdef USE_THREAT_SPACE_SEARCH_AT_PV_NODES
+	if(pvNode && !exclusionSearch && depth >= TSS_PV_MIN_DEPTH)
+	{
+		Move threatSpaceMove = INVALID_MOVE;
+		int threatSpacePlies = threatSpaceSearch.solve(gameState, TSS_PV_MAX_PLIES, TSS_PV_MAX_NODES, threatSpaceMove);
+
+#ifdef GATHER_STATISTICS
+		++threatSpaceSearches;
+		threatSpaceNodes += threatSpaceSearch.getNodesVisited();
+#endif // GATHER_STATISTICS
+
+		// a proven win that is worse than alpha is of no use, because a faster win was already found elsewhere
+		if(threatSpacePlies > 0 && SearchCore::getWinScore(ply + threatSpacePlies, WIN_EVALUATION) > alpha)
+		{
+#ifdef GATHER_STATISTICS
+			++threatSpaceWins;
+#endif // GATHER_STATISTICS
+
+			int value = SearchCore::getWinScore(ply + threatSpacePlies, WIN_EVALUATION);
+			transpositionTable.storeData(threatSpaceMove, zobrist, SearchCore::scoreToTable(value, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
+			pvTable[ply][0] = threatSpaceMove;
+			pvLength[ply] = 1;
+			return value;
+		}
+	}
+#endif // USE_THREAT_SPACE_SEARCH_AT_PV_NODES
+	// true iff the opponent can win on its next move, in which case we cannot afford to reduce or prune any moves
+	bool opponentThreat = ((gameState.getBitboard(opponent) & MoveGenerator::getDangerZone(opponent)) != Bitboards::ALL_ZERO);
+	// true iff neither player can win on its next move, so that margins on the static evaluation can be trusted
+	bool quietPosition = (!opponentThreat && !(gameState.getBitboard(currentPlayer) & MoveGenerator::getDangerZone(currentPlayer)));
+
+	// searches of this node's children that do not go through the move loop below inherit this node's extensions
+	pathExtensions[ply + 1] = pathExtensions[ply];
+
+#ifdef USE_SINGULAR_EXTENSIONS
+	// copied now, because the searches below may overwrite the table entry
+	bool singularCandidate = (!exclusionSearch && depth >= SINGULAR_MIN_DEPTH && tableDataValid &&
+							  tableData.depth >= depth - SINGULAR_TT_DEPTH_MARGIN && tableData.valueType != EValue::Type::UPPER_BOUND &&
+							  !SearchCore::isWinScore(tableValue, WIN_EVALUATION));
+	int singularBeta = tableValue - SINGULAR_MARGIN * depth;
+#endif // USE_SINGULAR_EXTENSIONS
+
+	// forward pruning only makes sense for the value of the node itself, so not in exclusion searches
+	bool pruningAllowed = (!pvNode && !exclusionSearch);
+
+#ifdef USE_ENHANCED_TRANSPOSITION_CUTOFFS
+	if(depth >= ETC_MIN_DEPTH && !exclusionSearch)
+	{
+#ifdef GATHER_STATISTICS
+		++etcProbedNodes;
+#endif // GATHER_STATISTICS
+
+		// look for a child that is already known to be bad enough for the opponent to make this node fail high
+		MoveGenerator etcMoveGenerator(currentPlayer, gameState.getBitboard(currentPlayer), gameState.getBitboard(opponent),
+										INVALID_MOVE, INVALID_MOVE, INVALID_MOVE);
+		Move m = etcMoveGenerator.nextMove();
+
+		while(!(m == INVALID_MOVE))
+		{
+			const TableData& childData = transpositionTable.retrieve(gameState.getZobristAfterMove(m));
+
+			if(childData.isValid() && childData.depth >= depth - 1 && childData.valueType != EValue::Type::LOWER_BOUND
+				&& -SearchCore::scoreFromTable(childData.value, ply + 1, WIN_EVALUATION) >= beta)
+			{
+#ifdef GATHER_STATISTICS
+				++etcCutoffs;
+#endif // GATHER_STATISTICS
+
+				// copy before storing, which may overwrite the child's entry
+				int value = -SearchCore::scoreFromTable(childData.value, ply + 1, WIN_EVALUATION);
+				transpositionTable.storeData(m, zobrist, SearchCore::scoreToTable(value, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
+				return value;
+			}
+
+			m = etcMoveGenerator.nextMove();
+		}
+	}
+#endif // USE_ENHANCED_TRANSPOSITION_CUTOFFS
+
+	// static evaluation, only computed for the non-PV nodes where it is used for pruning
+	int staticEvaluation = 0;
+	if(pruningAllowed && quietPosition)
+	{
+		staticEvaluation = evaluate(gameState, winner);
+	}
+
+	if(pruningAllowed && quietPosition && depth <= FRONTIER_MAX_DEPTH)
+	{
+
+#ifdef USE_REVERSE_FUTILITY_PRUNING
+		// if we are so far ahead that even a margin per ply cannot bring us below beta, assume that the search would fail high
+		if(depth <= RFP_MAX_DEPTH && staticEvaluation - RFP_MARGIN * depth >= beta)
+		{
+#ifdef GATHER_STATISTICS
+			++reverseFutilityCutoffs;
+#endif // GATHER_STATISTICS
+
+			return staticEvaluation - RFP_MARGIN * depth;
+		}
+#endif // USE_REVERSE_FUTILITY_PRUNING
+
+#if defined(USE_RAZORING) && defined(USE_QUIESCENCE_SEARCH)
+		// if we are so far behind that only tactics could save us, verify with a quiescence search whether they do
+		if(depth <= RAZORING_MAX_DEPTH && staticEvaluation + RAZORING_MARGIN * depth <= alpha)
+		{
+			int value = quiescence(gameState, ply, alpha, alpha + 1);
+
+			if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+			{
+				return 0;
+			}
+
+			if(value <= alpha)
+			{
+#ifdef GATHER_STATISTICS
+				++razoringCutoffs;
+#endif // GATHER_STATISTICS
+
+				return value;
+			}
+		}
+#endif // USE_RAZORING && USE_QUIESCENCE_SEARCH
+	}
+
+#ifdef USE_NULL_MOVE_PRUNING
+	if(pruningAllowed && nullMoveAllowed && staticEvaluation >= beta && SearchCore::isNullMoveAllowed(gameState, depth))
+	{
+#ifdef GATHER_STATISTICS
+		++nullMovesTried;
+#endif // GATHER_STATISTICS
+
+		plyMoves[ply] = INVALID_MOVE;		// a null move has no countermove
+		int nullMoveValue;
+
+		if(SearchCore::tryNullMove(gameState, depth, ply, beta, staticEvaluation, searchControl,
+			[this, &gameState](int searchDepth, int searchPly, int searchAlpha, int searchBeta, bool allowNullMove)
+			{
+				return alphaBeta(gameState, searchDepth, searchPly, searchAlpha, searchBeta, allowNullMove);
+			}, nullMoveValue))
+		{
+#ifdef GATHER_STATISTICS
+			++nullMoveCutoffs;
+#endif // GATHER_STATISTICS
+
+			return std::min(nullMoveValue, WIN_EVALUATION - MAX_WIN_DISTANCE);
+		}
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+	}
+#endif // USE_NULL_MOVE_PRUNING
+
+#if defined(USE_PROBCUT) || defined(USE_MULTI_CUT)
+	// ProbCut and Multi-Cut predict the result of the full search from shallower searches, which miss wins and losses that are
+	// just beyond their horizon. So they are not applied near a win: if the window or the table value are win scores, or if
+	// either player can move a knight into its danger zone
+	bool nearWin = (SearchCore::isWinScore(alpha, WIN_EVALUATION) || SearchCore::isWinScore(beta, WIN_EVALUATION) ||
+					(tableDataValid && SearchCore::isWinScore(tableValue, WIN_EVALUATION)) ||
+					(MoveGenerator::getKnightTargets(currentPlayer, gameState.getBitboard(currentPlayer)) & MoveGenerator::getDangerZone(currentPlayer)) != Bitboards::ALL_ZERO ||
+					(MoveGenerator::getKnightTargets(opponent, gameState.getBitboard(opponent)) & MoveGenerator::getDangerZone(opponent)) != Bitboards::ALL_ZERO);
+#endif // USE_PROBCUT || USE_MULTI_CUT
+
+#ifdef USE_PROBCUT
+	if(probCutEnabled && pruningAllowed && quietPosition && !nearWin && depth >= PROBCUT_MIN_DEPTH)
+	{
+		// the shallow score above which the deep search is predicted to fail high with enough confidence
+		int probCutBeta = (int)std::ceil((beta + PROBCUT_THRESHOLD * PROBCUT_SIGMA - PROBCUT_B) / PROBCUT_A);
+		int shallowDepth = depth - PROBCUT_DEPTH_REDUCTION;
+
+		if(alphaBeta(gameState, shallowDepth, ply, probCutBeta - 1, probCutBeta, nullMoveAllowed) >= probCutBeta && !searchControl.isStopped())
+		{
+#ifdef GATHER_STATISTICS
+			++probCutCutoffs;
+#endif // GATHER_STATISTICS
+
+			return beta;
+		}
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+	}
+#endif // USE_PROBCUT
+
+	// true iff quiet moves at this node cannot raise the score to alpha, and can therefore be skipped
+	bool futileNode = false;
+#ifdef USE_FUTILITY_PRUNING
+	futileNode = (pruningAllowed && quietPosition && depth <= FUTILITY_MAX_DEPTH && staticEvaluation + FUTILITY_MARGIN * depth <= alpha);
+#endif // USE_FUTILITY_PRUNING
+
+	Move transpositionMove = tableMove;
+
+#ifdef USE_INTERNAL_ITERATIVE_DEEPENING
+	if(transpositionMove == INVALID_MOVE && pvNode && depth >= IID_MIN_DEPTH && !exclusionSearch)
+	{
+#ifdef GATHER_STATISTICS
+		++iidSearches;
+#endif // GATHER_STATISTICS
+
+		// a bad first move is very expensive at a deep PV node, so let a reduced search find a better one
+		alphaBeta(gameState, depth - IID_REDUCTION, ply, alpha, beta, nullMoveAllowed);
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
+		const TableData& iidData = transpositionTable.retrieve(zobrist);
+
+		if(iidData.isValid())
+		{
+			transpositionMove = iidData.bestMove;
+		}
+	}
+#endif // USE_INTERNAL_ITERATIVE_DEEPENING
+
+	Move killerMove1 = INVALID_MOVE;
+	Move killerMove2 = INVALID_MOVE;
+
+	if(killerMoves.size() > depth)	// may have killer moves stored
+	{
+		std::vector<Move>& currentDepthKillerMoves = killerMoves[depth];
+
+		if(currentDepthKillerMoves.size() > 0)
+		{
+			killerMove1 = currentDepthKillerMoves[0];
+
+			if(currentDepthKillerMoves.size() > 1)
+			{
+				killerMove2 = currentDepthKillerMoves[1];
+			}
+		}
+	}
+
+	// extension (in fractional plies) of the transposition move if it turns out to be singular
+	int singularExtension = 0;
+
+#ifdef USE_SINGULAR_EXTENSIONS
+	if(singularCandidate && !(transpositionMove == INVALID_MOVE))
+	{
+#ifdef GATHER_STATISTICS
+		++singularSearches;
+#endif // GATHER_STATISTICS
+
+		// the transposition move is singular if all other moves fail low against a bound just below its value
+		int value = alphaBeta(gameState, (depth - 1) / 2, ply, singularBeta - 1, singularBeta, false, transpositionMove);
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
+		if(value < singularBeta)
+		{
+#ifdef GATHER_STATISTICS
+			++singularMoves;
+#endif // GATHER_STATISTICS
+
+			singularExtension = SINGULAR_EXTENSION;
+		}
+	}
+#endif // USE_SINGULAR_EXTENSIONS
+
+	// the move that led to this node, and the quiet moves searched in this node, for the history heuristic
+	const Move& previousMove = plyMoves[ply - 1];
+	std::vector<Move>& quietMoves = searchedQuietMoves[ply];
+	quietMoves.clear();
+
+#ifdef USE_HISTORY_HEURISTIC
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)),
+								transpositionMove, killerMove1, killerMove2,
+								&historyTable, historyTable.getCountermove(previousMove), excludedMove);
+#else
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)),
+								transpositionMove, killerMove1, killerMove2,
+								nullptr, INVALID_MOVE, excludedMove);
+#endif // USE_HISTORY_HEURISTIC
+
+#ifdef USE_MULTI_CUT
+	// only worth trying at nodes that are expected to fail high
+	if(pruningAllowed && quietPosition && !nearWin && depth >= MULTICUT_MIN_DEPTH && staticEvaluation >= beta)
+	{
+		MoveGenerator multiCutMoveGenerator(currentPlayer,
+											gameState.getBitboard(currentPlayer),
+											gameState.getBitboard(opponent),
+											transpositionMove, killerMove1, killerMove2);
+
+		int numCutoffs = 0;
+		Move multiCutMove = multiCutMoveGenerator.nextMove();
+
+		for(int i = 0; i < MULTICUT_NUM_MOVES && !(multiCutMove == INVALID_MOVE); ++i)
+		{
+			plyMoves[ply] = multiCutMove;
+			gameState.applyMove(multiCutMove);
+			int value = -alphaBeta(gameState, depth - 1 - MULTICUT_REDUCTION, ply + 1, -beta, -beta + 1);
+			gameState.undoMove(multiCutMove);
+
+			if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+			{
+				return 0;
+			}
+
+			if(value >= beta && ++numCutoffs >= MULTICUT_NUM_CUTOFFS)
+			{
+#ifdef GATHER_STATISTICS
+				++multiCutCutoffs;
+#endif // GATHER_STATISTICS
+
+				return beta;
+			}
+
+			multiCutMove = multiCutMoveGenerator.nextMove();
+		}
+	}
+#endif // USE_MULTI_CUT
+
+	// extension (in fractional plies) of all moves of this node
+	int nodeExtension = 0;
+
+#ifdef USE_THREAT_EXTENSIONS
+	if(opponentThreat && SearchCore::isSingleReply(gameState))
+	{
+		nodeExtension = SINGLE_REPLY_EXTENSION;
+	}
+#endif // USE_THREAT_EXTENSIONS
+
+	int score = MathConstants::LOW_ENOUGH_INT;
+	Move m = moveGenerator.nextMove();
+	Move bestMove = m;
+	bool firstMove = true;
+
+	while(!(m == INVALID_MOVE))
+	{
+		int moveIndex = moveGenerator.getNumMovesReturned();
+		// true iff this is a late quiet move, which may be reduced or pruned
+		bool lateQuietMove = (!opponentThreat && moveGenerator.getMoveStage() == EMoveStage::Type::QUIET_MOVE &&
+							  !MoveGenerator::isTacticalMove(m, currentPlayer));
+
+#ifdef USE_LATE_MOVE_PRUNING
+		if(lateQuietMove && !pvNode && depth <= LMP_MAX_DEPTH && moveIndex > LMP_BASE + LMP_FACTOR * depth * depth)
+		{
+#ifdef GATHER_STATISTICS
+			++lateMovesPruned;
+#endif // GATHER_STATISTICS
+
+			m = moveGenerator.nextMove();
+			continue;
+		}
+#endif // USE_LATE_MOVE_PRUNING
+
+		if(futileNode && !firstMove && !MoveGenerator::isTacticalMove(m, currentPlayer))
+		{
+#ifdef GATHER_STATISTICS
+			++futilityPrunedMoves;
+#endif // GATHER_STATISTICS
+
+			// the move is assumed to score no better than the static evaluation plus the margin, which is still a fail low
+			score = std::max(score, staticEvaluation + FUTILITY_MARGIN * depth);
+			m = moveGenerator.nextMove();
+			continue;
+		}
+
+		int reduction = 0;
+
+#ifdef USE_LATE_MOVE_REDUCTIONS
+		if(lateQuietMove && !firstMove)
+		{
+			reduction = lateMoveReductions[std::min(depth, PVS_MAX_PLY)][std::min(moveIndex, PVS_MAX_MOVES)];
+
+			if(pvNode && reduction > 0)		// be a bit more careful in nodes that may end up on the principal variation
+			{
+				--reduction;
+			}
+		}
+#endif // USE_LATE_MOVE_REDUCTIONS
+
+		// the depth of the child, before any reduction
+		int newDepth = depth - 1;
+		int moveExtension = nodeExtension + ((m == transpositionMove) ? singularExtension : 0);
+
+#ifdef USE_THREAT_EXTENSIONS
+		moveExtension += SearchCore::getMoveExtension(gameState, m);
+#endif // USE_THREAT_EXTENSIONS
+
+		int extension = SearchCore::extend(pathExtensions[ply], moveExtension, pathExtensions[ply + 1]);
+
+		if(extension > 0)
+		{
+#ifdef GATHER_STATISTICS
+			++extendedMoves;
+#endif // GATHER_STATISTICS
+
+			newDepth += extension;
+			reduction = 0;
+		}
+
+		plyMoves[ply] = m;
+		gameState.applyMove(m);												// apply move
+
+		int value;
+		if(firstMove)		// expected to be the best move, so search it with the full window
+		{
+			value = -alphaBeta(gameState, newDepth, ply + 1, -beta, -alpha);
+			firstMove = false;
+		}
+		else				// try to prove that this move is not better than alpha with a cheap null window search
+		{
+			value = -alphaBeta(gameState, newDepth - reduction, ply + 1, -alpha - 1, -alpha);
+
+#ifdef GATHER_STATISTICS
+			++scoutSearches;
+
+			if(reduction > 0)
+			{
+				++reducedMoves;
+			}
+#endif // GATHER_STATISTICS
+
+			if(reduction > 0 && value > alpha && !searchControl.isStopped())		// reduced search failed high, so verify with the full depth
+			{
+#ifdef GATHER_STATISTICS
+				++reductionReSearches;
+#endif // GATHER_STATISTICS
+
+				value = -alphaBeta(gameState, newDepth, ply + 1, -alpha - 1, -alpha);
+			}
+
+			if(value > alpha && value < beta && !searchControl.isStopped())		// scout search failed high, so need the real value
+			{
+#ifdef GATHER_STATISTICS
+				++reSearches;
+#endif // GATHER_STATISTICS
+
+				value = -alphaBeta(gameState, newDepth, ply + 1, -beta, -alpha);
+			}
+		}
+
+		gameState.undoMove(m);												// finished searching this subtree, so undo the move
+
+		if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+		{
+			return 0;
+		}
+
+		if(value > score)		// new best move found
+		{
+			score = value;
+			bestMove = m;
+		}
+		if(score > alpha)
+		{
+			alpha = score;
+			updatePrincipalVariation(ply, m);
+		}
+		if(score >= beta)
+		{
+			storeKillerMove(depth, m);
+
+#ifdef USE_HISTORY_HEURISTIC
+			if(!m.captured)
+			{
+				historyTable.updateHistory(currentPlayer, m, quietMoves.data(), (int)quietMoves.size(), depth);
+				historyTable.storeCountermove(previousMove, m);
+			}
+#endif // USE_HISTORY_HEURISTIC
+
+			break;
+		}
+
+		if(!m.captured)
+		{
+			quietMoves.push_back(m);
+		}
+
+		m = moveGenerator.nextMove();
+	}
+
+	// Store data in Transposition Table
+	if(score <= originalAlpha)		// found upper bound
+	{
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::UPPER_BOUND, depth);
+	}
+	else if(score >= beta)			// found lower bound
+	{
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, depth);
+	}
+	else							// found exact value
+	{
+		transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::REAL, depth);
+	}
+
+	return score;
+}
+
+int PrincipalVariationSearch::quiescence(GameState& gameState, int ply, int alpha, int beta)
+{
+	pvLength[ply] = 0;		// no principal variation known yet for this node
+
+	if(searchControl.visitNode())		// search terminated, so the result of this node is useless
+	{
+		return 0;
+	}
+
+#ifdef GATHER_STATISTICS
+	++quiescenceNodes;
+#endif // GATHER_STATISTICS
+
+	EPlayerColors::Type winner = gameState.getWinner();
+
+	if(ply >= PVS_MAX_PLY || winner != EPlayerColors::Type::NOTHING)
+	{
+		return SearchCore::scoreEvaluation(evaluate(gameState, winner), ply, WIN_EVALUATION);
+	}
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	EPlayerColors::Type opponent = gameState.getOpponentColor(currentPlayer);
+	uint64_t playerBitboard = gameState.getBitboard(currentPlayer);
+	uint64_t opponentBitboard = gameState.getBitboard(opponent);
+	uint64_t dangerZone = MoveGenerator::getDangerZone(currentPlayer);
+
+	if(playerBitboard & dangerZone)		// we can move to the goal row right away
+	{
+		return SearchCore::getWinScore(ply + 1, WIN_EVALUATION);
+	}
+
+#ifdef USE_RACE_DETECTION
+	// also recognizes races that take several moves, so the stand-pat evaluation below is never a win or a loss
+	int racePlies = RaceDetector::detectRace(gameState);
+	if(racePlies != 0)
+	{
+#ifdef GATHER_STATISTICS
+		++raceCutoffs;
+#endif // GATHER_STATISTICS
+
+		return SearchCore::scoreEvaluation(SearchCore::getDistanceEvaluation(racePlies, WIN_EVALUATION), ply, WIN_EVALUATION);
+	}
+#endif // USE_RACE_DETECTION
+
+	if(SearchCore::mateDistancePruning(ply, WIN_EVALUATION, alpha, beta))		// cannot improve on a faster win found elsewhere
+	{
+		return alpha;
+	}
+
+	int originalAlpha = alpha;
+	uint64_t zobrist = gameState.getZobrist();
+	const TableData& tableData = transpositionTable.retrieve(zobrist);
+
+	if(tableData.isValid())		// any stored search is at least as deep as a quiescence search
+	{
+		int tableValue = SearchCore::scoreFromTable(tableData.value, ply, WIN_EVALUATION);
+
+		if(tableData.valueType == EValue::Type::REAL)
+		{
+			return tableValue;
+		}
+		else if(tableData.valueType == EValue::Type::LOWER_BOUND)
+		{
+			alpha = std::max(alpha, tableValue);
+		}
+		else if(tableData.valueType == EValue::Type::UPPER_BOUND)
+		{
+			beta = std::min(beta, tableValue);
+		}
+
+		if(alpha >= beta)
+		{
+			return tableValue;
+		}
+	}
+
+	// all squares our knights can move to, computed set-wise so that quiet positions are recognized without generating any moves
+	uint64_t targets = MoveGenerator::getKnightTargets(currentPlayer, playerBitboard) & ~playerBitboard;
+	uint64_t opponentThreats = opponentBitboard & MoveGenerator::getDangerZone(opponent);
+
+	int standPat;
+	uint64_t moveTargets;
+
+	if(opponentThreats)
+	{
+		// the opponent wins on its next move unless we capture its threatening knight right now, so we cannot stand pat
+		if((opponentThreats & (opponentThreats - 1)) || !(targets & opponentThreats))		// more than one threat, or no way to capture it
+		{
+			return -SearchCore::getWinScore(ply + 2, WIN_EVALUATION);
+		}
+
+		standPat = -SearchCore::getWinScore(ply + 2, WIN_EVALUATION);
+		moveTargets = opponentThreats;
+	}
+	else
+	{
+		standPat = evaluate(gameState, winner);
+
+		if(standPat >= beta)
+		{
+			return standPat;
+		}
+
+		moveTargets = targets & (opponentBitboard | dangerZone);
+
+		if(!moveTargets)		// quiet position
+		{
+			return standPat;
+		}
+
+		alpha = std::max(alpha, standPat);
+	}
+
+	int score = standPat;
+	Move bestMove = INVALID_MOVE;
+	bool searchedMove = false;
+
+	// first search all captures, then all quiet moves into the danger zone
+	uint64_t stageTargets[2] = { moveTargets & opponentBitboard, moveTargets & ~opponentBitboard };
+
+	for(int stage = 0; stage < 2 && score < beta; ++stage)
+	{
+		uint64_t knights = playerBitboard;
+
+		while(knights && score < beta)
+		{
+			int knightSquare = Bitboards::bitScanForward(knights);
+			const std::vector<int>& knightMoveTargets = GameState::getMoveTargets(knightSquare, currentPlayer);
+
+			for(int moveTarget : knightMoveTargets)
+			{
+				uint64_t moveTargetBit = Bitboards::singleBit(moveTarget);
+
+				if(!(moveTargetBit & stageTargets[stage]))
+				{
+					continue;
+				}
+
+				// delta pruning: a plain capture cannot raise the score to alpha if even the margin is not enough
+				if(stage == 0 && !opponentThreats && !(moveTargetBit & dangerZone) && standPat + QS_DELTA_MARGIN <= alpha)
+				{
+#ifdef GATHER_STATISTICS
+					++deltaPrunedMoves;
+#endif // GATHER_STATISTICS
+
+					continue;
+				}
+
+				Move m(knightSquare, moveTarget, (stage == 0));
+				searchedMove = true;
+
+				gameState.applyMove(m);
+				int value = -quiescence(gameState, ply + 1, -beta, -alpha);
+				gameState.undoMove(m);
+
+				if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+				{
+					return 0;
+				}
+
+				if(value > score)		// new best move found
+				{
+					score = value;
+					bestMove = m;
+				}
+				if(score > alpha)
+				{
+					alpha = score;
+					updatePrincipalVariation(ply, m);
+				}
+				if(score >= beta)
+				{
+					break;
+				}
+			}
+
+			knights &= knights - 1;		// set the bit we just processed to 0
+		}
+	}
+
+	if(searchedMove)		// only worth storing if we did more than evaluating the node
+	{
+		if(score <= originalAlpha)		// found upper bound
+		{
+			transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::UPPER_BOUND, 0);
+		}
+		else if(score >= beta)			// found lower bound
+		{
+			transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::LOWER_BOUND, 0);
+		}
+		else							// found exact value
+		{
+			transpositionTable.storeData(bestMove, zobrist, SearchCore::scoreToTable(score, ply, WIN_EVALUATION), EValue::Type::REAL, 0);
+		}
+	}
+
+	return score;
+}
+
+int PrincipalVariationSearch::evaluate(const GameState& gameState) const
+{
+	return evaluate(gameState, gameState.getWinner());
+}
+
+int PrincipalVariationSearch::evaluate(const GameState& gameState, EPlayerColors::Type winner) const
+{
+	EPlayerColors::Type evaluatingPlayer = gameState.getCurrentPlayer();
+
+	if(winner == evaluatingPlayer)						// evaluating player won
+	{
+		return WIN_EVALUATION;
+	}
+	else if(winner != EPlayerColors::Type::NOTHING)	// opponent won
+	{
+		return -WIN_EVALUATION;
+	}
+
+	// at this point in code, compute evaluation from white's perspective
+	// at the end, before returning, negate if black is evaluating
+
+	// simple material difference, weight = 100, range = [-1600, 1600]
+	int materialDifference = 100 * (gameState.getNumWhiteKnights() - gameState.getNumBlackKnights());
+
+	uint64_t blackBitboard = gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER);
+	uint64_t whiteBitboard = gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER);
+
+	// If black is to move next and already has a piece in the bottom danger zone, simply treat it as a win for black
+	if(evaluatingPlayer == EPlayerColors::Type::BLACK_PLAYER && (blackBitboard & Bitboards::DANGER_ZONE_BOTTOM))
+	{
+		return WIN_EVALUATION;
+	}	// and similar check for white
+	else if(evaluatingPlayer == EPlayerColors::Type::WHITE_PLAYER && (whiteBitboard & Bitboards::DANGER_ZONE_TOP))
+	{
+		return WIN_EVALUATION;
+	}
+
+#ifdef USE_RACE_DETECTION
+	// more generally, a knight that is further away from its goal row may still be certain to get there first
+	int racePlies = RaceDetector::detectRace(gameState);
+	if(racePlies != 0)
+	{
+		return SearchCore::getDistanceEvaluation(racePlies, WIN_EVALUATION);
+	}
+#endif // USE_RACE_DETECTION
+
+	// progression = difference in furthest moved knight, weight = 35, range = [-210, 210] (because max advantage = 6)
+	int progression = 35 * (gameState.getProgression(EPlayerColors::Type::WHITE_PLAYER) - gameState.getProgression(EPlayerColors::Type::BLACK_PLAYER));
+
+	// compute final score
+	int score = materialDifference + progression;
+
+	// negate score in case we're black, since so far we assumed we're white
+	if(evaluatingPlayer == EPlayerColors::Type::BLACK_PLAYER)
+	{
+		score = -score;
+	}
+
+	return score;
+}
+
+
+void PrincipalVariationSearch::updatePrincipalVariation(int ply, const Move& move)
+{
+	std::vector<Move>& pv = pvTable[ply];
+	const std::vector<Move>& childPv = pvTable[ply + 1];
+	int childPvLength = pvLength[ply + 1];
+
+	pv[0] = move;
+	for(int i = 0; i < childPvLength; ++i)
+	{
+		pv[i + 1] = childPv[i];
+	}
+
+	pvLength[ply] = childPvLength + 1;
+}
+
+void PrincipalVariationSearch::storeKillerMove(int depth, const Move& move)
+{
+	while(depth >= killerMoves.size()) // don't have a vector of killer moves yet for this depth
+	{
+		std::vector<Move> currentDepthKillerMoves;
+		currentDepthKillerMoves.reserve(2);		// 2 slots of Killer Moves
+		killerMoves.push_back(currentDepthKillerMoves);
+	}
+
+	std::vector<Move>& currentDepthKillerMoves = killerMoves[depth];	// killer moves for this depth
+	if(currentDepthKillerMoves.size() > 0)		// already have at least 1 killer move
+	{
+		if(currentDepthKillerMoves[0] == move)	// this killer move already stored in first slot
+		{
+			return;
+		}
+
+		if(currentDepthKillerMoves.size() > 1)	// already have 2 killer moves stored
+		{
+			if(currentDepthKillerMoves[1] == move)	// this killer move already stored in second slot
+			{
+				return;
+			}
+
+			currentDepthKillerMoves[0] = currentDepthKillerMoves[1];	// move second kill move to first slot
+			currentDepthKillerMoves.pop_back();							// and then remove second (which is now also in first slot)
+		}
+	}
+
+	currentDepthKillerMoves.push_back(move);							// and put the new kill move in second slot
+}
+
+int PrincipalVariationSearch::getLastSearchDepth()
+{
+	return searchDepth;
+}
+
+double PrincipalVariationSearch::getSecondsSearched()
+{
+	return clock.getElapsedTimeInSec();
+}
+
+const std::vector<Move>& PrincipalVariationSearch::getPrincipalVariation() const
+{
+	return principalVariation;
+}
+
+void PrincipalVariationSearch::disableOpeningBook()
+{
+	openingBook.close();
+}
+
+void PrincipalVariationSearch::disableProbCut()
+{
+	probCutEnabled = false;
+}
+
+Move PrincipalVariationSearch::startPrincipalVariationSearch(GameState& gameState)
+{
+	clock.start();
+	timeManager.startMove(searchLimits, gameState);
+	searchControl.startSearch(timeManager.getTargetTimeMs(), timeManager.getMaxTimeMs(), searchLimits.maxNodes);
+	principalVariation.clear();
+	historyTable.age();		// let information of previous searches gradually fade
+	EPlayerColors::Type winner = gameState.getWinner();
+
+	// stop search if we reached max depth or have found a winner
+	if(winner != EPlayerColors::Type::NOTHING)
+	{
+		return INVALID_MOVE;		// can't return any normal move if game already ended
+	}
+
+#ifdef USE_THREAT_SPACE_SEARCH
+	// a forced win by threats is usually far beyond the depth that the full search can reach, and costs very little to find
+	Move threatSpaceMove = INVALID_MOVE;
+	int threatSpacePlies = threatSpaceSearch.solve(gameState, TSS_ROOT_MAX_PLIES, TSS_ROOT_MAX_NODES, threatSpaceMove);
+
+#ifdef GATHER_STATISTICS
+	++threatSpaceSearches;
+	threatSpaceNodes += threatSpaceSearch.getNodesVisited();
+#endif // GATHER_STATISTICS
+
+	if(threatSpacePlies > 0)
+	{
+#ifdef GATHER_STATISTICS
+		++threatSpaceWins;
+#endif // GATHER_STATISTICS
+
+		searchDepth = threatSpacePlies;
+		lastRootEvaluation = SearchCore::getWinScore(threatSpacePlies, WIN_EVALUATION);
+		principalVariation.push_back(threatSpaceMove);
+		reportIteration(searchDepth, lastRootEvaluation, threatSpaceMove, threatSpaceSearch.getNodesVisited(), searchControl.getElapsedMs(), principalVariation);
+		clock.stop();
+		return threatSpaceMove;
+	}
+#endif // USE_THREAT_SPACE_SEARCH
+
+	std::vector<Move> moves;				// will store all the moves in the root node, necessary for move ordering based on scores found in previous searches
+	moves.reserve(16 * 4);
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	MoveGenerator moveGenerator(currentPlayer,
+								gameState.getBitboard(currentPlayer),
+								gameState.getBitboard(gameState.getOpponentColor(currentPlayer)));
+
+	Move rootMove = moveGenerator.nextMove();
+
+	while(!(rootMove == INVALID_MOVE))
+	{
+		moves.push_back(rootMove);
+		rootMove = moveGenerator.nextMove();
+	}
+
+	std::vector<int> moveScores;			// will store the scores of the moves here, to use for sorting
+	moveScores.resize(moves.size(), 0);
+
+	if(moves.empty())
+	{
+		clock.stop();
+		return INVALID_MOVE;		// no legal moves, so there is nothing to fall back to either
+	}
+
+	// best move found from a complete search (so not considering searches that were terminated early). Starts out as the
+	// first legal move, so that a search that is stopped before completing its first iteration still returns a playable move
+	Move bestMoveCompleteSearch = moves[0];
+
+	searchDepth = 0;
+	while(true)
+	{
+		++searchDepth;			// increment search depth for the new search
+		killerMoves.clear();	// clear table of killer moves
+		pvLength[0] = 0;
+
+		// ================= PRINCIPAL VARIATION SEARCH STARTS HERE =================
+		int score = MathConstants::LOW_ENOUGH_INT;
+		int alpha = MathConstants::LOW_ENOUGH_INT;
+		int beta = MathConstants::LARGE_ENOUGH_INT;
+
+		// best move for only this particular search
+		Move bestMove = moves[0];
+		// best move of this particular search if it is terminated early
+		Move bestMovePartialSearch = INVALID_MOVE;
+
+		for(int i = 0; i < moves.size(); ++i)
+		{
+			const Move& m = moves[i];											// select move
+			plyMoves[0] = m;
+			gameState.applyMove(m);												// apply move
+
+			// true iff a scout search proved this move to be better than all previous moves
+			bool scoutFailedHigh = false;
+			int value;
+
+			if(i == 0)
+			{
+				value = -alphaBeta(gameState, searchDepth - 1, 1, -beta, -alpha);
+			}
+			else
+			{
+				value = -alphaBeta(gameState, searchDepth - 1, 1, -alpha - 1, -alpha);
+
+				if(value > alpha && !searchControl.isStopped())
+				{
+					scoutFailedHigh = true;
+					value = -alphaBeta(gameState, searchDepth - 1, 1, -beta, -alpha);
+				}
+			}
+
+			gameState.undoMove(m);												// finished searching this subtree, so undo the move
+
+			if(searchControl.isStopped())		// search terminated, so the result of this subtree is useless
+			{
+				// the previous best move is always searched first, so any best move after that is at least as good
+				if(scoutFailedHigh)
+				{
+					bestMovePartialSearch = m;
+				}
+				else if(i > 0)
+				{
+					bestMovePartialSearch = bestMove;
+				}
+
+				bestMove = INVALID_MOVE;
+				break;
+			}
+
+			moveScores[i] = value;
+
+			if(value > score)		// new best move found
+			{
+				score = value;
+				bestMove = m;
+			}
+			if(score > alpha)
+			{
+				alpha = score;
+				updatePrincipalVariation(0, m);
+			}
+		}
+		// =================  PRINCIPAL VARIATION SEARCH ENDS HERE  =================
+
+		if(!(bestMove == INVALID_MOVE))	// managed to complete the search within time
+		{
+			lastRootEvaluation = score;
+			principalVariation.assign(pvTable[0].begin(), pvTable[0].begin() + pvLength[0]);
+			timeManager.iterationCompleted(score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs());
+			reportIteration(searchDepth, score, bestMove, searchControl.getNodesVisited(), searchControl.getElapsedMs(), principalVariation);
+
+			// the search proved a win or a loss, and searched deep enough to be sure that there is no faster one. The best move
+			// then either wins as fast as possible, or postpones the loss as long as possible
+			if(SearchCore::isWinScore(score, WIN_EVALUATION) && SearchCore::getWinDistance(score, WIN_EVALUATION) <= searchDepth)
+			{
+				return bestMove;
+			}
+
+			// finished search, and didn't prove a win for either team, so save the new best result
+			bestMoveCompleteSearch = bestMove;
+		}
+		else
+		{
+			--searchDepth;	// since last search was unsuccessful, decrement this so GUI doesn't lie to us
+
+			if(!(bestMovePartialSearch == INVALID_MOVE))
+			{
+				bestMoveCompleteSearch = bestMovePartialSearch;
+			}
+		}
+
+		if(searchControl.isStopped() || (searchLimits.maxDepth > 0 && searchDepth >= searchLimits.maxDepth) ||
+			!timeManager.shouldStartNextIteration(searchControl.getElapsedMs()))		// search terminated, exceeding depth limit, or next iteration not expected to finish in time
+		{
+			clock.stop();
+			return bestMoveCompleteSearch;
+		}
+
+		MoveOrdering::orderMoves(moves, moveScores);	// order moves for the next search
+
+		// reset all scores to 0 before starting new search
+		for(int i = 0; i < moveScores.size(); ++i)
+		{
+			moveScores[i] = 0;
+		}
+	}
+}
+
+int PrincipalVariationSearch::getRootEvaluation()
+{
+	return lastRootEvaluation;
+}
+
+int PrincipalVariationSearch::getWinEvaluation()
+{
+	return WIN_EVALUATION;
+}
+
+void PrincipalVariationSearch::logEndOfMatchStats()
+{
+#ifdef LOG_STATS_END_OF_MATCH
+	LOG_MESSAGE("Principal Variation Search engine END OF GAME stats:")
+	LOG_MESSAGE(StringBuilder() << "Number of nodes visited:			" << totalNodesVisited)
+	LOG_MESSAGE(StringBuilder() << "Time spent:					" << totalTimeSpent << " ms")
+	LOG_MESSAGE("")
+#endif // LOG_STATS_END_OF_MATCH
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#include "AiEngine.h"
+#include "HistoryTable.h"
+#include "OpeningBook.h"
+#include "Tablebase.h"
+#include "ThreatSpaceSearch.h"
+#include "TimeManager.h"
+#include "Timer.hpp"
+#include "TranspositionTable.h"
+
+/**
+ * The maximum number of plies that the Principal Variation Search engine can search away from the root.
+ * Determines the size of the triangular PV array
+ */
+#define PVS_MAX_PLY 64
+
+/** The maximum number of moves in a single position, used as the size of the move index dimension of the reduction table */
+#define PVS_MAX_MOVES 64
+
+/**
+ * Engine using Principal Variation Search (also known as NegaScout) inside Iterative Deepening.
+ *
+ * Uses the same Transposition Table, Killer Moves and Move Generator as the Aspiration Search engine.
+ * In every node, the first move is searched with the full window. All other moves are first searched
+ * with a null window around alpha, to prove that they are not better than the first move. Only if such a
+ * scout search fails high, the move is re-searched with the full window.
+ *
+ * The principal variation is collected in a triangular PV array, and reported with every completed iteration.
+ *
+ * Late quiet moves (generated after the TT move, killer moves and captures) are searched with a reduced depth
+ * (Late Move Reductions), and re-searched with the full depth if they unexpectedly fail high. Close to the leaves,
+ * late quiet moves are not searched at all (Late Move Pruning). Tactical moves (see MoveGenerator::isTacticalMove())
+ * are never reduced or pruned, and neither are any moves while the opponent threatens to win on its next move.
+ *
+ * Quiet moves are ordered by a butterfly history table and a countermove table, which persist (aged) between searches.
+ *
+ * Close to the leaves, non-PV nodes in quiet positions are pruned based on margins around the static evaluation
+ * (reverse futility pruning, futility pruning and razoring). Deeper non-PV nodes may be cut off by null-move pruning,
+ * by ProbCut (if a shallow search predicts with high confidence that the deep search would fail high), or by
+ * Multi-Cut (if several of the first moves already fail high at a reduced depth). Before searching any child of a deep
+ * node, the Transposition Table entries of all children are probed, and the node is cut off if one of them already proves
+ * a fail high (Enhanced Transposition Cutoffs). This pays off because moves of knights on different files commute, and
+ * therefore transpositions are very common.
+ *
+ * Moves that enter the danger zone or capture a knight in the opponent's danger zone, and single replies to a threat, are
+ * extended by fractions of a ply, within a budget per path, so that forced sequences are not cut off by the horizon.
+ * Transposition Table moves are also extended if a reduced exclusion search of all other moves shows that they are
+ * singular, meaning that all alternatives are clearly worse.
+ *
+ * Deep PV nodes without a Transposition Table move first run a reduced search (internal iterative deepening), so that
+ * the full search starts with the best move found by the reduced search instead of the fixed move order.
+ *
+ * Before the full search starts, and at deep PV nodes, a threat-space search tries to prove a forced win by goal row
+ * threats, which is usually much deeper than the full search could see.
+ *
+ * Positions with few enough knights are looked up in the endgame tablebases (if they were generated), which return the
+ * exact distance to the win or loss, so such subtrees never need to be searched.
+ *
+ * Positions in the opening book are not searched at all, but answered with the move stored in the book.
+ *
+ * Instead of evaluating the leaves directly, a quiescence search resolves captures and moves into the danger zone,
+ * so that leaves in the middle of an exchange or right before a goal row threat are not mis-evaluated.
+ */
+class PrincipalVariationSearch : public AiEngine
+{
+public:
+	PrincipalVariationSearch();
+
+	virtual Move chooseMove(GameState& gameState);
+
+	/** Returns the last depth that the algorithm managed to fully search */
+	int getLastSearchDepth();
+	/** Returns the number of seconds spent searching last time */
+	double getSecondsSearched();
+	/** Returns the principal variation of the last completed iteration */
+	const std::vector<Move>& getPrincipalVariation() const;
+	/** Stops the engine from playing moves from the opening book, so that it searches every position itself */
+	void disableOpeningBook();
+	/** Stops the engine from applying ProbCut (if USE_PROBCUT is defined), so that its scores can be used to calibrate ProbCut */
+	void disableProbCut();
+
+	virtual int getRootEvaluation();
+	virtual int getWinEvaluation();
+	virtual void logEndOfMatchStats();
+
+private:
+	/** The engine's Transposition Table */
+	TranspositionTable transpositionTable;
+
+	/** Table of killer moves */
+	std::vector<std::vector<Move>> killerMoves;
+
+	/** History and countermove tables used to order quiet moves */
+	HistoryTable historyTable;
+
+	/** Solver for forced wins by goal row threats, run at the root and at deep PV nodes */
+	ThreatSpaceSearch threatSpaceSearch;
+
+	/** Endgame tablebases, probed at interior nodes */
+	Tablebase tablebase;
+
+	/** Opening book, probed at the root before searching */
+	OpeningBook openingBook;
+
+	/** plyMoves[ply] = the move currently being searched at that ply, so that children can look up their countermove */
+	std::vector<Move> plyMoves;
+	/** pathExtensions[ply] = sum of the extensions (in fractional plies) made along the path from the root to the current node at that ply */
+	std::vector<int> pathExtensions;
+	/** searchedQuietMoves[ply] = the quiet moves searched so far in the node at that ply, which are penalized on a cutoff */
+	std::vector<std::vector<Move>> searchedQuietMoves;
+
+	/**
+	 * Triangular PV array. pvTable[ply] contains the principal variation of the node at that ply (as far as
+	 * it is known), pvLength[ply] the number of moves in it
+	 */
+	std::vector<std::vector<Move>> pvTable;
+	/** The lengths of the principal variations in pvTable */
+	std::vector<int> pvLength;
+
+	/** The principal variation of the last completed iteration */
+	std::vector<Move> principalVariation;
+
+	/** lateMoveReductions[depth][moveIndex] = the number of plies to reduce the search of a late quiet move with */
+	std::vector<std::vector<int>> lateMoveReductions;
+
+	/** A clock used to measure the time spent searching, as reported by getSecondsSearched() */
+	Timer clock;
+
+	/** The evaluation of the root node during the last search */
+	int lastRootEvaluation;
+
+	/** Whether ProbCut may be applied, see disableProbCut() */
+	bool probCutEnabled;
+
+	/** The default amount of time in milliseconds that the algorithm will spend search */
+	const int MIN_SEARCH_TIME_MS = 25000;
+	/** The default amount of time in milliseconds that the algorithm may spend on top of MIN_SEARCH_TIME_MS to complete or extend its search */
+	const int MAX_EXTRA_SEARCH_TIME_MS = 5000;
+
+	/** Decides how much time to spend on every move, and whether or not to start new iterations. Initialized after the constants above */
+	TimeManager timeManager;
+
+	// variables used for gathering and logging statistics
+	int64_t totalNodesVisited;
+	double totalTimeSpent;
+	int turnsPlayed;
+	int searchDepth;
+
+#ifdef GATHER_STATISTICS
+	/** Number of nodes visited with a null window (beta = alpha + 1) */
+	int64_t nullWindowNodes;
+	/** Number of scout searches that failed high and had to be re-searched with the full window */
+	int64_t reSearches;
+	/** Number of scout searches */
+	int64_t scoutSearches;
+	/** Number of moves searched with a reduced depth */
+	int64_t reducedMoves;
+	/** Number of reduced searches that failed high and had to be re-searched with the full depth */
+	int64_t reductionReSearches;
+	/** Number of moves pruned by Late Move Pruning */
+	int64_t lateMovesPruned;
+	/** Number of nodes visited by the quiescence search */
+	int64_t quiescenceNodes;
+	/** Number of captures skipped by delta pruning in the quiescence search */
+	int64_t deltaPrunedMoves;
+	/** Number of nodes cut off by reverse futility pruning */
+	int64_t reverseFutilityCutoffs;
+	/** Number of quiet moves skipped by futility pruning */
+	int64_t futilityPrunedMoves;
+	/** Number of nodes cut off by razoring */
+	int64_t razoringCutoffs;
+	/** Number of null moves tried */
+	int64_t nullMovesTried;
+	/** Number of nodes cut off by null-move pruning */
+	int64_t nullMoveCutoffs;
+	/** Number of nodes cut off by ProbCut */
+	int64_t probCutCutoffs;
+	/** Number of nodes cut off by Multi-Cut */
+	int64_t multiCutCutoffs;
+	/** Number of nodes where all children were probed in the Transposition Table for Enhanced Transposition Cutoffs */
+	int64_t etcProbedNodes;
+	/** Number of nodes cut off by Enhanced Transposition Cutoffs */
+	int64_t etcCutoffs;
+	/** Number of moves searched with an extension of at least one ply */
+	int64_t extendedMoves;
+	/** Number of exclusion searches for singular extensions */
+	int64_t singularSearches;
+	/** Number of Transposition Table moves found to be singular */
+	int64_t singularMoves;
+	/** Number of internal iterative deepening searches */
+	int64_t iidSearches;
+	/** Number of nodes where the race detector proved a win or a loss */
+	int64_t raceCutoffs;
+	/** Number of nodes that were found in the endgame tablebases */
+	int64_t tablebaseHits;
+	/** Number of threat-space searches */
+	int64_t threatSpaceSearches;
+	/** Number of nodes visited by threat-space searches */
+	int64_t threatSpaceNodes;
+	/** Number of threat-space searches that proved a win that was used */
+	int64_t threatSpaceWins;
+#endif // GATHER_STATISTICS
+
+	/**
+	* Continues principal variation search, given the game state, remaining search depth, distance from the root,
+	* and current alpha and beta values. If nullMoveAllowed is false, null-move pruning is not tried at this node.
+	* If an excludedMove is given, that move is not searched (exclusion search for singular extensions).
+	* Returns the node's evaluation.
+	*/
+	int alphaBeta(GameState& gameState, int depth, int ply, int alpha, int beta, bool nullMoveAllowed = true, Move excludedMove = INVALID_MOVE);
+
+	/**
+	* Quiescence search, given the game state, distance from the root, and current alpha and beta values.
+	* Only searches captures and moves into the danger zone (or, if the opponent threatens to win, the captures
+	* of the threatening knight), and uses the static evaluation as a stand-pat score otherwise.
+	* Returns the node's evaluation.
+	*/
+	int quiescence(GameState& gameState, int ply, int alpha, int beta);
+
+	/**
+	* Returns an evaluation of the given game state.
+	*
+	* Assumes that the game state should be evaluated from the perspective of the ''currentPlayer'' value in the game state.
+	*/
+	int evaluate(const GameState& gameState) const;
+
+	/** Same as above, but requires passing an additional winner argument. Optimization if winner has already been determined in calling code */
+	int evaluate(const GameState& gameState, EPlayerColors::Type winner) const;
+
+	/** Makes the given move followed by the principal variation of the child at (ply + 1) the principal variation at ply */
+	void updatePrincipalVariation(int ply, const Move& move);
+
+	/** Stores the given move as a killer move for the given depth */
+	void storeKillerMove(int depth, const Move& move);
+
+	/**
+	* Starts search, given the current game state.
+	* Returns the best Move to play
+	*/
+	Move startPrincipalVariationSearch(GameState& gameState);
+};
@@ -0,0 +1,185 @@
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "EngineComparison.h"
+#include "Logger.h"
+#include "PrincipalVariationSearch.h"
+#include "ProbCutCalibration.h"
+#include "SearchHandle.h"
+
+/** Seed of the random number generator used to diversify the positions, fixed so that runs are reproducible */
+#define CALIBRATION_SEED 20141031
+/** The maximum number of random moves played to diversify a position of the fixed position set */
+#define CALIBRATION_MAX_RANDOM_MOVES 6
+/** The minimum number of samples required to fit the coefficients */
+#define CALIBRATION_MIN_SAMPLES 10
+
+int ProbCutCalibration::collectSamples(int shallowDepth, int deepDepth, int numPositions, const std::string& fileName)
+{
+	std::vector<std::vector<Move>> positionSet = EngineComparison::generatePositionSet(numPositions);
+	if(positionSet.empty())
+	{
+		return 0;
+	}
+
+	std::ofstream output(fileName.c_str(), std::ios::binary | std::ios::app);
+	if(!output)
+	{
+		LOG_ERROR(StringBuilder() << "ProbCutCalibration::collectSamples(): could not open " << fileName << "!")
+		return 0;
+	}
+
+	std::mt19937 randomGenerator(CALIBRATION_SEED);
+	PrincipalVariationSearch engine;
+	engine.disableProbCut();		// the deep scores must not depend on the coefficients that are being fitted
+
+	SearchLimits limits;
+	limits.maxDepth = deepDepth;
+
+	int numSamples = 0;
+
+	for(int i = 0; i < numPositions; ++i)
+	{
+		GameState gameState;
+		EngineComparison::setUpPosition(gameState, positionSet[i % positionSet.size()]);
+
+		// diversify the position with a few random moves
+		int numRandomMoves = randomGenerator() % (CALIBRATION_MAX_RANDOM_MOVES + 1);
+		for(int j = 0; j < numRandomMoves && gameState.getWinner() == EPlayerColors::Type::NOTHING; ++j)
+		{
+			EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+			MoveGenerator moveGenerator(currentPlayer,
+										gameState.getBitboard(currentPlayer),
+										gameState.getBitboard(gameState.getOpponentColor(currentPlayer)));
+
+			std::vector<Move> moves;
+			for(Move m = moveGenerator.nextMove(); !(m == INVALID_MOVE); m = moveGenerator.nextMove())
+			{
+				moves.push_back(m);
+			}
+
+			gameState.applyMove(moves[randomGenerator() % moves.size()]);
+		}
+
+		if(gameState.getWinner() != EPlayerColors::Type::NOTHING)
+		{
+			continue;
+		}
+
+		// a single iterative deepening search provides the scores of both depths
+		ProbCutSample sample;
+		bool foundShallowScore = false;
+		bool foundDeepScore = false;
+
+		SearchHandle* search = engine.start(gameState, limits, [&](const SearchIterationInfo& info)
+		{
+			if(info.depth == shallowDepth)
+			{
+				sample.shallowScore = info.score;
+				foundShallowScore = true;
+			}
+			else if(info.depth == deepDepth)
+			{
+				sample.deepScore = info.score;
+				foundDeepScore = true;
+			}
+		});
+		search->wait();
+		delete search;
+
+		if(!foundShallowScore || !foundDeepScore ||
+			engine.isWinEvaluation(sample.shallowScore) || engine.isWinEvaluation(sample.deepScore))
+		{
+			continue;
+		}
+
+		output.write(reinterpret_cast<const char*>(&sample), sizeof(ProbCutSample));
+		++numSamples;
+	}
+
+	return numSamples;
+}
+
+bool ProbCutCalibration::fitCoefficients(const std::string& fileName, double& a, double& b, double& sigma)
+{
+	std::ifstream input(fileName.c_str(), std::ios::binary);
+	if(!input)
+	{
+		return false;
+	}
+
+	std::vector<ProbCutSample> samples;
+	ProbCutSample sample;
+
+	while(input.read(reinterpret_cast<char*>(&sample), sizeof(ProbCutSample)))
+	{
+		samples.push_back(sample);
+	}
+
+	if(samples.size() < CALIBRATION_MIN_SAMPLES)
+	{
+		return false;
+	}
+
+	double n = (double)samples.size();
+	double sumX = 0.0;
+	double sumY = 0.0;
+	double sumXX = 0.0;
+	double sumXY = 0.0;
+
+	for(const ProbCutSample& s : samples)
+	{
+		sumX += s.shallowScore;
+		sumY += s.deepScore;
+		sumXX += (double)s.shallowScore * s.shallowScore;
+		sumXY += (double)s.shallowScore * s.deepScore;
+	}
+
+	double varianceX = n * sumXX - sumX * sumX;
+
+	if(varianceX > 0.0)
+	{
+		a = (n * sumXY - sumX * sumY) / varianceX;
+		b = (sumY - a * sumX) / n;
+	}
+	else		// all shallow scores are equal, so the best we can do is predict the mean deep score
+	{
+		a = 1.0;
+		b = (sumY - sumX) / n;
+	}
+
+	double sumSquaredErrors = 0.0;
+	for(const ProbCutSample& s : samples)
+	{
+		double error = s.deepScore - (a * s.shallowScore + b);
+		sumSquaredErrors += error * error;
+	}
+
+	sigma = std::sqrt(sumSquaredErrors / n);
+	return true;
+}
+
+void ProbCutCalibration::calibrate(int shallowDepth, int deepDepth, int numPositions, const std::string& fileName)
+{
+	LOG_MESSAGE(StringBuilder() << "Calibrating ProbCut: shallow depth = " << shallowDepth << ", deep depth = " << deepDepth << ", positions = " << numPositions)
+
+	int numSamples = collectSamples(shallowDepth, deepDepth, numPositions, fileName);
+	LOG_MESSAGE(StringBuilder() << "Samples written to " << fileName << ":		" << numSamples)
+
+	double a;
+	double b;
+	double sigma;
+
+	if(fitCoefficients(fileName, a, b, sigma))
+	{
+		LOG_MESSAGE(StringBuilder() << "Fitted coefficients:		a = " << a << ", b = " << b << ", sigma = " << sigma)
+	}
+	else
+	{
+		LOG_MESSAGE(StringBuilder() << "Not enough samples in " << fileName << " to fit the coefficients")
+	}
+
+	LOG_MESSAGE("")
+}
\ No newline at end of file
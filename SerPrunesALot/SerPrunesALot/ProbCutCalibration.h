@@ -0,0 +1,46 @@
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+
+/** A single pair of scores found for the same position by a shallow and a deep search */
+struct ProbCutSample
+{
+	/** The score found by the shallow search */
+	int32_t shallowScore;
+	/** The score found by the deep search */
+	int32_t deepScore;
+};
+
+/**
+ * Headless tool to calibrate ProbCut.
+ *
+ * ProbCut assumes that the score of a deep search can be predicted from the score of a shallow search of the same position as
+ * deepScore = a * shallowScore + b + e, where e is normally distributed with standard deviation sigma. This tool collects
+ * (shallow, deep) score pairs from real searches of the Principal Variation Search engine, and fits a, b and sigma with linear
+ * least squares regression. ProbCut is disabled in the engine while collecting samples, so that the deep scores are not
+ * influenced by the coefficients that are being fitted.
+ *
+ * Samples are stored in a binary file as a plain sequence of ProbCutSample records, so that samples of multiple runs can be
+ * combined by appending files.
+ */
+namespace ProbCutCalibration
+{
+	/**
+	 * Searches the given number of positions to the given deep depth, and appends the scores of the iterations with the
+	 * shallow and the deep depth to the given file. Positions are taken from the fixed position set of EngineComparison,
+	 * and diversified by playing a few random moves from them (with a fixed seed, so that runs are reproducible).
+	 * Positions in which a win is found by either search are skipped, because their scores say nothing about the error.
+	 * Returns the number of samples written.
+	 */
+	int collectSamples(int shallowDepth, int deepDepth, int numPositions, const std::string& fileName);
+
+	/**
+	 * Fits the coefficients a, b and sigma to all samples in the given file.
+	 * Returns false if the file could not be read or contains too few samples.
+	 */
+	bool fitCoefficients(const std::string& fileName, double& a, double& b, double& sigma);
+
+	/** Collects samples into the given file, fits the coefficients to all samples in it, and logs the results */
+	void calibrate(int shallowDepth, int deepDepth, int numPositions, const std::string& fileName);
+}
\ No newline at end of file
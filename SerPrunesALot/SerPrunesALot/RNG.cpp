@@ -18,6 +18,11 @@ RNG::Generator_64::Generator_64()
 	gen.seed(seed);
 }
 
+RNG::Generator_64::Generator_64(uint64_t seed)
+	: gen(seed)
+{
+}
+
 uint32_t RNG::randomUint_32()
 {
 	static RNG::Generator_32 gen_32;
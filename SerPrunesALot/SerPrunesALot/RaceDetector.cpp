@@ -0,0 +1,174 @@
+#include "Bitboards.hpp"
+#include "MoveGenerator.h"
+#include "RaceDetector.h"
+
+namespace
+{
+	/** Tables that only depend on the square of a single knight, indexed by player color and square */
+	struct RaceTables
+	{
+		/** The minimum number of moves to reach the goal row */
+		int goalDistance[EPlayerColors::Type::NUM_PLAYER_COLORS][64];
+		/** The squares that could ever be reached, including the square itself */
+		uint64_t reachCone[EPlayerColors::Type::NUM_PLAYER_COLORS][64];
+		/** The squares from which an opponent knight could ever capture a knight somewhere in the reach cone (before it reaches the goal row) */
+		uint64_t interceptZone[EPlayerColors::Type::NUM_PLAYER_COLORS][64];
+	};
+
+	RaceTables precomputeRaceTables()
+	{
+		RaceTables tables;
+		const EPlayerColors::Type colors[2] = {EPlayerColors::Type::BLACK_PLAYER, EPlayerColors::Type::WHITE_PLAYER};
+
+		for(EPlayerColors::Type color : colors)
+		{
+			uint64_t goalRow = MoveGenerator::getGoalRow(color);
+
+			for(int square = 0; square < 64; ++square)
+			{
+				// flood fill forwards until the knights fall off the board, which takes at most 7 moves
+				uint64_t frontier = 1ULL << square;		// computed during static initialization, so no Bitboards::singleBit()
+				uint64_t cone = frontier;
+				int distance = (frontier & goalRow) ? 0 : -1;
+				int moves = 0;
+
+				while(frontier)
+				{
+					frontier = MoveGenerator::getKnightTargets(color, frontier);
+					cone |= frontier;
+					++moves;
+
+					if(distance < 0 && (frontier & goalRow))
+					{
+						distance = moves;
+					}
+				}
+
+				tables.goalDistance[color][square] = distance;
+				tables.reachCone[color][square] = cone;
+			}
+		}
+
+		for(EPlayerColors::Type color : colors)
+		{
+			EPlayerColors::Type opponent = (color == EPlayerColors::Type::BLACK_PLAYER) ? EPlayerColors::Type::WHITE_PLAYER : EPlayerColors::Type::BLACK_PLAYER;
+			uint64_t goalRow = MoveGenerator::getGoalRow(color);
+
+			for(int square = 0; square < 64; ++square)
+			{
+				uint64_t path = tables.reachCone[color][square] & ~goalRow;		// a knight on the goal row has already won
+				uint64_t zone = Bitboards::ALL_ZERO;
+
+				for(int interceptor = 0; interceptor < 64; ++interceptor)
+				{
+					if(MoveGenerator::getKnightTargets(opponent, tables.reachCone[opponent][interceptor]) & path)
+					{
+						zone |= 1ULL << interceptor;
+					}
+				}
+
+				tables.interceptZone[color][square] = zone;
+			}
+		}
+
+		return tables;
+	}
+
+	const RaceTables raceTables = precomputeRaceTables();
+
+	/** Returns the square of the given player's knight that is closest to its goal row. There must be at least one knight */
+	int getMostAdvancedKnight(EPlayerColors::Type playerColor, uint64_t knights)
+	{
+		// black moves towards higher bit indices, white towards lower bit indices
+		return (playerColor == EPlayerColors::Type::BLACK_PLAYER) ? Bitboards::bitScanReverse(knights) : Bitboards::bitScanForward(knights);
+	}
+
+	/**
+	 * Returns the number of plies (counted from the player to move) after which one of the runner's knights reaches the goal
+	 * row without any chance for the defender to capture it or to reach its own goal row first, or 0 if that is not proven.
+	 */
+	int findUnstoppableRunner(const GameState& gameState, EPlayerColors::Type runnerColor, EPlayerColors::Type defenderColor, bool runnerToMove)
+	{
+		uint64_t runners = gameState.getBitboard(runnerColor);
+		uint64_t defenders = gameState.getBitboard(defenderColor);
+
+		if(!runners || !defenders)
+		{
+			return 0;
+		}
+
+		// the defender wins with its move number defenderDistance at the earliest, so the runner has to be there before that
+		int defenderDistance = raceTables.goalDistance[defenderColor][getMostAdvancedKnight(defenderColor, defenders)];
+		int maxMoves = (runnerToMove) ? defenderDistance : defenderDistance - 1;
+
+		if(raceTables.goalDistance[runnerColor][getMostAdvancedKnight(runnerColor, runners)] > maxMoves)
+		{
+			return 0;
+		}
+
+		// only knights that are close enough to the goal row can be runners, and only some defenders can ever intercept them
+		uint64_t candidates = Bitboards::ALL_ZERO;
+		uint64_t interceptZone = Bitboards::ALL_ZERO;
+		uint64_t knights = runners;
+
+		while(knights)
+		{
+			int square = Bitboards::bitScanForward(knights);
+			knights &= knights - 1;
+
+			if(raceTables.goalDistance[runnerColor][square] <= maxMoves)
+			{
+				candidates |= Bitboards::singleBit(square);
+				interceptZone |= raceTables.interceptZone[runnerColor][square];
+			}
+		}
+
+		// squares that the interceptors can have reached by now, assuming all of them move every turn
+		uint64_t interceptorReach = defenders & interceptZone;
+		// squares where a runner can be now without having been captured yet
+		uint64_t safeSquares = candidates;
+
+		if(!runnerToMove)		// the defender moves first, so the runners must not be attacked right now
+		{
+			uint64_t attacked = MoveGenerator::getKnightTargets(defenderColor, interceptorReach);
+			safeSquares &= ~attacked;
+			interceptorReach |= attacked;
+		}
+
+		uint64_t goalRow = MoveGenerator::getGoalRow(runnerColor);
+
+		for(int moves = 1; moves <= maxMoves && safeSquares; ++moves)
+		{
+			// our other knights are assumed to stay put, so they block the runners
+			uint64_t targets = MoveGenerator::getKnightTargets(runnerColor, safeSquares) & ~runners;
+
+			if(targets & goalRow)
+			{
+				return (runnerToMove) ? 2 * moves - 1 : 2 * moves;
+			}
+
+			// the defender gets one move to capture the runner before the runner moves on
+			uint64_t attacked = MoveGenerator::getKnightTargets(defenderColor, interceptorReach);
+			safeSquares = targets & ~attacked;
+			interceptorReach |= attacked;
+		}
+
+		return 0;
+	}
+}
+
+int RaceDetector::detectRace(const GameState& gameState)
+{
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	EPlayerColors::Type opponent = gameState.getOpponentColor(currentPlayer);
+
+	// at most one of these can be proven, because each of them requires the runner to be faster than the other side
+	int plies = findUnstoppableRunner(gameState, currentPlayer, opponent, true);
+
+	if(plies != 0)
+	{
+		return plies;
+	}
+
+	return -findUnstoppableRunner(gameState, opponent, currentPlayer, false);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "GameState.h"
+
+/**
+ * Static analysis of races to the goal row.
+ *
+ * Knights only ever move forwards, so a knight needs at least a fixed number of moves to reach the goal row from any square,
+ * and an opponent knight that has passed it can never come back to capture it. If one of our knights can walk to the goal
+ * row along a path where no opponent knight can possibly arrive in time to capture it, and the opponent cannot reach our goal
+ * row faster, the game is decided without any search. This generalizes the danger zone check (a knight that can move to the
+ * goal row right away) to runners that are several moves away from the goal row.
+ *
+ * The analysis is conservative: opponent knights are assumed to all move at the same time, ignoring that they block each
+ * other, and our other knights are assumed to stay where they are. It never claims a result that does not hold, but the true
+ * distance to a proven win may be shorter (and to a proven loss longer) than the distance it returns.
+ */
+namespace RaceDetector
+{
+	/**
+	 * Returns the number of plies after which the player to move in the given game state wins (if positive) or loses
+	 * (if negative) the race to the goal row, or 0 if neither is proven. The game must not be over yet.
+	 *
+	 * A win in n plies means that the player to move moves a knight to the goal row with the n'th ply from now (so n = 1
+	 * for a knight in the danger zone); a loss in n plies means that the opponent does.
+	 */
+	int detectRace(const GameState& gameState);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "SearchControl.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+SearchControl::SearchControl()
+	: stopped(false),
+	stopRequested(false),
+	nodesVisited(0),
+	maxNodes(0),
+	startTime(0),
+	softDeadline(0),
+	hardDeadline(0)
+{}
+
+void SearchControl::startSearch(int softTimeMs, int hardTimeMs, int64_t maxNodes)
+{
+	this->maxNodes = maxNodes;
+	nodesVisited = 0;
+
+	startTime = now();
+	softDeadline = (softTimeMs > 0) ? startTime + softTimeMs * 1000LL : 0;
+	hardDeadline = (hardTimeMs > 0) ? startTime + hardTimeMs * 1000LL : 0;
+
+	stopped.store(stopRequested.load());
+}
+
+void SearchControl::reset()
+{
+	stopRequested.store(false);
+	stopped.store(false);
+}
+
+void SearchControl::stop()
+{
+	stopRequested.store(true);
+	stopped.store(true);
+}
+
+double SearchControl::getElapsedMs() const
+{
+	return (now() - startTime) * 0.001;
+}
+
+int64_t SearchControl::getNodesVisited() const
+{
+	return nodesVisited;
+}
+
+bool SearchControl::isSoftDeadlineReached() const
+{
+	if(isStopped())
+	{
+		return true;
+	}
+
+	return (softDeadline != 0 && now() >= softDeadline);
+}
+
+void SearchControl::poll()
+{
+	if(maxNodes > 0 && nodesVisited >= maxNodes)
+	{
+		stopped.store(true);
+	}
+	else if(hardDeadline != 0 && now() >= hardDeadline)
+	{
+		stopped.store(true);
+	}
+}
+
+int64_t SearchControl::now()
+{
+#ifdef _WIN32
+	// tick count only has a resolution of 10 - 16 ms, but is much cheaper than QueryPerformanceCounter
+	return (int64_t)GetTickCount64() * 1000LL;
+#else
+#ifdef CLOCK_MONOTONIC_COARSE
+	clockid_t clockId = CLOCK_MONOTONIC_COARSE;
+#else
+	clockid_t clockId = CLOCK_MONOTONIC;
+#endif // CLOCK_MONOTONIC_COARSE
+
+	timespec time;
+	clock_gettime(clockId, &time);
+	return (int64_t)time.tv_sec * 1000000LL + time.tv_nsec / 1000;
+#endif // _WIN32
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <inttypes.h>
+
+/**
+ * The number of nodes between two consecutive checks of the clock and node limits.
+ * Must be a power of 2.
+ */
+#define SEARCH_CONTROL_POLL_INTERVAL 4096
+
+/**
+ * Controls when a search should be terminated.
+ *
+ * Engines should call visitNode() once for every node they visit. Only once every SEARCH_CONTROL_POLL_INTERVAL nodes
+ * will the (monotonic, coarse) clock actually be read and compared to the hard deadline, and the number of nodes
+ * compared to the node limit. As soon as a limit is exceeded, or stop() is called by any thread, a single atomic
+ * flag is set, which engines should use to unwind their search (without storing any results of terminated subtrees).
+ *
+ * The soft deadline is never checked automatically. Engines should check isSoftDeadlineReached() between iterations
+ * to decide whether or not to start a new iteration.
+ */
+class SearchControl
+{
+public:
+	SearchControl();
+
+	/**
+	 * Starts controlling a new search. Sets the deadlines relative to the current time, and resets the node counter.
+	 * Clears the stop flag if it was set because of limits of a previous search, but NOT if it was set by a call to stop(),
+	 * so that stop requests made right before the search started are not lost.
+	 *
+	 * softTimeMs = Time in milliseconds after which no new iterations should be started. 0 = no soft deadline
+	 * hardTimeMs = Time in milliseconds after which the search is stopped immediately. 0 = no hard deadline
+	 * maxNodes = Number of nodes after which the search is stopped immediately. 0 = no node limit
+	 */
+	void startSearch(int softTimeMs, int hardTimeMs, int64_t maxNodes);
+
+	/** Resets the stop flag (including stop requests made through stop()), so that a new search can be started */
+	void reset();
+
+	/** Requests the search to stop as soon as possible. Can safely be called from any thread */
+	void stop();
+
+	/**
+	 * Should be called once for every node visited by the search.
+	 * Returns true iff the search must be terminated.
+	 */
+	inline bool visitNode()
+	{
+		++nodesVisited;
+
+		if((nodesVisited & (SEARCH_CONTROL_POLL_INTERVAL - 1)) == 0)
+		{
+			poll();
+		}
+
+		return isStopped();
+	}
+
+	/** Returns true iff the search must be terminated. Does not read the clock */
+	inline bool isStopped() const
+	{
+		return stopped.load(std::memory_order_relaxed);
+	}
+
+	/** Returns the number of milliseconds elapsed since the search was started. Reads the clock */
+	double getElapsedMs() const;
+
+	/** Returns the number of nodes visited since the search was started */
+	int64_t getNodesVisited() const;
+
+	/** Returns true iff the soft deadline was reached (or the search was stopped already). Reads the clock */
+	bool isSoftDeadlineReached() const;
+
+private:
+	/** Flag that is set as soon as the search must be terminated */
+	std::atomic<bool> stopped;
+	/** Flag that is set only by stop(), and is therefore not cleared by startSearch() */
+	std::atomic<bool> stopRequested;
+
+	/** The number of nodes visited since the search was started */
+	int64_t nodesVisited;
+	/** The number of nodes after which the search is stopped. 0 = no limit */
+	int64_t maxNodes;
+
+	/** Time at which the search was started, in microseconds */
+	int64_t startTime;
+	/** Time after which no new iterations should be started, in microseconds. 0 = no deadline */
+	int64_t softDeadline;
+	/** Time after which the search is stopped immediately, in microseconds. 0 = no deadline */
+	int64_t hardDeadline;
+
+	/** Checks the clock and node limits, and sets the stop flag if any of them is exceeded */
+	void poll();
+
+	/** Returns the current time of a cheap monotonic clock, in microseconds */
+	static int64_t now();
+
+	// don't want accidental copying of the Search Control
+	SearchControl(const SearchControl&);
+	SearchControl& operator=(const SearchControl&);
+};
@@ -0,0 +1,163 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Bitboards.hpp"
+#include "MoveGenerator.h"
+#include "SearchCore.h"
+
+bool SearchCore::isNullMoveAllowed(const GameState& gameState, int depth)
+{
+	if(depth < NULL_MOVE_MIN_DEPTH)
+	{
+		return false;
+	}
+
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	EPlayerColors::Type opponent = gameState.getOpponentColor(currentPlayer);
+
+	int numKnights = (currentPlayer == EPlayerColors::Type::BLACK_PLAYER) ? gameState.getNumBlackKnights() : gameState.getNumWhiteKnights();
+	if(numKnights <= NULL_MOVE_MIN_KNIGHTS)		// zugzwang is likely
+	{
+		return false;
+	}
+
+	if(gameState.getBitboard(opponent) & MoveGenerator::getDangerZone(opponent))			// passing would lose immediately
+	{
+		return false;
+	}
+
+	if(gameState.getBitboard(currentPlayer) & MoveGenerator::getDangerZone(currentPlayer))	// we win immediately anyway
+	{
+		return false;
+	}
+
+	return true;
+}
+
+int SearchCore::getNullMoveReduction(int depth, int staticEvaluation, int beta)
+{
+	int reduction = NULL_MOVE_BASE_REDUCTION + depth / 6;
+
+	if(staticEvaluation - beta >= 100)		// at least a knight ahead of beta, so even less likely that the null move fails low
+	{
+		++reduction;
+	}
+
+	return reduction;
+}
+
+bool SearchCore::isSingleReply(const GameState& gameState)
+{
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	EPlayerColors::Type opponent = gameState.getOpponentColor(currentPlayer);
+
+	if(gameState.getBitboard(currentPlayer) & MoveGenerator::getDangerZone(currentPlayer))	// we win immediately instead
+	{
+		return false;
+	}
+
+	uint64_t threats = gameState.getBitboard(opponent) & MoveGenerator::getDangerZone(opponent);
+	if(!Bitboards::isSingleBit(threats))		// no threat, or more threats than we can ever stop with a single move
+	{
+		return false;
+	}
+
+	// knight moves are reversible in shape, so the opponent's targets from the threat square are our knights' origins
+	uint64_t attackers = MoveGenerator::getKnightTargets(opponent, threats) & gameState.getBitboard(currentPlayer);
+	return Bitboards::isSingleBit(attackers);
+}
+
+int SearchCore::getMoveExtension(const GameState& gameState, const Move& move)
+{
+	EPlayerColors::Type currentPlayer = gameState.getCurrentPlayer();
+	uint64_t to = Bitboards::singleBit(move.to);
+	int extension = 0;
+
+	if(to & MoveGenerator::getDangerZone(currentPlayer))
+	{
+		extension += DANGER_ZONE_EXTENSION;
+	}
+
+	if(move.captured && (to & MoveGenerator::getDangerZone(gameState.getOpponentColor(currentPlayer))))
+	{
+		extension += ATTACKER_CAPTURE_EXTENSION;
+	}
+
+	return extension;
+}
+
+int SearchCore::extend(int pathExtension, int extension, int& childPathExtension)
+{
+	childPathExtension = std::min(pathExtension + extension, MAX_PATH_EXTENSION);
+	return (childPathExtension / ONE_PLY) - (pathExtension / ONE_PLY);
+}
+
+int SearchCore::getWinScore(int ply, int winEvaluation)
+{
+	return winEvaluation - ply;
+}
+
+bool SearchCore::isWinScore(int score, int winEvaluation)
+{
+	return (std::abs(score) > winEvaluation - MAX_WIN_DISTANCE);
+}
+
+int SearchCore::getWinDistance(int score, int winEvaluation)
+{
+	return winEvaluation - std::abs(score);
+}
+
+int SearchCore::scoreEvaluation(int evaluation, int ply, int winEvaluation)
+{
+	if(evaluation >= winEvaluation)				// we win with our next move
+	{
+		return getWinScore(ply + 1, winEvaluation);
+	}
+	else if(evaluation <= -winEvaluation)		// we lost
+	{
+		return -getWinScore(ply, winEvaluation);
+	}
+	else if(isWinScore(evaluation, winEvaluation))		// win or loss further away, see getDistanceEvaluation()
+	{
+		return (evaluation > 0) ? getWinScore(ply + 1 + getWinDistance(evaluation, winEvaluation), winEvaluation)
+								: -getWinScore(ply + getWinDistance(evaluation, winEvaluation), winEvaluation);
+	}
+
+	return evaluation;
+}
+
+int SearchCore::getDistanceEvaluation(int plies, int winEvaluation)
+{
+	// a win at the next ply is the plain win evaluation, and a loss at this ply its negation
+	return (plies > 0) ? winEvaluation - (plies - 1) : -(winEvaluation + plies);
+}
+
+int SearchCore::scoreToTable(int score, int ply, int winEvaluation)
+{
+	if(!isWinScore(score, winEvaluation))
+	{
+		return score;
+	}
+
+	return (score > 0) ? score + ply : score - ply;
+}
+
+int SearchCore::scoreFromTable(int value, int ply, int winEvaluation)
+{
+	if(!isWinScore(value, winEvaluation))
+	{
+		return value;
+	}
+
+	return (value > 0) ? value - ply : value + ply;
+}
+
+bool SearchCore::mateDistancePruning(int ply, int winEvaluation, int& alpha, int& beta)
+{
+	alpha = std::max(alpha, -getWinScore(ply, winEvaluation));
+	beta = std::min(beta, getWinScore(ply + 1, winEvaluation));
+
+	return (alpha >= beta);
+}
\ No newline at end of file
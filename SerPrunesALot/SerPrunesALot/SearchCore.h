@@ -0,0 +1,163 @@
+#pragma once
+
+#include "GameState.h"
+#include "Move.h"
+#include "SearchControl.h"
+
+/** Null-move pruning is only tried at nodes with at least this remaining depth */
+#define NULL_MOVE_MIN_DEPTH 2
+/** Null-move pruning is only tried if the player to move has more than this number of knights, because zugzwang becomes likely with fewer knights */
+#define NULL_MOVE_MIN_KNIGHTS 3
+/** The minimum depth reduction of the search after a null move */
+#define NULL_MOVE_BASE_REDUCTION 2
+/** Successful null moves at nodes with at least this remaining depth are verified with a reduced search without null moves */
+#define NULL_MOVE_VERIFICATION_MIN_DEPTH 3
+
+/** The number of fractional units in a ply. Extensions are expressed in these units, so that they can be smaller than a ply */
+#define ONE_PLY 4
+/** The extension of a move that enters the danger zone, from where the knight threatens to win on its next move */
+#define DANGER_ZONE_EXTENSION 2
+/** The extension of a move that captures an opponent knight in its danger zone */
+#define ATTACKER_CAPTURE_EXTENSION 2
+/** The extension of the moves in a position where only a single reply prevents an immediate loss */
+#define SINGLE_REPLY_EXTENSION 4
+/** The extension of a singular move, which is much better than all alternatives */
+#define SINGULAR_EXTENSION 4
+/** The maximum sum of all extensions along a single path from the root, such that threat sequences cannot extend forever */
+#define MAX_PATH_EXTENSION ONE_PLY
+
+/**
+ * Wins are scored as the engine's win evaluation minus their distance in plies from the root (and losses as the negation
+ * of that), so that faster wins and slower losses are preferred. Scores within this distance of the win evaluation are wins
+ */
+#define MAX_WIN_DISTANCE 128
+
+/**
+ * Building blocks of alpha-beta search that are shared by multiple engines, so that they do not need to be copy-pasted
+ * into each engine. The engines plug in their own search functions.
+ */
+namespace SearchCore
+{
+	/**
+	 * Returns true iff null-move pruning may be tried in the given game state at the given remaining depth.
+	 *
+	 * Passing is not legal in Knightthrough, so positions where every move makes things worse (zugzwang) do exist, and the
+	 * null-move observation does not hold there. They are likely in endgames, so null moves are not tried if the player
+	 * to move has very few knights left. Null moves are also not tried if either player can win on its next move, because
+	 * passing would then lose (or win) immediately.
+	 */
+	bool isNullMoveAllowed(const GameState& gameState, int depth);
+
+	/**
+	 * Returns the adaptive depth reduction of the search after a null move. Deeper nodes, and nodes where the static
+	 * evaluation exceeds beta by a large margin, are reduced more.
+	 */
+	int getNullMoveReduction(int depth, int staticEvaluation, int beta);
+
+	/**
+	 * Tries null-move pruning: lets the player to move pass, and tests whether a reduced search still fails high.
+	 * Returns true iff the node can be cut off, in which case ''result'' is set to a (fail-soft) lower bound on the value of
+	 * the node, which the engine should return after making sure it is not a win (a win found after passing is not proven).
+	 * Should only be called if isNullMoveAllowed() returns true and the static evaluation is at least beta.
+	 *
+	 * search(depth, ply, alpha, beta, nullMoveAllowed) must run the engine's own search of the current game state, and
+	 * return its evaluation from the perspective of the player to move. It is called once for the position after the null
+	 * move (at ply + 1, with null moves disallowed, so that two null moves are never made in a row), and, if the null move
+	 * fails high at a deep node, once more for the position itself (at ply, with null moves disallowed) as a verification
+	 * search, which guards against zugzwang positions that isNullMoveAllowed() does not recognize.
+	 */
+	template<typename SearchFunction>
+	bool tryNullMove(GameState& gameState, int depth, int ply, int beta, int staticEvaluation,
+					 const SearchControl& searchControl, SearchFunction search, int& result);
+
+	/**
+	 * Returns true iff the opponent of the player to move threatens to win on its next move, and exactly one move of the
+	 * player to move prevents that (the only capture of the only threatening knight).
+	 */
+	bool isSingleReply(const GameState& gameState);
+
+	/**
+	 * Returns the extension (in fractional units, see ONE_PLY) that the given move of the player to move has earned because
+	 * it creates or removes a threat to win. Should be called before the move is applied.
+	 */
+	int getMoveExtension(const GameState& gameState, const Move& move);
+
+	/**
+	 * Adds the given extension (in fractional units) to the extensions that were already made along the path to a node,
+	 * which is updated to the sum for the child, without exceeding MAX_PATH_EXTENSION. Returns the number of whole plies
+	 * by which the child has to be extended, which is the number of ply boundaries that the sum crossed.
+	 */
+	int extend(int pathExtension, int extension, int& childPathExtension);
+
+	/** Returns the score of a win at the given distance in plies from the root, for an engine with the given win evaluation */
+	int getWinScore(int ply, int winEvaluation);
+
+	/** Returns true iff the given score proves a win (if positive) or a loss (if negative) */
+	bool isWinScore(int score, int winEvaluation);
+
+	/** Returns the distance in plies from the root to the win or loss proven by the given score */
+	int getWinDistance(int score, int winEvaluation);
+
+	/**
+	 * Converts the result of an engine's evaluation function at the given ply to a score relative to the root. Evaluation
+	 * functions return the win evaluation if the player to move can win with its next move (so at the next ply), and its
+	 * negation if the player to move has lost (at this ply). Wins and losses that are further away are returned as
+	 * computed by getDistanceEvaluation().
+	 */
+	int scoreEvaluation(int evaluation, int ply, int winEvaluation);
+
+	/**
+	 * Returns the evaluation of a game state in which the player to move wins (if plies > 0) or loses (if plies < 0) after
+	 * the given number of plies, such that scoreEvaluation() converts it into the matching score relative to the root
+	 */
+	int getDistanceEvaluation(int plies, int winEvaluation);
+
+	/**
+	 * Converts a score relative to the root into a score relative to the node at the given ply, such that it can be stored
+	 * in a table and retrieved again for the same position at any other ply
+	 */
+	int scoreToTable(int score, int ply, int winEvaluation);
+
+	/** Converts a score stored in a table by scoreToTable() back into a score relative to the root, for a node at the given ply */
+	int scoreFromTable(int value, int ply, int winEvaluation);
+
+	/**
+	 * Mate-distance pruning: narrows the window of a node at the given ply to scores that can still be reached from it. No win
+	 * can be faster than the next ply, so beta is lowered to that if there is already a faster win elsewhere; similarly alpha
+	 * is raised to a loss at this ply. Returns true iff the window is empty, in which case the node can return alpha.
+	 */
+	bool mateDistancePruning(int ply, int winEvaluation, int& alpha, int& beta);
+}
+
+template<typename SearchFunction>
+bool SearchCore::tryNullMove(GameState& gameState, int depth, int ply, int beta, int staticEvaluation,
+							 const SearchControl& searchControl, SearchFunction search, int& result)
+{
+	int reducedDepth = depth - 1 - getNullMoveReduction(depth, staticEvaluation, beta);
+	if(reducedDepth < 0)
+	{
+		reducedDepth = 0;
+	}
+
+	gameState.switchCurrentPlayer();		// pass, which also updates the zobrist hash value
+	int value = -search(reducedDepth, ply + 1, -beta, -beta + 1, false);
+	gameState.switchCurrentPlayer();
+
+	if(searchControl.isStopped() || value < beta)		// the opponent made use of the free move
+	{
+		return false;
+	}
+
+	if(depth >= NULL_MOVE_VERIFICATION_MIN_DEPTH)		// verify that we are not in zugzwang with a real (reduced) search
+	{
+		int verificationValue = search(reducedDepth + 1, ply, beta - 1, beta, false);
+
+		if(searchControl.isStopped() || verificationValue < beta)
+		{
+			return false;
+		}
+	}
+
+	result = value;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <chrono>
+
+#include "SearchHandle.h"
+
+SearchHandle::SearchHandle(AiEngine* engine, const GameState& position, const SearchLimits& limits, IterationCallback onIteration)
+	: engine(engine),
+	gameState(),
+	limits(limits),
+	onIteration(onIteration),
+	chosenMove(INVALID_MOVE),
+	finished(false),
+	finishedMutex(),
+	finishedCondition(),
+	worker()
+{
+	gameState.copyFrom(position);
+
+	// only start the thread once all other members have been initialized
+	worker = std::thread(&SearchHandle::run, this);
+}
+
+SearchHandle::~SearchHandle()
+{
+	stop();
+
+	if(worker.joinable())
+	{
+		worker.join();
+	}
+}
+
+bool SearchHandle::isFinished() const
+{
+	return finished.load();
+}
+
+void SearchHandle::stop()
+{
+	if(!isFinished())
+	{
+		engine->stop();
+	}
+}
+
+Move SearchHandle::wait()
+{
+	std::unique_lock<std::mutex> lock(finishedMutex);
+	finishedCondition.wait(lock, [this]{ return finished.load(); });
+
+	return chosenMove;
+}
+
+bool SearchHandle::waitFor(int milliseconds)
+{
+	std::unique_lock<std::mutex> lock(finishedMutex);
+	return finishedCondition.wait_for(lock, std::chrono::milliseconds(milliseconds), [this]{ return finished.load(); });
+}
+
+void SearchHandle::run()
+{
+	Move move = engine->runSearch(gameState, limits, onIteration);
+
+	{
+		std::lock_guard<std::mutex> lock(finishedMutex);
+		chosenMove = move;
+		finished.store(true);
+	}
+
+	finishedCondition.notify_all();
+}
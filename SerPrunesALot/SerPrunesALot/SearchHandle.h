@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "AiEngine.h"
+#include "GameState.h"
+#include "Move.h"
+#include "SearchLimits.h"
+
+/**
+ * Handle to a search running asynchronously on a worker thread. Created by AiEngine::start().
+ *
+ * The handle owns its own copy of the game state that is being searched, and owns the worker thread.
+ * Deleting the handle stops the search (if it's still running) and waits for the worker thread to finish.
+ */
+class SearchHandle
+{
+public:
+	SearchHandle(AiEngine* engine, const GameState& position, const SearchLimits& limits, IterationCallback onIteration);
+	~SearchHandle();
+
+	/** Returns true iff the search has finished, meaning that wait() will return immediately */
+	bool isFinished() const;
+
+	/**
+	 * Requests the search to stop as soon as possible. Does not block; use wait() afterwards
+	 * to obtain the best move found so far.
+	 */
+	void stop();
+
+	/** Blocks until the search has finished, and returns the chosen move */
+	Move wait();
+
+	/**
+	 * Blocks until the search has finished, or until the given number of milliseconds has passed, whichever comes first.
+	 * Returns true iff the search has finished.
+	 *
+	 * Can be used by external controllers to enforce exact deadlines, by calling stop() if this returns false.
+	 */
+	bool waitFor(int milliseconds);
+
+private:
+	/** The engine running the search */
+	AiEngine* engine;
+	/** The handle's own copy of the game state being searched */
+	GameState gameState;
+	/** The limits imposed on the search */
+	SearchLimits limits;
+	/** Callback to report completed iterations to */
+	IterationCallback onIteration;
+
+	/** The move chosen by the engine. Only valid once finished is true */
+	Move chosenMove;
+	/** Set to true by the worker thread once the search has finished */
+	std::atomic<bool> finished;
+
+	/** Used to wake up threads waiting for the search to finish */
+	std::mutex finishedMutex;
+	std::condition_variable finishedCondition;
+
+	/** The thread running the search */
+	std::thread worker;
+
+	/** Function executed by the worker thread */
+	void run();
+
+	// don't want accidental copying of handles
+	SearchHandle(const SearchHandle&);
+	SearchHandle& operator=(const SearchHandle&);
+};
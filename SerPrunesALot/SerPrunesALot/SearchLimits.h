@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <inttypes.h>
+#include <vector>
+
+#include "Move.h"
+
+/**
+ * Limits imposed on a single search by whoever started it (the GUI or a headless driver).
+ *
+ * A value of 0 means that no limit is imposed by the caller, and that the engine should
+ * fall back to its own default behaviour for that limit.
+ */
+struct SearchLimits
+{
+	SearchLimits() : maxTimeMs(0), maxDepth(0), maxNodes(0), timeRemainingMs(0), incrementMs(0)
+	{}
+
+	/** The maximum amount of time in milliseconds that the engine is allowed to search */
+	int maxTimeMs;
+	/** The maximum depth that the engine is allowed to search to */
+	int maxDepth;
+	/** The maximum number of nodes that the engine is allowed to visit */
+	int64_t maxNodes;
+
+	/**
+	 * The time in milliseconds left on the game clock of the player to move. Engines with time management
+	 * use this to spread their time over the remainder of the game
+	 */
+	int timeRemainingMs;
+	/** The time in milliseconds added to the game clock of the player to move after every move */
+	int incrementMs;
+};
+
+/**
+ * Information about a single completed iteration of a search, passed to progress callbacks.
+ */
+struct SearchIterationInfo
+{
+	SearchIterationInfo() : depth(0), score(0), bestMove(INVALID_MOVE), principalVariation(), nodes(0), elapsedMs(0.0), nodesPerSecond(0.0)
+	{}
+
+	/** The depth that was completely searched */
+	int depth;
+	/** The evaluation of the root node, from the perspective of the player to move */
+	int score;
+	/** The best move found by this iteration */
+	Move bestMove;
+	/** The principal variation found by this iteration, starting with bestMove. Empty if the engine does not keep track of it */
+	std::vector<Move> principalVariation;
+	/** The number of nodes visited so far during this search */
+	int64_t nodes;
+	/** The number of milliseconds spent so far during this search */
+	double elapsedMs;
+	/** The average number of nodes visited per second so far during this search */
+	double nodesPerSecond;
+};
+
+/**
+ * Type of the callback that is called every time an engine completes an iteration.
+ *
+ * NOTE: the callback is called from the thread that is running the search, NOT from the thread
+ * that started the search!
+ */
+typedef std::function<void(const SearchIterationInfo&)> IterationCallback;
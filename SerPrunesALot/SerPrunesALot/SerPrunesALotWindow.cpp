@@ -1,3 +1,5 @@
+#define NOMINMAX
+
 #include "SerPrunesALotWindow.h"
 #include "QActionGroup.h"
 #include "QDesktopWidget.h"
@@ -5,7 +7,9 @@
 #include "QIcon.h"
 #include "QLabel.h"
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
 
 #include "Options.h"
 
@@ -13,11 +17,19 @@
 #include "AspirationSearch.h"
 #include "BasicAlphaBeta.h"
 #include "BoardUtils.hpp"
+#include "DfpnSolver.h"
 #include "IterativeDeepening.h"
 #include "Logger.h"
+#include "MonteCarloTreeSearch.h"
 #include "Move.h"
+#include "MTDf.h"
+#include "PrincipalVariationSearch.h"
+#include "SearchHandle.h"
 #include "TranspositionTable.h"
 
+/** The interval in milliseconds at which the GUI checks on the progress of an AI search running in the background */
+#define AI_SEARCH_POLL_INTERVAL_MS 50
+
 SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	: QMainWindow(parent),
 	boardButtons(),
@@ -26,7 +38,15 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	selectedButton(nullptr),
 	ui(),
 	aiEngineBlack(nullptr),
-	aiEngineWhite(nullptr)
+	aiEngineWhite(nullptr),
+	activeSearch(nullptr),
+	activeSearchEngine(nullptr),
+	aiSearchPollTimer(nullptr),
+	lastIterationInfo(),
+	iterationInfoChanged(false),
+	blackAiTimeRemainingMs(GAME_TIME_BUDGET_MS),
+	whiteAiTimeRemainingMs(GAME_TIME_BUDGET_MS),
+	aiMoveClock()
 {
 	// NOTE: hardcoding this means only board sizes up to 8x8 are supported
 	char* COORDS_NUMBERS[] = { "1", "2", "3", "4", "5", "6", "7", "8" };
@@ -140,6 +160,10 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	QAction* runAiButton = new QAction("Run AI this turn!", menuBar());
 	connect(runAiButton, &QAction::triggered, this, &SerPrunesALotWindow::playTurnAi);
 
+	// Create and add the button to stop the AI early
+	QAction* stopAiButton = new QAction("Stop AI", menuBar());
+	connect(stopAiButton, &QAction::triggered, this, &SerPrunesALotWindow::stopAi);
+
 	// Create and add button to undo the last move
 	QAction* undoLastMoveButton = new QAction("Undo Last Move", menuBar());
 	connect(undoLastMoveButton, &QAction::triggered, this, &SerPrunesALotWindow::undoLastMove);
@@ -157,44 +181,76 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	blackPlayerAlphaBetaTT = new QAction("Alpha-Beta with Transposition Table", blackEngines);
 	blackPlayerIterativeDeepening = new QAction("Iterative Deepening", blackEngines);
 	blackPlayerAspirationSearch = new QAction("Aspiration Search", blackEngines);
+	blackPlayerPrincipalVariationSearch = new QAction("Principal Variation Search", blackEngines);
+	blackPlayerMTDf = new QAction("MTD(f)", blackEngines);
+	blackPlayerDfpnSolver = new QAction("DFPN Solver", blackEngines);
+	blackPlayerMonteCarloTreeSearch = new QAction("Monte Carlo Tree Search", blackEngines);
 
 	whitePlayerBasicAlphaBeta = new QAction("Basic Alpha-Beta", whiteEngines);
 	whitePlayerAlphaBetaTT = new QAction("Alpha-Beta with Transposition Table", whiteEngines);
 	whitePlayerIterativeDeepening = new QAction("Iterative Deepening", whiteEngines);
 	whitePlayerAspirationSearch = new QAction("Aspiration Search", whiteEngines);
+	whitePlayerPrincipalVariationSearch = new QAction("Principal Variation Search", whiteEngines);
+	whitePlayerMTDf = new QAction("MTD(f)", whiteEngines);
+	whitePlayerDfpnSolver = new QAction("DFPN Solver", whiteEngines);
+	whitePlayerMonteCarloTreeSearch = new QAction("Monte Carlo Tree Search", whiteEngines);
 
 	// Connect buttons to functions
 	connect(blackPlayerBasicAlphaBeta, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
 	connect(blackPlayerAlphaBetaTT, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
 	connect(blackPlayerIterativeDeepening, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
 	connect(blackPlayerAspirationSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
+	connect(blackPlayerPrincipalVariationSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
+	connect(blackPlayerMTDf, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
+	connect(blackPlayerDfpnSolver, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
+	connect(blackPlayerMonteCarloTreeSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetBlackAiEngine);
 
 	connect(whitePlayerBasicAlphaBeta, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
 	connect(whitePlayerAlphaBetaTT, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
 	connect(whitePlayerIterativeDeepening, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
 	connect(whitePlayerAspirationSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
+	connect(whitePlayerPrincipalVariationSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
+	connect(whitePlayerMTDf, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
+	connect(whitePlayerDfpnSolver, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
+	connect(whitePlayerMonteCarloTreeSearch, &QAction::triggered, this, &SerPrunesALotWindow::resetWhiteAiEngine);
 
 	// Add buttons to groups
 	blackPlayerBasicAlphaBeta->setActionGroup(blackEngines);
 	blackPlayerAlphaBetaTT->setActionGroup(blackEngines);
 	blackPlayerIterativeDeepening->setActionGroup(blackEngines);
 	blackPlayerAspirationSearch->setActionGroup(blackEngines);
+	blackPlayerPrincipalVariationSearch->setActionGroup(blackEngines);
+	blackPlayerMTDf->setActionGroup(blackEngines);
+	blackPlayerDfpnSolver->setActionGroup(blackEngines);
+	blackPlayerMonteCarloTreeSearch->setActionGroup(blackEngines);
 
 	whitePlayerBasicAlphaBeta->setActionGroup(whiteEngines);
 	whitePlayerAlphaBetaTT->setActionGroup(whiteEngines);
 	whitePlayerIterativeDeepening->setActionGroup(whiteEngines);
 	whitePlayerAspirationSearch->setActionGroup(whiteEngines);
+	whitePlayerPrincipalVariationSearch->setActionGroup(whiteEngines);
+	whitePlayerMTDf->setActionGroup(whiteEngines);
+	whitePlayerDfpnSolver->setActionGroup(whiteEngines);
+	whitePlayerMonteCarloTreeSearch->setActionGroup(whiteEngines);
 
 	// Make the buttons checkable
 	blackPlayerBasicAlphaBeta->setCheckable(true);
 	blackPlayerAlphaBetaTT->setCheckable(true);
 	blackPlayerIterativeDeepening->setCheckable(true);
 	blackPlayerAspirationSearch->setCheckable(true);
+	blackPlayerPrincipalVariationSearch->setCheckable(true);
+	blackPlayerMTDf->setCheckable(true);
+	blackPlayerDfpnSolver->setCheckable(true);
+	blackPlayerMonteCarloTreeSearch->setCheckable(true);
 
 	whitePlayerBasicAlphaBeta->setCheckable(true);
 	whitePlayerAlphaBetaTT->setCheckable(true);
 	whitePlayerIterativeDeepening->setCheckable(true);
 	whitePlayerAspirationSearch->setCheckable(true);
+	whitePlayerPrincipalVariationSearch->setCheckable(true);
+	whitePlayerMTDf->setCheckable(true);
+	whitePlayerDfpnSolver->setCheckable(true);
+	whitePlayerMonteCarloTreeSearch->setCheckable(true);
 
 	// Set the initially checked buttons
 	blackPlayerAspirationSearch->setChecked(true);
@@ -205,11 +261,19 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	blackEngineMenu->addAction(blackPlayerAlphaBetaTT);
 	blackEngineMenu->addAction(blackPlayerIterativeDeepening);
 	blackEngineMenu->addAction(blackPlayerAspirationSearch);
+	blackEngineMenu->addAction(blackPlayerPrincipalVariationSearch);
+	blackEngineMenu->addAction(blackPlayerMTDf);
+	blackEngineMenu->addAction(blackPlayerDfpnSolver);
+	blackEngineMenu->addAction(blackPlayerMonteCarloTreeSearch);
 
 	whiteEngineMenu->addAction(whitePlayerBasicAlphaBeta);
 	whiteEngineMenu->addAction(whitePlayerAlphaBetaTT);
 	whiteEngineMenu->addAction(whitePlayerIterativeDeepening);
 	whiteEngineMenu->addAction(whitePlayerAspirationSearch);
+	whiteEngineMenu->addAction(whitePlayerPrincipalVariationSearch);
+	whiteEngineMenu->addAction(whitePlayerMTDf);
+	whiteEngineMenu->addAction(whitePlayerDfpnSolver);
+	whiteEngineMenu->addAction(whitePlayerMonteCarloTreeSearch);
 
 	chooseEngineMenu->addMenu(blackEngineMenu);
 	chooseEngineMenu->addMenu(whiteEngineMenu);
@@ -219,6 +283,11 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 	menuBar()->addAction(undoLastMoveButton);
 	menuBar()->addMenu(chooseEngineMenu);
 	menuBar()->addAction(runAiButton);
+	menuBar()->addAction(stopAiButton);
+
+	// set up timer to check on AI searches running in the background
+	aiSearchPollTimer = new QTimer(this);
+	connect(aiSearchPollTimer, &QTimer::timeout, this, &SerPrunesALotWindow::pollAiSearch);
 
 	// set up status bar
 	winDetectionLabel = new QLabel();
@@ -244,6 +313,9 @@ SerPrunesALotWindow::SerPrunesALotWindow(QWidget *parent)
 
 SerPrunesALotWindow::~SerPrunesALotWindow()
 {
+	// search thread must be finished before its engine can be deleted
+	cancelAiSearch();
+
 	if (aiEngineBlack)
 	{
 		delete aiEngineBlack;
@@ -259,6 +331,11 @@ SerPrunesALotWindow::~SerPrunesALotWindow()
 
 void SerPrunesALotWindow::buttonClicked(GameBoardButton* button)
 {
+	if (activeSearch)		// don't allow the game state to change while the AI is thinking about it
+	{
+		return;
+	}
+
 	int clickedLoc = BoardUtils::coordsToIndex(button->column, button->row);
 	EPlayerColors::Type occupier = currentGameState.getOccupier(clickedLoc);
 	EPlayerColors::Type currentPlayer = currentGameState.getCurrentPlayer();
@@ -337,6 +414,9 @@ void SerPrunesALotWindow::initBoard()
 {
 	currentGameState.reset();
 	winDetectionLabel->setText("");
+
+	blackAiTimeRemainingMs = GAME_TIME_BUDGET_MS;
+	whiteAiTimeRemainingMs = GAME_TIME_BUDGET_MS;
 }
 
 void SerPrunesALotWindow::playTurnAi()
@@ -361,21 +441,108 @@ void SerPrunesALotWindow::playTurnAi()
 		return;
 	}
 
+	if (activeSearch)		// AI is already thinking
+	{
+		return;
+	}
+
 	statusBar()->showMessage("Running AI engine...");
 
-	// let our AI Engine choose a move
-	Move move = aiEngine->chooseMove(currentGameState);
+	{
+		std::lock_guard<std::mutex> lock(iterationInfoMutex);
+		iterationInfoChanged = false;
+	}
+
+	// let the engine manage its own time based on the game clock
+	SearchLimits limits;
+	limits.timeRemainingMs = (currentPlayer == EPlayerColors::Type::BLACK_PLAYER) ? blackAiTimeRemainingMs : whiteAiTimeRemainingMs;
+	limits.incrementMs = GAME_TIME_INCREMENT_MS;
+	aiMoveClock.start();
+
+	// let our AI Engine choose a move in the background. Progress is shown by pollAiSearch()
+	activeSearchEngine = aiEngine;
+	activeSearch = aiEngine->start(currentGameState, limits, [this](const SearchIterationInfo& info)
+	{
+		std::lock_guard<std::mutex> lock(iterationInfoMutex);
+		lastIterationInfo = info;
+		iterationInfoChanged = true;
+	});
+
+	aiSearchPollTimer->start(AI_SEARCH_POLL_INTERVAL_MS);
+}
+
+void SerPrunesALotWindow::pollAiSearch()
+{
+	if (!activeSearch)
+	{
+		aiSearchPollTimer->stop();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(iterationInfoMutex);
+
+		if (iterationInfoChanged)		// show progress of the search
+		{
+			std::string pvString;
+			for (const Move& pvMove : lastIterationInfo.principalVariation)
+			{
+				pvString += " " + pvMove.toString();
+			}
+
+			statusBar()->showMessage(QString::fromStdString(StringBuilder() << "Running AI engine... Depth = " << lastIterationInfo.depth
+																			<< ", Score = " << lastIterationInfo.score
+																			<< ", Nodes = " << lastIterationInfo.nodes
+																			<< ", Nodes per second = " << (int64_t)lastIterationInfo.nodesPerSecond
+																			<< (pvString.empty() ? "" : ", PV =") << pvString));
+			iterationInfoChanged = false;
+		}
+	}
+
+	if (!activeSearch->isFinished())
+	{
+		return;
+	}
+
+	aiSearchPollTimer->stop();
+	aiMoveClock.stop();
+
+	// update the game clock of the player that searched. Never let it drop to 0, since that would mean 'no limit'
+	int& timeRemainingMs = (currentGameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER) ? blackAiTimeRemainingMs : whiteAiTimeRemainingMs;
+	timeRemainingMs = std::max(1, timeRemainingMs - (int)aiMoveClock.getElapsedTimeInMilliSec()) + GAME_TIME_INCREMENT_MS;
+
+	Move move = activeSearch->wait();
+	AiEngine* aiEngine = activeSearchEngine;
+
+	delete activeSearch;
+	activeSearch = nullptr;
+	activeSearchEngine = nullptr;
 
-	if (move == INVALID_MOVE)		// means game is already over
+	finishTurnAi(aiEngine, move);
+}
+
+void SerPrunesALotWindow::finishTurnAi(AiEngine* aiEngine, Move move)
+{
+	EPlayerColors::Type currentPlayer = currentGameState.getCurrentPlayer();
+
+	if (move == INVALID_MOVE)
 	{
-		statusBar()->showMessage("Game ended!");
+		if (currentGameState.getWinner() != EPlayerColors::Type::NOTHING)		// game is already over
+		{
+			statusBar()->showMessage("Game ended!");
+		}
+		else
+		{
+			statusBar()->showMessage("AI engine did not return a move!");
+		}
+
 		return;
 	}
 
 	statusBar()->showMessage("Waiting for input...");
 	int rootEvaluation = aiEngine->getRootEvaluation();
 
-	if (rootEvaluation == aiEngine->getWinEvaluation())				// detected (future) win
+	if (aiEngine->isWinEvaluation(rootEvaluation) && rootEvaluation > 0)		// detected (future) win
 	{
 		if (currentPlayer == EPlayerColors::Type::WHITE_PLAYER)
 		{
@@ -386,7 +553,7 @@ void SerPrunesALotWindow::playTurnAi()
 			winDetectionLabel->setText("(Future) Win detected for Black Player by Black Player!");
 		}
 	}
-	else if (rootEvaluation == -aiEngine->getWinEvaluation())		// detected (future) loss
+	else if (aiEngine->isWinEvaluation(rootEvaluation))					// detected (future) loss
 	{
 		if (currentPlayer == EPlayerColors::Type::WHITE_PLAYER)
 		{
@@ -411,6 +578,10 @@ void SerPrunesALotWindow::playTurnAi()
 
 	IterativeDeepening* itDeepeningEngine = dynamic_cast<IterativeDeepening*>(aiEngine);
 	AspirationSearch* aspirationSearchEngine = dynamic_cast<AspirationSearch*>(aiEngine);
+	PrincipalVariationSearch* pvsEngine = dynamic_cast<PrincipalVariationSearch*>(aiEngine);
+	MTDf* mTDfEngine = dynamic_cast<MTDf*>(aiEngine);
+	DfpnSolver* dfpnEngine = dynamic_cast<DfpnSolver*>(aiEngine);
+	MonteCarloTreeSearch* mctsEngine = dynamic_cast<MonteCarloTreeSearch*>(aiEngine);
 
 	if (itDeepeningEngine)	// also write to GUI what the last search depth was of Iterative Deepening engine
 	{
@@ -424,6 +595,30 @@ void SerPrunesALotWindow::playTurnAi()
 		winDetectionLabel->setText(QString::fromStdString(StringBuilder() << currentText << " (Aspiration Search Depth = " << aspirationSearchEngine->getLastSearchDepth()
 			<< ", Seconds Searched = " << aspirationSearchEngine->getSecondsSearched() << ")"));
 	}
+	else if(pvsEngine)		// also write to GUI what the last search depth was of Principal Variation Search engine
+	{
+		std::string currentText = winDetectionLabel->text().toStdString();
+		winDetectionLabel->setText(QString::fromStdString(StringBuilder() << currentText << " (Principal Variation Search Depth = " << pvsEngine->getLastSearchDepth()
+			<< ", Seconds Searched = " << pvsEngine->getSecondsSearched() << ")"));
+	}
+	else if(mTDfEngine)		// also write to GUI what the last search depth was of MTD(f) engine
+	{
+		std::string currentText = winDetectionLabel->text().toStdString();
+		winDetectionLabel->setText(QString::fromStdString(StringBuilder() << currentText << " (MTD(f) Depth = " << mTDfEngine->getLastSearchDepth()
+			<< ", Seconds Searched = " << mTDfEngine->getSecondsSearched() << ")"));
+	}
+	else if(dfpnEngine)		// also write to GUI how long the DFPN solver searched
+	{
+		std::string currentText = winDetectionLabel->text().toStdString();
+		winDetectionLabel->setText(QString::fromStdString(StringBuilder() << currentText << " (DFPN Solver Nodes = " << dfpnEngine->getNodesVisited()
+			<< ", Seconds Searched = " << dfpnEngine->getSecondsSearched() << ")"));
+	}
+	else if(mctsEngine)		// also write to GUI how many playouts the Monte Carlo Tree Search engine ran
+	{
+		std::string currentText = winDetectionLabel->text().toStdString();
+		winDetectionLabel->setText(QString::fromStdString(StringBuilder() << currentText << " (Monte Carlo Tree Search Playouts = " << mctsEngine->getNumPlayouts()
+			<< ", Seconds Searched = " << mctsEngine->getSecondsSearched() << ")"));
+	}
 
 	// revert all currently highlighted buttons back to their normal color
 	for (GameBoardButton* highlighted : highlightedButtons)
@@ -472,6 +667,11 @@ void SerPrunesALotWindow::resetBlackAiEngine()
 {
 	if (aiEngineBlack)
 	{
+		if (activeSearchEngine == aiEngineBlack)
+		{
+			cancelAiSearch();
+		}
+
 		delete aiEngineBlack;
 	}
 
@@ -491,12 +691,33 @@ void SerPrunesALotWindow::resetBlackAiEngine()
 	{
 		aiEngineBlack = new AspirationSearch();
 	}
+	else if(blackPlayerPrincipalVariationSearch->isChecked())
+	{
+		aiEngineBlack = new PrincipalVariationSearch();
+	}
+	else if(blackPlayerMTDf->isChecked())
+	{
+		aiEngineBlack = new MTDf();
+	}
+	else if(blackPlayerDfpnSolver->isChecked())
+	{
+		aiEngineBlack = new DfpnSolver();
+	}
+	else if(blackPlayerMonteCarloTreeSearch->isChecked())
+	{
+		aiEngineBlack = new MonteCarloTreeSearch();
+	}
 }
 
 void SerPrunesALotWindow::resetWhiteAiEngine()
 {
 	if (aiEngineWhite)
 	{
+		if (activeSearchEngine == aiEngineWhite)
+		{
+			cancelAiSearch();
+		}
+
 		delete aiEngineWhite;
 	}
 
@@ -516,10 +737,40 @@ void SerPrunesALotWindow::resetWhiteAiEngine()
 	{
 		aiEngineWhite = new AspirationSearch();
 	}
+	else if(whitePlayerPrincipalVariationSearch->isChecked())
+	{
+		aiEngineWhite = new PrincipalVariationSearch();
+	}
+	else if(whitePlayerMTDf->isChecked())
+	{
+		aiEngineWhite = new MTDf();
+	}
+	else if(whitePlayerDfpnSolver->isChecked())
+	{
+		aiEngineWhite = new DfpnSolver();
+	}
+	else if(whitePlayerMonteCarloTreeSearch->isChecked())
+	{
+		aiEngineWhite = new MonteCarloTreeSearch();
+	}
+}
+
+void SerPrunesALotWindow::stopAi()
+{
+	if (activeSearch)
+	{
+		statusBar()->showMessage("Stopping AI engine...");
+		activeSearch->stop();		// pollAiSearch() will play the best move found so far once the search has stopped
+	}
 }
 
 void SerPrunesALotWindow::undoLastMove()
 {
+	if (activeSearch)		// don't allow the game state to change while the AI is thinking about it
+	{
+		return;
+	}
+
 	if (movesPlayed.size() > 0)
 	{
 		Move& move = movesPlayed.back();
@@ -546,6 +797,20 @@ void SerPrunesALotWindow::undoLastMove()
 	}
 }
 
+void SerPrunesALotWindow::cancelAiSearch()
+{
+	if (activeSearch)
+	{
+		aiSearchPollTimer->stop();
+
+		delete activeSearch;		// stops the search and waits for the search thread to finish
+		activeSearch = nullptr;
+		activeSearchEngine = nullptr;
+
+		statusBar()->showMessage("AI engine cancelled");
+	}
+}
+
 void SerPrunesALotWindow::updateGui()
 {
 	for (int y = 0; y < BOARD_HEIGHT; ++y)
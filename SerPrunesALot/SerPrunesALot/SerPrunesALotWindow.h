@@ -1,15 +1,20 @@
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include <QtWidgets/QMainWindow>
 #include <qlabel>
 #include "QAction.h"
+#include "QTimer.h"
 
 #include "AiEngine.h"
 #include "GameBoardButton.h"
 #include "GameConstants.h"
 #include "GameState.h"
+#include "SearchHandle.h"
+#include "SearchLimits.h"
+#include "Timer.hpp"
 #include "ui_SerPrunesALot.h"
 
 /**
@@ -35,14 +40,20 @@ public:
 	 */
 	void initBoard();
 
-	/** Tells the AI engine to play this turn */
+	/** Tells the AI engine to play this turn. The engine searches in the background, so this returns immediately */
 	void playTurnAi();
 
+	/** Checks on the progress of the AI search running in the background, and plays its move once it's finished */
+	void pollAiSearch();
+
 	/** Sets the Black Player's AI engine to whatever button is chosen in the menu */
 	void resetBlackAiEngine();
 	/** Sets the White Player's AI engine to whatever button is chosen in the menu */
 	void resetWhiteAiEngine();
 
+	/** Tells the AI search running in the background (if any) to stop and play the best move found so far */
+	void stopAi();
+
 	/** Reverts the game state back to the way it was before executing the last executed move */
 	void undoLastMove();
 
@@ -54,6 +65,12 @@ protected:
 	virtual void resizeEvent(QResizeEvent* event);
 
 private:
+	/** Cancels the AI search running in the background (if any) without playing its move. Blocks until the search has stopped */
+	void cancelAiSearch();
+
+	/** Plays the move chosen by the given AI engine, and updates the GUI accordingly */
+	void finishTurnAi(AiEngine* aiEngine, Move move);
+
 	/** Matrix of all the buttons on the board */
 	std::vector<std::vector<GameBoardButton*>> boardButtons;
 	/** Vector of icons which are currently highlighted as being possible to move to */
@@ -73,6 +90,27 @@ private:
 	/** The AI engine currently being used by the White Player */
 	AiEngine* aiEngineWhite;
 
+	/** Handle to the AI search running in the background. nullptr if no search is running */
+	SearchHandle* activeSearch;
+	/** The AI engine running the active search. nullptr if no search is running */
+	AiEngine* activeSearchEngine;
+	/** Timer that regularly triggers pollAiSearch() while a search is running, so that the GUI remains responsive */
+	QTimer* aiSearchPollTimer;
+
+	/** Info of the last iteration completed by the active search. Written by the search thread, so protected by iterationInfoMutex */
+	SearchIterationInfo lastIterationInfo;
+	/** True iff lastIterationInfo has been updated since the last time it was shown in the GUI */
+	bool iterationInfoChanged;
+	/** Mutex protecting lastIterationInfo and iterationInfoChanged */
+	std::mutex iterationInfoMutex;
+
+	/** Time in milliseconds left on the game clock of the Black Player's AI engine */
+	int blackAiTimeRemainingMs;
+	/** Time in milliseconds left on the game clock of the White Player's AI engine */
+	int whiteAiTimeRemainingMs;
+	/** Measures the time spent by the active search, to be subtracted from the searching player's game clock */
+	Timer aiMoveClock;
+
 	// Menu options
 	/** Option to toggle if AI control of the black player is allowed */
 	QAction* blackPlayerAiControl;
@@ -91,6 +129,14 @@ private:
 	QAction* blackPlayerIterativeDeepening;
 	/** If toggled, Black Player will use the Aspiration Search engine */
 	QAction* blackPlayerAspirationSearch;
+	/** If toggled, Black Player will use the Principal Variation Search engine */
+	QAction* blackPlayerPrincipalVariationSearch;
+	/** If toggled, Black Player will use the MTD(f) engine */
+	QAction* blackPlayerMTDf;
+	/** If toggled, Black Player will use the DFPN Solver engine */
+	QAction* blackPlayerDfpnSolver;
+	/** If toggled, Black Player will use the Monte Carlo Tree Search engine */
+	QAction* blackPlayerMonteCarloTreeSearch;
 
 	/** If toggled, White Player will use Basic Alpha Beta engine */
 	QAction* whitePlayerBasicAlphaBeta;
@@ -100,6 +146,14 @@ private:
 	QAction* whitePlayerIterativeDeepening;
 	/** If toggled, White Player will use the Aspiration Search engine */
 	QAction* whitePlayerAspirationSearch;
+	/** If toggled, White Player will use the Principal Variation Search engine */
+	QAction* whitePlayerPrincipalVariationSearch;
+	/** If toggled, White Player will use the MTD(f) engine */
+	QAction* whitePlayerMTDf;
+	/** If toggled, White Player will use the DFPN Solver engine */
+	QAction* whitePlayerDfpnSolver;
+	/** If toggled, White Player will use the Monte Carlo Tree Search engine */
+	QAction* whitePlayerMonteCarloTreeSearch;
 
 	// Status Bar
 	/** The label in the status bar that will tell the user when an AI engine has detected a win or a loss */
@@ -0,0 +1,198 @@
+#define NOMINMAX
+
+#include <algorithm>
+
+#include "Bitboards.hpp"
+#include "Logger.h"
+#include "Tablebase.h"
+
+namespace
+{
+	/** Table of binomial coefficients: binomials[n][k] = n choose k */
+	struct BinomialTable
+	{
+		uint64_t binomials[TABLEBASE_NUM_SQUARES + 1][TABLEBASE_MAX_KNIGHTS_PER_SIDE + 1];
+	};
+
+	BinomialTable precomputeBinomials()
+	{
+		BinomialTable table;
+
+		for(int n = 0; n <= TABLEBASE_NUM_SQUARES; ++n)
+		{
+			table.binomials[n][0] = 1;
+
+			for(int k = 1; k <= TABLEBASE_MAX_KNIGHTS_PER_SIDE; ++k)
+			{
+				table.binomials[n][k] = (n == 0) ? 0 : table.binomials[n - 1][k - 1] + table.binomials[n - 1][k];
+			}
+		}
+
+		return table;
+	}
+
+	const BinomialTable binomialTable = precomputeBinomials();
+
+	/** The first square (in bitboard order) of the squares that white knights can stand on. Black knights start at square 0 */
+	const int WHITE_SQUARE_OFFSET = 8;
+
+	/** Returns the rank of the given combination of knights in the combinatorial number system */
+	uint64_t getCombinationRank(uint64_t knights, int squareOffset)
+	{
+		uint64_t rank = 0;
+		int k = 1;
+
+		while(knights)
+		{
+			int square = Bitboards::bitScanForward(knights) - squareOffset;
+			knights &= knights - 1;
+			rank += binomialTable.binomials[square][k];
+			++k;
+		}
+
+		return rank;
+	}
+
+	/** Returns the combination of the given number of knights with the given rank in the combinatorial number system */
+	uint64_t getCombination(uint64_t rank, int numKnights, int squareOffset)
+	{
+		uint64_t knights = Bitboards::ALL_ZERO;
+		int square = TABLEBASE_NUM_SQUARES - 1;
+
+		for(int k = numKnights; k > 0; --k)
+		{
+			// the largest square whose binomial still fits in the remaining rank
+			while(binomialTable.binomials[square][k] > rank)
+			{
+				--square;
+			}
+
+			rank -= binomialTable.binomials[square][k];
+			knights |= Bitboards::singleBit(square + squareOffset);
+			--square;
+		}
+
+		return knights;
+	}
+}
+
+Tablebase::Tablebase() : maxKnightsPerSide(0)
+{
+	load(TABLEBASE_DIRECTORY);
+}
+
+int Tablebase::load(const std::string& directory)
+{
+	int numFilesLoaded = 0;
+	maxKnightsPerSide = 0;
+	bool complete = true;
+
+	for(int numKnights = 1; numKnights <= TABLEBASE_MAX_KNIGHTS_PER_SIDE; ++numKnights)
+	{
+		for(int numBlackKnights = 0; numBlackKnights <= TABLEBASE_MAX_KNIGHTS_PER_SIDE; ++numBlackKnights)
+		{
+			for(int numWhiteKnights = 0; numWhiteKnights <= TABLEBASE_MAX_KNIGHTS_PER_SIDE; ++numWhiteKnights)
+			{
+				// visit every file once, as part of the smallest maximum number of knights per side that it belongs to
+				if(numBlackKnights == 0 || numWhiteKnights == 0 || std::max(numBlackKnights, numWhiteKnights) != numKnights)
+				{
+					continue;
+				}
+
+				for(int playerIndex = 0; playerIndex < 2; ++playerIndex)
+				{
+					EPlayerColors::Type playerToMove = (playerIndex == 0) ? EPlayerColors::Type::BLACK_PLAYER : EPlayerColors::Type::WHITE_PLAYER;
+					File& file = files[numBlackKnights][numWhiteKnights][playerIndex];
+					file.entries = nullptr;
+
+					if(!file.mapping.open(directory + "/" + getFileName(numBlackKnights, numWhiteKnights, playerToMove)) ||
+						file.mapping.getSize() < sizeof(TablebaseHeader))
+					{
+						complete = false;
+						continue;
+					}
+
+					const TablebaseHeader* header = reinterpret_cast<const TablebaseHeader*>(file.mapping.getData());
+					uint64_t numEntries = getNumEntries(numBlackKnights, numWhiteKnights);
+
+					if(header->magic != TABLEBASE_MAGIC || header->numBlackKnights != numBlackKnights ||
+						header->numWhiteKnights != numWhiteKnights || header->playerToMove != playerToMove ||
+						header->bitsPerEntry < 1 || header->bitsPerEntry > 8 || header->numEntries != numEntries ||
+						file.mapping.getSize() < sizeof(TablebaseHeader) + (numEntries * header->bitsPerEntry + 7) / 8 + 1)
+					{
+						LOG_ERROR(StringBuilder() << "Invalid tablebase file: " << getFileName(numBlackKnights, numWhiteKnights, playerToMove))
+						file.mapping.close();
+						complete = false;
+						continue;
+					}
+
+					file.entries = file.mapping.getData() + sizeof(TablebaseHeader);
+					file.bitsPerEntry = header->bitsPerEntry;
+					++numFilesLoaded;
+				}
+			}
+		}
+
+		// positions with fewer knights are reached by captures, so only probe up to the largest complete set of files
+		if(!complete)
+		{
+			break;
+		}
+
+		maxKnightsPerSide = numKnights;
+	}
+
+	return numFilesLoaded;
+}
+
+int Tablebase::getMaxKnightsPerSide() const
+{
+	return maxKnightsPerSide;
+}
+
+int Tablebase::probe(const GameState& gameState) const
+{
+	int numBlackKnights = gameState.getNumBlackKnights();
+	int numWhiteKnights = gameState.getNumWhiteKnights();
+
+	if(numBlackKnights > maxKnightsPerSide || numWhiteKnights > maxKnightsPerSide)
+	{
+		return 0;
+	}
+
+	int playerIndex = (gameState.getCurrentPlayer() == EPlayerColors::Type::BLACK_PLAYER) ? 0 : 1;
+	const File& file = files[numBlackKnights][numWhiteKnights][playerIndex];
+	uint64_t index = getIndex(gameState.getBitboard(EPlayerColors::Type::BLACK_PLAYER), gameState.getBitboard(EPlayerColors::Type::WHITE_PLAYER), numWhiteKnights);
+	int plies = readEntry(file.entries, index, file.bitsPerEntry) - 1;
+
+	if(plies <= 0)		// illegal position (which cannot happen) or no legal moves, for which the engines have no score
+	{
+		return 0;
+	}
+
+	return (plies % 2 == 1) ? plies : -plies;
+}
+
+uint64_t Tablebase::getNumEntries(int numBlackKnights, int numWhiteKnights)
+{
+	return binomialTable.binomials[TABLEBASE_NUM_SQUARES][numBlackKnights] * binomialTable.binomials[TABLEBASE_NUM_SQUARES][numWhiteKnights];
+}
+
+uint64_t Tablebase::getIndex(uint64_t blackBitboard, uint64_t whiteBitboard, int numWhiteKnights)
+{
+	return getCombinationRank(blackBitboard, 0) * binomialTable.binomials[TABLEBASE_NUM_SQUARES][numWhiteKnights] +
+			getCombinationRank(whiteBitboard, WHITE_SQUARE_OFFSET);
+}
+
+bool Tablebase::getBitboards(uint64_t index, int numBlackKnights, int numWhiteKnights, uint64_t& blackBitboard, uint64_t& whiteBitboard)
+{
+	uint64_t numWhiteCombinations = binomialTable.binomials[TABLEBASE_NUM_SQUARES][numWhiteKnights];
+	blackBitboard = getCombination(index / numWhiteCombinations, numBlackKnights, 0);
+	whiteBitboard = getCombination(index % numWhiteCombinations, numWhiteKnights, WHITE_SQUARE_OFFSET);
+	return ((blackBitboard & whiteBitboard) == Bitboards::ALL_ZERO);
+}
+
+std::string Tablebase::getFileName(int numBlackKnights, int numWhiteKnights, EPlayerColors::Type playerToMove)
+{
+	return StringBuilder() << "B" << numBlackKnights << "W" << numWhiteKnights << ((playerToMove == EPlayerColors::Type::BLACK_PLAYER) ? "_black" : "_white") << ".ktb";
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+
+#include "GameState.h"
+#include "MemoryMappedFile.h"
+
+/** The maximum number of knights per player supported by the tablebase indexing */
+#define TABLEBASE_MAX_KNIGHTS_PER_SIDE 3
+/** The number of squares on which a knight can stand without having reached its goal row already */
+#define TABLEBASE_NUM_SQUARES 56
+/** The first 4 bytes of every tablebase file */
+#define TABLEBASE_MAGIC 0x3142544B		// "KTB1"
+/** The directory in which the engines look for tablebase files */
+#define TABLEBASE_DIRECTORY "Tablebases"
+
+/** The header at the start of every tablebase file, followed by the bit-packed entries */
+struct TablebaseHeader
+{
+	/** Identifies the file as a tablebase file. Must be TABLEBASE_MAGIC */
+	uint32_t magic;
+	/** The number of knights of the black player in all positions of the file */
+	uint8_t numBlackKnights;
+	/** The number of knights of the white player in all positions of the file */
+	uint8_t numWhiteKnights;
+	/** The player to move in all positions of the file */
+	uint8_t playerToMove;
+	/** The number of bits of every entry */
+	uint8_t bitsPerEntry;
+	/** The number of entries in the file */
+	uint64_t numEntries;
+};
+
+/**
+ * Endgame tablebases: the exact result of every position with a small number of knights, generated in advance by
+ * TablebaseGenerator and probed through memory-mapped files.
+ *
+ * There is one file per number of black knights, number of white knights and player to move. A position is indexed by
+ * the combination of squares of the black knights times the number of combinations for the white knights, plus the
+ * combination of squares of the white knights, where combinations are ranked with the combinatorial number system. Knights
+ * on their goal row would have won already, so only the 56 other squares are considered for each player. Indices where
+ * black and white knights overlap are wasted, which keeps the indexing trivial to compute.
+ *
+ * Every entry stores the number of plies until the game ends with perfect play (where the winner wins as fast as possible
+ * and the loser postpones the loss as long as possible) plus 1, in the smallest number of bits that fits all entries of
+ * the file. An entry of 0 marks an illegal position. The player to move wins iff the number of plies is odd, because the
+ * game can only be won by moving. A player without any legal moves is considered to have lost.
+ */
+class Tablebase
+{
+public:
+	Tablebase();
+
+	/**
+	 * Maps all tablebase files found in the given directory into memory, replacing any previously loaded files.
+	 * Returns the number of files that were loaded
+	 */
+	int load(const std::string& directory);
+
+	/** Returns the largest number of knights per player for which all tablebase files were loaded. 0 = no tablebases loaded */
+	int getMaxKnightsPerSide() const;
+
+	/**
+	 * Returns the number of plies after which the player to move in the given game state wins (if positive) or loses
+	 * (if negative), or 0 if the position is not in the loaded tablebases. The game must not be over yet.
+	 * Uses the same convention as RaceDetector::detectRace(), but the distances are exact.
+	 */
+	int probe(const GameState& gameState) const;
+
+	/** Returns the number of entries (including illegal positions) of a file with the given numbers of knights */
+	static uint64_t getNumEntries(int numBlackKnights, int numWhiteKnights);
+
+	/** Returns the index of the position with the given bitboards. No knight may be on its goal row */
+	static uint64_t getIndex(uint64_t blackBitboard, uint64_t whiteBitboard, int numWhiteKnights);
+
+	/**
+	 * Computes the bitboards of the position with the given index and numbers of knights.
+	 * Returns false if the index describes an illegal position, in which black and white knights overlap
+	 */
+	static bool getBitboards(uint64_t index, int numBlackKnights, int numWhiteKnights, uint64_t& blackBitboard, uint64_t& whiteBitboard);
+
+	/** Returns the name of the file (without directory) for the given numbers of knights and player to move */
+	static std::string getFileName(int numBlackKnights, int numWhiteKnights, EPlayerColors::Type playerToMove);
+
+	/** Returns the entry with the given index from the given bit-packed entries */
+	static inline uint8_t readEntry(const uint8_t* entries, uint64_t index, int bitsPerEntry)
+	{
+		uint64_t bitIndex = index * bitsPerEntry;
+		const uint8_t* bytes = entries + (bitIndex >> 3);
+		// entries are at most 8 bits, so they span at most 2 bytes (files are padded with a byte at the end)
+		unsigned int window = bytes[0] | (bytes[1] << 8);
+		return (uint8_t)((window >> (bitIndex & 7)) & ((1u << bitsPerEntry) - 1));
+	}
+
+private:
+	/** A mapped tablebase file */
+	struct File
+	{
+		/** The mapping of the file */
+		MemoryMappedFile mapping;
+		/** The bit-packed entries, following the header. nullptr = not loaded */
+		const uint8_t* entries;
+		/** The number of bits of every entry */
+		int bitsPerEntry;
+
+		File() : mapping(), entries(nullptr), bitsPerEntry(0) {}
+	};
+
+	/** The mapped files, indexed by number of black knights, number of white knights, and player to move (0 = black) */
+	File files[TABLEBASE_MAX_KNIGHTS_PER_SIDE + 1][TABLEBASE_MAX_KNIGHTS_PER_SIDE + 1][2];
+
+	/** The largest number of knights per player for which all files were loaded */
+	int maxKnightsPerSide;
+
+	// don't want accidental copying of the mapped files
+	Tablebase(const Tablebase&);
+	Tablebase& operator=(const Tablebase&);
+};
\ No newline at end of file
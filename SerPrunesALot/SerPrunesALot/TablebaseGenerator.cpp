@@ -0,0 +1,273 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "Bitboards.hpp"
+#include "Logger.h"
+#include "MoveGenerator.h"
+#include "Tablebase.h"
+#include "TablebaseGenerator.h"
+#include "Timer.hpp"
+
+namespace
+{
+	/** Marks illegal positions in the table of advancements */
+	const uint8_t ILLEGAL_POSITION = 0xFF;
+
+	/**
+	 * The entries of all positions generated so far, indexed by number of black knights, number of white knights, and player
+	 * to move (0 = black). Entries are stored in a byte each while generating, and only bit-packed when written to a file
+	 */
+	struct GeneratedEntries
+	{
+		std::vector<uint8_t> entries[TABLEBASE_MAX_KNIGHTS_PER_SIDE + 1][TABLEBASE_MAX_KNIGHTS_PER_SIDE + 1][2];
+	};
+
+	/** Returns the number of rows that all knights together have advanced from their own side of the board */
+	int getAdvancement(uint64_t blackBitboard, uint64_t whiteBitboard)
+	{
+		int advancement = 0;
+
+		while(blackBitboard)		// black moves towards higher rows (in bitboard order)
+		{
+			advancement += Bitboards::bitScanForward(blackBitboard) / 8;
+			blackBitboard &= blackBitboard - 1;
+		}
+
+		while(whiteBitboard)		// white moves towards lower rows
+		{
+			advancement += 7 - Bitboards::bitScanForward(whiteBitboard) / 8;
+			whiteBitboard &= whiteBitboard - 1;
+		}
+
+		return advancement;
+	}
+
+	/**
+	 * Solves the given position with the given player to move (0 = black), given that all positions it can move to have been
+	 * solved already. Returns its entry: the number of plies until the game ends with perfect play, plus 1
+	 */
+	uint8_t solvePosition(const GeneratedEntries& generated, uint64_t blackBitboard, uint64_t whiteBitboard,
+						  int numBlackKnights, int numWhiteKnights, int playerIndex)
+	{
+		EPlayerColors::Type player = (playerIndex == 0) ? EPlayerColors::Type::BLACK_PLAYER : EPlayerColors::Type::WHITE_PLAYER;
+		uint64_t ownBitboard = (playerIndex == 0) ? blackBitboard : whiteBitboard;
+		uint64_t opponentBitboard = (playerIndex == 0) ? whiteBitboard : blackBitboard;
+		uint64_t goalRow = MoveGenerator::getGoalRow(player);
+
+		int fastestWin = 0;			// 0 = no win found
+		int slowestLoss = -1;		// -1 = no legal move found
+		uint64_t knights = ownBitboard;
+
+		while(knights)
+		{
+			int from = Bitboards::bitScanForward(knights);
+			knights &= knights - 1;
+
+			uint64_t targets = MoveGenerator::getKnightTargets(player, Bitboards::singleBit(from)) & ~ownBitboard;
+
+			while(targets)
+			{
+				uint64_t to = Bitboards::singleBit(Bitboards::bitScanForward(targets));
+				targets &= targets - 1;
+
+				if((to & goalRow) || to == opponentBitboard)		// reaching the goal row or capturing the last knight wins right away
+				{
+					return 2;
+				}
+
+				uint64_t newOwnBitboard = ownBitboard ^ Bitboards::singleBit(from) ^ to;
+				uint64_t newOpponentBitboard = opponentBitboard & ~to;
+				uint64_t newBlackBitboard = (playerIndex == 0) ? newOwnBitboard : newOpponentBitboard;
+				uint64_t newWhiteBitboard = (playerIndex == 0) ? newOpponentBitboard : newOwnBitboard;
+				int newNumBlackKnights = numBlackKnights - ((playerIndex == 1 && (opponentBitboard & to)) ? 1 : 0);
+				int newNumWhiteKnights = numWhiteKnights - ((playerIndex == 0 && (opponentBitboard & to)) ? 1 : 0);
+
+				const std::vector<uint8_t>& entries = generated.entries[newNumBlackKnights][newNumWhiteKnights][1 - playerIndex];
+				int opponentPlies = entries[Tablebase::getIndex(newBlackBitboard, newWhiteBitboard, newNumWhiteKnights)] - 1;
+
+				if(opponentPlies % 2 == 0)		// the opponent loses, so we win with one more ply
+				{
+					if(fastestWin == 0 || opponentPlies + 1 < fastestWin)
+					{
+						fastestWin = opponentPlies + 1;
+					}
+				}
+				else
+				{
+					slowestLoss = std::max(slowestLoss, opponentPlies + 1);
+				}
+			}
+		}
+
+		if(fastestWin > 0)
+		{
+			return (uint8_t)(fastestWin + 1);
+		}
+
+		// without any legal moves, the game is lost right away
+		return (uint8_t)(std::max(slowestLoss, 0) + 1);
+	}
+
+	/** Writes the given entries to a tablebase file, bit-packed with the given number of bits per entry. Returns false if that failed */
+	bool writeFile(const std::string& fileName, const std::vector<uint8_t>& entries, int numBlackKnights, int numWhiteKnights,
+				   int playerIndex, int bitsPerEntry)
+	{
+		std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+
+		if(!output)
+		{
+			return false;
+		}
+
+		TablebaseHeader header;
+		header.magic = TABLEBASE_MAGIC;
+		header.numBlackKnights = (uint8_t)numBlackKnights;
+		header.numWhiteKnights = (uint8_t)numWhiteKnights;
+		header.playerToMove = (uint8_t)((playerIndex == 0) ? EPlayerColors::Type::BLACK_PLAYER : EPlayerColors::Type::WHITE_PLAYER);
+		header.bitsPerEntry = (uint8_t)bitsPerEntry;
+		header.numEntries = entries.size();
+
+		// padded with an extra byte, so that reading an entry never has to check whether it is the last byte
+		std::vector<uint8_t> packed((entries.size() * bitsPerEntry + 7) / 8 + 1, 0);
+
+		for(uint64_t i = 0; i < entries.size(); ++i)
+		{
+			uint64_t bitIndex = i * bitsPerEntry;
+			unsigned int shiftedEntry = (unsigned int)entries[i] << (bitIndex & 7);
+			packed[bitIndex >> 3] |= (uint8_t)shiftedEntry;
+			packed[(bitIndex >> 3) + 1] |= (uint8_t)(shiftedEntry >> 8);
+		}
+
+		output.write(reinterpret_cast<const char*>(&header), sizeof(TablebaseHeader));
+		output.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+		return !output.fail();
+	}
+
+	/** Generates and writes the files for the given numbers of knights. All files with fewer knights must have been generated already */
+	bool generateFiles(GeneratedEntries& generated, int numBlackKnights, int numWhiteKnights, int numThreads, const std::string& directory)
+	{
+		Timer timer;
+		timer.start();
+
+		uint64_t numEntries = Tablebase::getNumEntries(numBlackKnights, numWhiteKnights);
+		std::vector<uint8_t>& blackToMove = generated.entries[numBlackKnights][numWhiteKnights][0];
+		std::vector<uint8_t>& whiteToMove = generated.entries[numBlackKnights][numWhiteKnights][1];
+		blackToMove.assign(numEntries, 0);
+		whiteToMove.assign(numEntries, 0);
+
+		// every thread works on its own range of indices, so no synchronization is needed other than waiting for all of them
+		auto runInParallel = [numThreads, numEntries](const std::function<void(uint64_t, uint64_t)>& solveRange)
+		{
+			std::vector<std::thread> threads;
+
+			for(int t = 0; t < numThreads; ++t)
+			{
+				threads.push_back(std::thread(solveRange, numEntries * t / numThreads, numEntries * (t + 1) / numThreads));
+			}
+
+			for(std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		};
+
+		// the advancement of every position is computed once, rather than in every pass
+		std::vector<uint8_t> advancements(numEntries);
+
+		runInParallel([&](uint64_t begin, uint64_t end)
+		{
+			for(uint64_t index = begin; index < end; ++index)
+			{
+				uint64_t blackBitboard, whiteBitboard;
+				bool legal = Tablebase::getBitboards(index, numBlackKnights, numWhiteKnights, blackBitboard, whiteBitboard);
+				advancements[index] = (legal) ? (uint8_t)getAdvancement(blackBitboard, whiteBitboard) : ILLEGAL_POSITION;
+			}
+		});
+
+		// every knight can have advanced at most 6 rows without reaching its goal row
+		for(int advancement = 6 * (numBlackKnights + numWhiteKnights); advancement >= 0; --advancement)
+		{
+			runInParallel([&](uint64_t begin, uint64_t end)
+			{
+				for(uint64_t index = begin; index < end; ++index)
+				{
+					if(advancements[index] != advancement)
+					{
+						continue;
+					}
+
+					uint64_t blackBitboard, whiteBitboard;
+					Tablebase::getBitboards(index, numBlackKnights, numWhiteKnights, blackBitboard, whiteBitboard);
+					blackToMove[index] = solvePosition(generated, blackBitboard, whiteBitboard, numBlackKnights, numWhiteKnights, 0);
+					whiteToMove[index] = solvePosition(generated, blackBitboard, whiteBitboard, numBlackKnights, numWhiteKnights, 1);
+				}
+			});
+		}
+
+		// use the smallest number of bits that fits all entries of both files
+		uint8_t maxEntry = std::max(*std::max_element(blackToMove.begin(), blackToMove.end()), *std::max_element(whiteToMove.begin(), whiteToMove.end()));
+		int bitsPerEntry = 1;
+
+		while((1 << bitsPerEntry) <= maxEntry)
+		{
+			++bitsPerEntry;
+		}
+
+		for(int playerIndex = 0; playerIndex < 2; ++playerIndex)
+		{
+			EPlayerColors::Type playerToMove = (playerIndex == 0) ? EPlayerColors::Type::BLACK_PLAYER : EPlayerColors::Type::WHITE_PLAYER;
+			std::string fileName = Tablebase::getFileName(numBlackKnights, numWhiteKnights, playerToMove);
+
+			if(!writeFile(directory + "/" + fileName, generated.entries[numBlackKnights][numWhiteKnights][playerIndex],
+						  numBlackKnights, numWhiteKnights, playerIndex, bitsPerEntry))
+			{
+				LOG_ERROR(StringBuilder() << "Could not write tablebase file: " << fileName)
+				return false;
+			}
+		}
+
+		timer.stop();
+		LOG_MESSAGE(StringBuilder() << "Generated tablebases with " << numBlackKnights << " black and " << numWhiteKnights << " white knights: "
+									<< numEntries << " entries per file, " << bitsPerEntry << " bits per entry, longest game = " << (maxEntry - 1)
+									<< " plies, " << timer.getElapsedTimeInMilliSec() << " ms")
+		return true;
+	}
+}
+
+bool TablebaseGenerator::generate(int maxKnightsPerSide, int numThreads, const std::string& directory)
+{
+	if(maxKnightsPerSide < 1 || maxKnightsPerSide > TABLEBASE_MAX_KNIGHTS_PER_SIDE)
+	{
+		LOG_ERROR(StringBuilder() << "Tablebases are only supported for up to " << TABLEBASE_MAX_KNIGHTS_PER_SIDE << " knights per side")
+		return false;
+	}
+
+	numThreads = std::max(numThreads, 1);
+	GeneratedEntries generated;
+
+	// captures lead to positions with fewer knights, so generate those first
+	for(int totalKnights = 2; totalKnights <= 2 * maxKnightsPerSide; ++totalKnights)
+	{
+		for(int numBlackKnights = 1; numBlackKnights <= maxKnightsPerSide; ++numBlackKnights)
+		{
+			int numWhiteKnights = totalKnights - numBlackKnights;
+
+			if(numWhiteKnights < 1 || numWhiteKnights > maxKnightsPerSide)
+			{
+				continue;
+			}
+
+			if(!generateFiles(generated, numBlackKnights, numWhiteKnights, numThreads, directory))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
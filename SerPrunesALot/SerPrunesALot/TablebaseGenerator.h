@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Headless tool to generate the endgame tablebases probed through Tablebase.
+ *
+ * Knights only ever move forwards, so the game graph is acyclic, and the tablebases can be generated by a single backwards
+ * pass over every set of files, without the repeated passes or cycle handling that retrograde analysis needs in other games.
+ * A move either captures a knight, leading to a position with fewer knights that was generated before, or advances a knight
+ * by 1 or 2 rows, leading to a position with the same knights that is further advanced. Positions with the same knights are
+ * therefore solved in order of decreasing total advancement (summed over all knights), and all positions with the same total
+ * advancement only depend on positions that were solved already. Those are split into ranges of indices that are solved in
+ * parallel.
+ */
+namespace TablebaseGenerator
+{
+	/**
+	 * Generates the tablebase files for all positions with at least 1 and at most maxKnightsPerSide knights for both players,
+	 * using the given number of threads, and writes them to the given (existing) directory.
+	 * Returns false if maxKnightsPerSide is not supported or a file could not be written.
+	 */
+	bool generate(int maxKnightsPerSide, int numThreads, const std::string& directory);
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "Bitboards.hpp"
+#include "MoveGenerator.h"
+#include "ThreatSpaceSearch.h"
+
+ThreatSpaceSearch::ThreatSpaceSearch()
+	: table(THREAT_SPACE_TABLE_NUM_ENTRIES),
+	nodesVisited(0),
+	maxNodesVisited(0)
+{
+}
+
+int ThreatSpaceSearch::solve(GameState& gameState, int maxPlies, int64_t maxNodes, Move& winningMove)
+{
+	nodesVisited = 0;
+	maxNodesVisited = maxNodes;
+
+	if(gameState.getWinner() != EPlayerColors::Type::NOTHING)
+	{
+		return 0;
+	}
+
+	// iterative deepening, so that the shortest win is found. The attacker wins on its own moves, so at odd plies
+	for(int plies = 1; plies <= maxPlies; plies += 2)
+	{
+		int result = attack(gameState, plies, winningMove);
+
+		if(result > 0)
+		{
+			return result;
+		}
+
+		if(nodesVisited >= maxNodesVisited)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
+
+int64_t ThreatSpaceSearch::getNodesVisited() const
+{
+	return nodesVisited;
+}
+
+int ThreatSpaceSearch::attack(GameState& gameState, int maxPlies, Move& bestMove)
+{
+	++nodesVisited;
+
+	EPlayerColors::Type attacker = gameState.getCurrentPlayer();
+	EPlayerColors::Type defender = gameState.getOpponentColor(attacker);
+	uint64_t attackerBitboard = gameState.getBitboard(attacker);
+	uint64_t defenderBitboard = gameState.getBitboard(defender);
+	uint64_t dangerZone = MoveGenerator::getDangerZone(attacker);
+
+	if(attackerBitboard & dangerZone)		// we can move to the goal row right away
+	{
+		int from = Bitboards::bitScanForward(attackerBitboard & dangerZone);
+		int to = Bitboards::bitScanForward(MoveGenerator::getKnightTargets(attacker, Bitboards::singleBit(from)) & MoveGenerator::getGoalRow(attacker));
+		bestMove = Move(from, to, Bitboards::isBitSet(defenderBitboard, to));
+		return 1;
+	}
+
+	// a threat and the capture of the threatening knight take 2 more plies before we can win
+	if(maxPlies < 3 || nodesVisited >= maxNodesVisited)
+	{
+		return 0;
+	}
+
+	// the defender would have to answer with a threat of its own, which our threats do not answer
+	if(defenderBitboard & MoveGenerator::getDangerZone(defender))
+	{
+		return 0;
+	}
+
+	uint64_t zobrist = gameState.getZobrist();
+	Entry& entry = table[zobrist & (THREAT_SPACE_TABLE_NUM_ENTRIES - 1)];
+
+	if(entry.zobrist == zobrist)
+	{
+		if(entry.winPlies > 0 && entry.winPlies <= maxPlies)
+		{
+			bestMove = entry.bestMove;
+			return entry.winPlies;
+		}
+		else if(entry.winPlies == 0 && entry.searchedPlies >= maxPlies)
+		{
+			return 0;
+		}
+	}
+
+	// only knights that can move into the danger zone can make a threat
+	uint64_t threateningKnights = attackerBitboard & MoveGenerator::getKnightTargets(defender, dangerZone);
+
+	while(threateningKnights)
+	{
+		int from = Bitboards::bitScanForward(threateningKnights);
+		threateningKnights &= threateningKnights - 1;
+
+		uint64_t targets = MoveGenerator::getKnightTargets(attacker, Bitboards::singleBit(from)) & dangerZone & ~attackerBitboard;
+
+		while(targets)
+		{
+			int to = Bitboards::bitScanForward(targets);
+			targets &= targets - 1;
+
+			Move move(from, to, Bitboards::isBitSet(defenderBitboard, to));
+			gameState.applyMove(move);
+			// capturing the last knight of the defender wins right away
+			bool won = (gameState.getWinner() == attacker);
+			int defenderResult = (won) ? 0 : defend(gameState, maxPlies - 1);
+			gameState.undoMove(move);
+
+			if(won || defenderResult > 0)
+			{
+				int result = (won) ? 1 : defenderResult + 1;
+				bestMove = move;
+				entry.zobrist = zobrist;
+				entry.bestMove = move;
+				entry.winPlies = (int8_t)result;
+				entry.searchedPlies = (int8_t)maxPlies;
+				return result;
+			}
+		}
+	}
+
+	if(nodesVisited < maxNodesVisited)		// the search was complete, so it proved that there is no win within maxPlies
+	{
+		entry.zobrist = zobrist;
+		entry.bestMove = INVALID_MOVE;
+		entry.winPlies = 0;
+		entry.searchedPlies = (int8_t)maxPlies;
+	}
+
+	return 0;
+}
+
+int ThreatSpaceSearch::defend(GameState& gameState, int maxPlies)
+{
+	++nodesVisited;
+
+	EPlayerColors::Type defender = gameState.getCurrentPlayer();
+	EPlayerColors::Type attacker = gameState.getOpponentColor(defender);
+	uint64_t defenderBitboard = gameState.getBitboard(defender);
+
+	if(defenderBitboard & MoveGenerator::getDangerZone(defender))		// the defender wins first
+	{
+		return 0;
+	}
+
+	uint64_t threats = gameState.getBitboard(attacker) & MoveGenerator::getDangerZone(attacker);
+
+	// every reply other than a capture of the only threatening knight lets the attacker move to the goal row
+	uint64_t capturers = (Bitboards::isSingleBit(threats)) ? (defenderBitboard & MoveGenerator::getKnightTargets(attacker, threats)) : Bitboards::ALL_ZERO;
+
+	if(!capturers)
+	{
+		return 2;
+	}
+
+	int to = Bitboards::bitScanForward(threats);
+	int result = 0;
+
+	while(capturers)
+	{
+		int from = Bitboards::bitScanForward(capturers);
+		capturers &= capturers - 1;
+
+		Move move(from, to, true);
+		Move attackerMove = INVALID_MOVE;
+		gameState.applyMove(move);
+		int value = (gameState.getWinner() == defender) ? 0 : attack(gameState, maxPlies - 1, attackerMove);
+		gameState.undoMove(move);
+
+		if(value == 0)		// this capture refutes the threat (or the search could not prove otherwise)
+		{
+			return 0;
+		}
+
+		// the defender postpones the loss as long as possible
+		if(value + 1 > result)
+		{
+			result = value + 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#include "GameState.h"
+#include "Move.h"
+
+/** The number of entries in the threat-space search's own transposition table. Must be a power of 2 */
+#define THREAT_SPACE_TABLE_NUM_ENTRIES (1 << 16)
+
+/**
+ * Threat-space search, in the style of lambda-search with lambda = 1: a solver that only tries to prove that the player to
+ * move (the attacker) can force a win with a sequence of goal row threats.
+ *
+ * The attacker only plays moves that enter its danger zone, after which it threatens to move to the goal row. The defender
+ * must answer every threat by capturing the threatening knight (every other reply loses right away), so the only replies
+ * that need to be searched are those captures. A double threat, or a threat that cannot be captured, wins. Because both
+ * players have so few relevant moves, this proves forced wins many plies deep, far beyond the depth that a full-width
+ * search reaches in the same time. The attacker gives up as soon as the defender threatens to win itself.
+ *
+ * Positions where the attacker (the player to move) was proven to win, or not to win within some number of plies, are
+ * stored in a small table of its own. These results only depend on the position, so the table is kept between searches.
+ */
+class ThreatSpaceSearch
+{
+public:
+	ThreatSpaceSearch();
+
+	/**
+	 * Tries to prove that the player to move in the given game state can force a win with goal row threats, within the
+	 * given number of plies and without visiting more than the given number of nodes. Returns the number of plies of the
+	 * shortest such win that was found, and stores its first move in winningMove. Returns 0 if no win was proven.
+	 */
+	int solve(GameState& gameState, int maxPlies, int64_t maxNodes, Move& winningMove);
+
+	/** Returns the number of nodes visited by the last call to solve() */
+	int64_t getNodesVisited() const;
+
+private:
+	/** An entry in the table, describing a position with the attacker to move */
+	struct Entry
+	{
+		/** The full Zobrist hash value of the position. 0 = empty entry */
+		uint64_t zobrist;
+		/** The first move of the win, if one was proven */
+		Move bestMove;
+		/** The number of plies in which the attacker was proven to win, or 0 if it was not */
+		int8_t winPlies;
+		/** If no win was proven, the maximum number of plies that the search was allowed to use */
+		int8_t searchedPlies;
+
+		Entry() : zobrist(0), bestMove(INVALID_MOVE), winPlies(0), searchedPlies(0) {}
+	};
+
+	/** Table of proven and disproven positions, indexed by the lowest bits of the Zobrist hash value */
+	std::vector<Entry> table;
+
+	/** The number of nodes visited by the current call to solve() */
+	int64_t nodesVisited;
+	/** The maximum number of nodes that the current call to solve() may visit */
+	int64_t maxNodesVisited;
+
+	/**
+	 * Searches a node where the attacker is to move. Returns the number of plies (at most maxPlies) in which the attacker
+	 * can force a win with threats and stores the first move in bestMove, or returns 0 if that was not proven.
+	 */
+	int attack(GameState& gameState, int maxPlies, Move& bestMove);
+
+	/**
+	 * Searches a node where the defender is to move, right after the attacker made a threat. Returns the number of plies
+	 * (at most maxPlies) in which the attacker wins after all of the defender's replies, or 0 if that was not proven.
+	 */
+	int defend(GameState& gameState, int maxPlies);
+
+	// don't want accidental copying of the table
+	ThreatSpaceSearch(const ThreatSpaceSearch&);
+	ThreatSpaceSearch& operator=(const ThreatSpaceSearch&);
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#define NOMINMAX
+
+#include <algorithm>
+#include <cmath>
+
+#include "TimeManager.h"
+
+/** Lower bound on the estimated number of moves we still need to play in a game */
+#define MIN_MOVES_TO_GO 8
+/** Time in milliseconds that is never allocated, to account for overhead outside of the search */
+#define TIME_SAFETY_MARGIN_MS 100
+/** The maximum time for a move is at most this factor times the target time */
+#define MAX_TIME_FACTOR 4
+/** The maximum time for a move is at most the remaining time divided by this number */
+#define MAX_TIME_DIVISOR 3
+
+/** Effective branching factor assumed before it could be measured */
+#define DEFAULT_BRANCHING_FACTOR 6.0
+/** Bounds on the measured effective branching factor, to avoid extreme predictions from tiny iterations */
+#define MIN_BRANCHING_FACTOR 1.5
+#define MAX_BRANCHING_FACTOR 30.0
+
+/** Target time is multiplied by (1 + BEST_MOVE_INSTABILITY_WEIGHT * instability) */
+#define BEST_MOVE_INSTABILITY_WEIGHT 0.5
+/** A drop in root score by more than this margin is considered to be significant (= 1 row of progression) */
+#define SCORE_DROP_MARGIN 35
+/** Target time is multiplied by this factor if the root score dropped significantly */
+#define SCORE_DROP_EXTENSION 1.5
+
+TimeManager::TimeManager(int defaultTargetTimeMs, int defaultMaxTimeMs)
+	: defaultTargetTimeMs(defaultTargetTimeMs),
+	defaultMaxTimeMs(defaultMaxTimeMs),
+	targetTimeMs(defaultTargetTimeMs),
+	maxTimeMs(defaultMaxTimeMs),
+	numIterations(0),
+	lastTotalNodes(0),
+	lastIterationMs(0.0),
+	lastElapsedMs(0.0),
+	lastBestMove(INVALID_MOVE),
+	bestMoveInstability(0.0),
+	scoreDropped(false)
+{
+	iterationNodes[0] = iterationNodes[1] = iterationNodes[2] = 0;
+	iterationScores[0] = iterationScores[1] = 0;
+}
+
+void TimeManager::startMove(const SearchLimits& limits, const GameState& gameState)
+{
+	if(limits.timeRemainingMs > 0)		// caller gave us a game clock, so allocate a share of it
+	{
+		// rough estimate of the number of moves left; games with fewer knights tend to end sooner
+		int numKnights = gameState.getNumBlackKnights() + gameState.getNumWhiteKnights();
+		int movesToGo = std::max(MIN_MOVES_TO_GO, numKnights / 2 + 4);
+
+		int available = std::max(1, limits.timeRemainingMs - TIME_SAFETY_MARGIN_MS);
+		int increment = (limits.incrementMs * 3) / 4;
+
+		targetTimeMs = available / movesToGo + increment;
+		maxTimeMs = std::min(targetTimeMs * MAX_TIME_FACTOR, available / MAX_TIME_DIVISOR + increment);
+		maxTimeMs = std::min(maxTimeMs, available);
+
+		if(limits.maxTimeMs > 0)
+		{
+			maxTimeMs = std::min(maxTimeMs, limits.maxTimeMs);
+		}
+	}
+	else if(limits.maxTimeMs > 0)		// caller only gave a limit for this move, so scale our defaults down to fit within it
+	{
+		maxTimeMs = limits.maxTimeMs;
+		targetTimeMs = (int)(((int64_t)limits.maxTimeMs * defaultTargetTimeMs) / defaultMaxTimeMs);
+	}
+	else
+	{
+		targetTimeMs = defaultTargetTimeMs;
+		maxTimeMs = defaultMaxTimeMs;
+	}
+
+	maxTimeMs = std::max(1, maxTimeMs);
+	targetTimeMs = std::max(1, std::min(targetTimeMs, maxTimeMs));
+
+	numIterations = 0;
+	iterationNodes[0] = iterationNodes[1] = iterationNodes[2] = 0;
+	lastTotalNodes = 0;
+	lastIterationMs = 0.0;
+	lastElapsedMs = 0.0;
+	iterationScores[0] = iterationScores[1] = 0;
+	lastBestMove = INVALID_MOVE;
+	bestMoveInstability = 0.0;
+	scoreDropped = false;
+}
+
+int TimeManager::getTargetTimeMs() const
+{
+	return targetTimeMs;
+}
+
+int TimeManager::getMaxTimeMs() const
+{
+	return maxTimeMs;
+}
+
+void TimeManager::iterationCompleted(int score, const Move& bestMove, int64_t totalNodes, double elapsedMs)
+{
+	iterationNodes[2] = iterationNodes[1];
+	iterationNodes[1] = iterationNodes[0];
+	iterationNodes[0] = totalNodes - lastTotalNodes;
+	lastTotalNodes = totalNodes;
+
+	lastIterationMs = elapsedMs - lastElapsedMs;
+	lastElapsedMs = elapsedMs;
+
+	// best move changes in recent iterations count more than changes in older iterations
+	bestMoveInstability *= 0.5;
+	if(numIterations > 0 && !(bestMove == lastBestMove))
+	{
+		bestMoveInstability += 1.0;
+	}
+	lastBestMove = bestMove;
+
+	// compare to the iteration of the same parity, 2 iterations ago
+	scoreDropped = (numIterations >= 2 && score < iterationScores[1] - SCORE_DROP_MARGIN);
+	iterationScores[1] = iterationScores[0];
+	iterationScores[0] = score;
+
+	++numIterations;
+}
+
+bool TimeManager::shouldStartNextIteration(double elapsedMs) const
+{
+	if(numIterations == 0)
+	{
+		return true;
+	}
+
+	double predictedFinish = elapsedMs + getPredictedIterationMs();
+	return predictedFinish <= std::min(getExtendedTargetTimeMs(), (double)maxTimeMs);
+}
+
+double TimeManager::getPredictedIterationMs() const
+{
+	return lastIterationMs * getEffectiveBranchingFactor();
+}
+
+double TimeManager::getEffectiveBranchingFactor() const
+{
+	double branchingFactor = DEFAULT_BRANCHING_FACTOR;
+
+	if(numIterations >= 3 && iterationNodes[2] > 0)
+	{
+		branchingFactor = std::sqrt((double)iterationNodes[0] / iterationNodes[2]);
+	}
+	else if(numIterations >= 2 && iterationNodes[1] > 0)
+	{
+		branchingFactor = (double)iterationNodes[0] / iterationNodes[1];
+	}
+
+	return std::max(MIN_BRANCHING_FACTOR, std::min(MAX_BRANCHING_FACTOR, branchingFactor));
+}
+
+double TimeManager::getExtendedTargetTimeMs() const
+{
+	double extendedTarget = targetTimeMs * (1.0 + BEST_MOVE_INSTABILITY_WEIGHT * bestMoveInstability);
+
+	if(scoreDropped)
+	{
+		extendedTarget *= SCORE_DROP_EXTENSION;
+	}
+
+	return extendedTarget;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "GameState.h"
+#include "Move.h"
+#include "SearchLimits.h"
+
+/**
+ * Decides how much time an iterative deepening engine spends on a single move.
+ *
+ * When the caller provides a game clock (remaining time + increment) through the SearchLimits, a share of the remaining
+ * time is allocated to the move based on an estimate of the number of moves left in the game. Otherwise, the engine's
+ * own default target and maximum times are used.
+ *
+ * After every completed iteration, the engine reports the iteration's results. These are used to:
+ * - Measure the effective branching factor, and predict the duration of the next iteration from it.
+ *   Iterations that are not expected to finish in time are not started at all.
+ * - Extend the target time when the best move is unstable, or when the root score drops compared to the
+ *   previous iteration of the same parity (scores of odd and even depths are not comparable in this game).
+ */
+class TimeManager
+{
+public:
+	/**
+	 * Constructs a Time Manager
+	 *
+	 * defaultTargetTimeMs = Time to aim for if the caller does not provide any time limits
+	 * defaultMaxTimeMs = Hard limit on the time spent if the caller does not provide any time limits
+	 */
+	TimeManager(int defaultTargetTimeMs, int defaultMaxTimeMs);
+
+	/** Allocates time for a new move in the given game state, and resets all measurements of the previous move */
+	void startMove(const SearchLimits& limits, const GameState& gameState);
+
+	/** Returns the time in milliseconds that we aim to spend on the current move (before any extensions) */
+	int getTargetTimeMs() const;
+	/** Returns the time in milliseconds after which the search for the current move must be terminated */
+	int getMaxTimeMs() const;
+
+	/**
+	 * Reports a completed iteration.
+	 *
+	 * totalNodes = The number of nodes visited since the start of the search (so including previous iterations)
+	 * elapsedMs = The number of milliseconds elapsed since the start of the search
+	 */
+	void iterationCompleted(int score, const Move& bestMove, int64_t totalNodes, double elapsedMs);
+
+	/** Returns true iff there is enough time left to complete another iteration, given the current elapsed time */
+	bool shouldStartNextIteration(double elapsedMs) const;
+
+	/** Returns the predicted duration of the next iteration in milliseconds */
+	double getPredictedIterationMs() const;
+
+	/**
+	 * Returns the measured effective branching factor. Measured over the last two iterations where possible,
+	 * to cancel out the odd-even effect of alpha-beta.
+	 */
+	double getEffectiveBranchingFactor() const;
+
+private:
+	/** Default target time, used if caller does not provide time limits */
+	const int defaultTargetTimeMs;
+	/** Default maximum time, used if caller does not provide time limits */
+	const int defaultMaxTimeMs;
+
+	/** The time that we aim to spend on the current move, before any extensions */
+	int targetTimeMs;
+	/** The time after which the search for the current move must be terminated */
+	int maxTimeMs;
+
+	/** Number of completed iterations for the current move */
+	int numIterations;
+
+	/** The number of nodes visited in the last three completed iterations (index 0 = last) */
+	int64_t iterationNodes[3];
+	/** The total number of nodes visited at the end of the last completed iteration */
+	int64_t lastTotalNodes;
+	/** The duration of the last completed iteration in milliseconds */
+	double lastIterationMs;
+	/** The total time elapsed at the end of the last completed iteration */
+	double lastElapsedMs;
+
+	/** The root scores of the last two completed iterations (index 0 = last) */
+	int iterationScores[2];
+	/** The best move of the last completed iteration */
+	Move lastBestMove;
+
+	/** Decaying measure of how often the best move changed between iterations */
+	double bestMoveInstability;
+	/** True iff the root score of the last iteration dropped significantly compared to the iteration of the same parity */
+	bool scoreDropped;
+
+	/** Returns the target time extended by the instability of the search */
+	double getExtendedTargetTimeMs() const;
+};
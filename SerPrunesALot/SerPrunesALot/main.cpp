@@ -1,12 +1,80 @@
 #include "SerPrunesALotWindow.h"
 #include <QtWidgets/QApplication>
 
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "BatchPlayout.h"
+#include "EngineComparison.h"
+#include "MonteCarloTreeSearch.h"
+#include "OpeningBook.h"
+#include "OpeningBookBuilder.h"
+#include "PieceSquarePlanes.h"
+#include "ProbCutCalibration.h"
+#include "Tablebase.h"
+#include "TablebaseGenerator.h"
+
 /**
 * Code automatically generated by the ''New Project -> Qt Application'' wizard
+*
+* Edited to run headless tools instead of the GUI when given command line arguments:
+* --compare-mtdf [depth] [numPositions]		Compares MTD(f) with Aspiration Search on a fixed set of positions
+* --calibrate-probcut [shallowDepth] [deepDepth] [numPositions]		Collects ProbCut samples and fits the ProbCut coefficients
+* --generate-tablebases [maxKnightsPerSide] [numThreads]		Generates the endgame tablebases in the Tablebases directory
+* --build-opening-book [numPositions] [searchDepth] [numThreads]		Builds the opening book by drop-out expansion
+* --benchmark-playouts [numPlayouts]		Compares the playouts per second of the scalar and batched (vectorized) playouts
+* --benchmark-evaluation [numPositions]		Compares the bit-sliced piece-square evaluation with a loop over all knights
+* --check-mcts		Checks that Monte Carlo Tree Search backs up its playout results for the right players
 */
 
 int main(int argc, char *argv[])
 {
+	if (argc > 1 && std::string(argv[1]) == "--compare-mtdf")
+	{
+		int depth = (argc > 2) ? std::atoi(argv[2]) : 8;
+		int numPositions = (argc > 3) ? std::atoi(argv[3]) : 20;
+		EngineComparison::compareMtdfWithAspirationSearch(depth, numPositions);
+		return 0;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--calibrate-probcut")
+	{
+		int shallowDepth = (argc > 2) ? std::atoi(argv[2]) : 4;
+		int deepDepth = (argc > 3) ? std::atoi(argv[3]) : 8;
+		int numPositions = (argc > 4) ? std::atoi(argv[4]) : 200;
+		ProbCutCalibration::calibrate(shallowDepth, deepDepth, numPositions, "Logs\\ProbCutSamples.bin");
+		return 0;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--generate-tablebases")
+	{
+		int maxKnightsPerSide = (argc > 2) ? std::atoi(argv[2]) : 2;
+		int numThreads = (argc > 3) ? std::atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+		return TablebaseGenerator::generate(maxKnightsPerSide, numThreads, TABLEBASE_DIRECTORY) ? 0 : 1;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--build-opening-book")
+	{
+		int numPositions = (argc > 2) ? std::atoi(argv[2]) : 1000;
+		int searchDepth = (argc > 3) ? std::atoi(argv[3]) : 10;
+		int numThreads = (argc > 4) ? std::atoi(argv[4]) : (int)std::thread::hardware_concurrency();
+		return OpeningBookBuilder::build(numPositions, searchDepth, numThreads, OPENING_BOOK_FILE) ? 0 : 1;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--benchmark-playouts")
+	{
+		int numPlayouts = (argc > 2) ? std::atoi(argv[2]) : 100000;
+		BatchPlayout::benchmark(numPlayouts);
+		return 0;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--benchmark-evaluation")
+	{
+		int numPositions = (argc > 2) ? std::atoi(argv[2]) : 100000;
+		PieceSquarePlanes::benchmark(numPositions);
+		return 0;
+	}
+	else if (argc > 1 && std::string(argv[1]) == "--check-mcts")
+	{
+		return MonteCarloTreeSearch::checkRootStatistics() ? 0 : 1;
+	}
+
 	QApplication application(argc, argv);
 	SerPrunesALotWindow* window = new SerPrunesALotWindow();
 	window->show();